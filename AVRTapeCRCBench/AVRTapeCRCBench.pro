@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CFLAGS_RELEASE += -O3
+
+# All CRC engines are compiled for comparison.
+DEFINES += __AVR_ATmega328P__ CRC_ALL_ENGINES EN_CRC16
+INCLUDEPATH += ../AVRTapeHost ../AVRTapeControl
+
+SOURCES += \
+        main.c \
+        ../AVRTapeControl/calc_crc.c
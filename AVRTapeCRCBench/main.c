@@ -0,0 +1,199 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "calc_crc.h"
+
+#define BENCH_BUF_LEN   4096        // Data buffer length
+#define DEF_BENCH_MB    64          // Default amount of data per engine (MB)
+
+// Known check values for "123456789".
+#define CHECK_CRC8      0xF7        // CRC-8, poly 0x31, init 0xFF
+#define CHECK_CRC16     0x29B1      // CRC-16/CCITT-FALSE, poly 0x1021, init 0xFFFF
+
+typedef uint8_t (*crc8_fn)(uint8_t, uint8_t);
+
+typedef struct
+{
+    const char *name;
+    crc8_fn calc;
+    uint16_t table;                 // Table size (bytes)
+} crc8_engine_t;
+
+// NOTE: keep in [CRC8_ENG_xxx] order from [calc_crc.h].
+static const crc8_engine_t engines[CRC8_ENG_MAX] =
+{
+    {"LUT256", CRC8_calc_lut256, CRC8_LUT256_SIZE},
+    {"LUT16", CRC8_calc_lut16, CRC8_LUT16_SIZE},
+    {"BITWISE", CRC8_calc_bitwise, 0}
+};
+
+static uint8_t buf[BENCH_BUF_LEN];
+
+// Reference bit-by-bit CRC-16 (independent from firmware code).
+static uint16_t ref_crc16(uint16_t crc, uint8_t data)
+{
+    uint8_t bit;
+    crc^=(uint16_t)data<<8;
+    for(bit=0;bit<8;bit++)
+    {
+        crc=((crc&0x8000)!=0)?(uint16_t)((crc<<1)^CRC16_POLY):(uint16_t)(crc<<1);
+    }
+    return crc;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec*1e9+(double)ts.tv_nsec;
+}
+
+// Check every engine against 256-byte table for all CRC/data pairs and against check value.
+static uint32_t test_crc8(void)
+{
+    const uint8_t *check=(const uint8_t *)"123456789";
+    uint32_t errors=0, mism;
+    uint16_t crc, data;
+    uint8_t eng, idx, res;
+    for(eng=0;eng<CRC8_ENG_MAX;eng++)
+    {
+        mism=0;
+        for(crc=0;crc<256;crc++)
+        {
+            for(data=0;data<256;data++)
+            {
+                if(engines[eng].calc((uint8_t)crc, (uint8_t)data)!=CRC8_calc_lut256((uint8_t)crc, (uint8_t)data))
+                {
+                    mism++;
+                }
+            }
+        }
+        res=CRC8_init();
+        for(idx=0;idx<9;idx++)
+        {
+            res=engines[eng].calc(res, check[idx]);
+        }
+        printf("CRC-8 %-8s check 0x%02X %s, %lu mismatches\n", engines[eng].name, res,
+               (res==CHECK_CRC8)?"OK":"FAIL", (unsigned long)mism);
+        if((res!=CHECK_CRC8)||(mism!=0))
+        {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static uint32_t test_crc16(void)
+{
+    const uint8_t *check=(const uint8_t *)"123456789";
+    uint32_t crc, mism=0;
+    uint16_t data, res;
+    uint8_t idx;
+    for(crc=0;crc<65536;crc++)
+    {
+        for(data=0;data<256;data++)
+        {
+            if(CRC16_calc((uint16_t)crc, (uint8_t)data)!=ref_crc16((uint16_t)crc, (uint8_t)data))
+            {
+                mism++;
+            }
+        }
+    }
+    res=CRC16_init();
+    for(idx=0;idx<9;idx++)
+    {
+        res=CRC16_calc(res, check[idx]);
+    }
+    printf("CRC-16 LUT16   check 0x%04X %s, %lu mismatches\n", res, (res==CHECK_CRC16)?"OK":"FAIL", (unsigned long)mism);
+    return ((res!=CHECK_CRC16)||(mism!=0))?1:0;
+}
+
+// Run CRC-8 engine through [total] bytes, returns ns per byte.
+static double bench_crc8(volatile crc8_fn calc, uint32_t total, uint8_t *result)
+{
+    uint32_t pos;
+    uint16_t idx;
+    uint8_t crc;
+    double start;
+    crc=CRC8_init();
+    start=now_ns();
+    for(pos=0;pos<total;pos+=BENCH_BUF_LEN)
+    {
+        for(idx=0;idx<BENCH_BUF_LEN;idx++)
+        {
+            crc=calc(crc, buf[idx]);
+        }
+    }
+    (*result)=crc;
+    return (now_ns()-start)/total;
+}
+
+static double bench_crc16(uint32_t total, uint16_t *result)
+{
+    uint16_t (* volatile calc)(uint16_t, uint8_t) = CRC16_calc;
+    uint32_t pos;
+    uint16_t idx, crc;
+    double start;
+    crc=CRC16_init();
+    start=now_ns();
+    for(pos=0;pos<total;pos+=BENCH_BUF_LEN)
+    {
+        for(idx=0;idx<BENCH_BUF_LEN;idx++)
+        {
+            crc=calc(crc, buf[idx]);
+        }
+    }
+    (*result)=crc;
+    return (now_ns()-start)/total;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t errors, total, idx;
+    uint16_t crc16;
+    uint8_t eng, crc8;
+    total=DEF_BENCH_MB;
+    if(argc>1)
+    {
+        total=(uint32_t)strtoul(argv[1], NULL, 10);
+        if((total==0)||(total>4000))
+        {
+            printf("Usage: %s [MB of data per engine, 1...4000]\n", argv[0]);
+            return 1;
+        }
+    }
+    total*=1024UL*1024UL;
+    for(idx=0;idx<BENCH_BUF_LEN;idx++)
+    {
+        buf[idx]=(uint8_t)(idx*29+7+(idx>>8));
+    }
+    printf("CRC engines bench: %lu MB per engine, tables in %s\n\n", (unsigned long)(total>>20),
+#ifdef CRC8_ROM_DATA
+           "ROM"
+#else
+           "RAM"
+#endif
+           );
+    errors=test_crc8();
+    errors+=test_crc16();
+    printf("\nEngine    Table, B   Host ns/B   Result\n");
+    for(eng=0;eng<CRC8_ENG_MAX;eng++)
+    {
+        double ns=bench_crc8(engines[eng].calc, total, &crc8);
+        printf("%-8s  %8u  %10.2f   0x%02X\n", engines[eng].name, engines[eng].table, ns, crc8);
+    }
+    {
+        double ns=bench_crc16(total, &crc16);
+        printf("%-8s  %8u  %10.2f   0x%04X\n", "CRC16", CRC16_LUT_SIZE, ns, crc16);
+    }
+    printf("\nAVR cycles per byte: build firmware with CRC_BENCH and UART_TERM (\"CRC|ENG:...\" lines at start-up).\n");
+    if(errors!=0)
+    {
+        printf("\n%lu engine(s) FAILED!\n", (unsigned long)errors);
+        return 2;
+    }
+    printf("\nAll engines match.\n");
+    return 0;
+}
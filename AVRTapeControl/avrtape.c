@@ -10,23 +10,50 @@ uint8_t u8_500hz_cnt=0;						// Divider for 500 Hz
 uint8_t u8_50hz_cnt=0;						// Divider for 50 Hz
 uint8_t u8_10hz_cnt=0;						// Divider for 10 Hz
 uint8_t u8_2hz_cnt=0;						// Divider for 2 Hz
-uint8_t u8_stest_timer=0;					// Delay for self-test indication.
+uint16_t u16_sys_ticks=0;					// System tick counter (1 ms, wraps around)
+uint8_t u8_stest_timer=0;					// Delay for self-test indication (and calibration result).
 uint8_t u8_transition_timer=0;				// Solenoid holding timer
+uint8_t u8_mode_retries=0;					// Mode transition retries of the transport
 uint8_t u8_tacho_timer=0;					// Time from last tachometer signal
 uint8_t u8_sleep_inh_timer=0;				// Time before next sleep is allowed
+volatile uint8_t u8i_btn_latch=0xFF;		// Buttons port state latched at edges ("0" = pressed, non-buffered)
+uint8_t u8_kbd_latch=0xFF;					// Buttons port state latched at edges during debounce window
+uint8_t u8_kbd_deb_timer=0;					// Time left in buttons debounce window (ms)
+uint8_t u8_kbd_fast=0;						// Register next button edge without debounce (it has woken up the MCU)
+uint16_t u16_kbd_edge=0;					// Time of the first edge in debounce window (system ticks)
+uint8_t u8a_kbd_q_press[KBD_QUEUE_SIZE];	// Button events queue: pressed buttons
+uint8_t u8a_kbd_q_release[KBD_QUEUE_SIZE];	// Button events queue: released buttons
+uint16_t u16a_kbd_q_time[KBD_QUEUE_SIZE];	// Button events queue: time of the event
+uint8_t u8_kbd_q_head=0;					// Index of the oldest event in the queue
+uint8_t u8_kbd_q_count=0;					// Number of events in the queue
+#ifdef UART_TERM
+uint16_t u16_wake_tick=0;					// System tick at wake up
+uint16_t u16_wake_cmd=0;					// Latency from wake up to the first command (ms)
+uint8_t u8_wake_track=WAKE_TRK_OFF;			// Wake-to-action latency measurement state
+#endif /* UART_TERM */
+#ifdef EN_SLEEP_POLL
+uint8_t u8_sleep_sw=0;						// Switches state at the start of sleep
+uint8_t u8_sleep_deb=0;						// Number of polls with changed switches state
+uint16_t u16_sleep_polls=0;					// Number of watchdog wake ups during sleep
+#endif /* EN_SLEEP_POLL */
+#ifdef UART_TERM
+uint16_t u16_log_lost_old=0;				// Last reported number of lost log messages
+uint8_t u8_capst_old=0;						// Capstan state on previous check
+#endif /* UART_TERM */
+#ifdef UART_TELEMETRY
+uint8_t u8_tlm_div=0;						// Divider for telemetry frames
+#endif /* UART_TELEMETRY */
 uint8_t u8_dbg_timer=0;						// Debug timer
 uint8_t u8_user_mode=USR_MODE_STOP;			// User-requested mode
 uint8_t u8_mech_mode=USR_MODE_STOP;			// Current user-level transport mode
 uint8_t u8_last_play_dir=PB_DIR_FWD;		// Last playback direction
 uint8_t u8_transport_error=TTR_ERR_NONE;	// Last transport error
+uint8_t u8_save_pending=0;					// Settings record is waiting for EEPROM to be free
 
 uint8_t u8a_settings[SETTINGS_SIZE];		// Transport features
 uint8_t u8a_spi_buf[SPI_IDX_MAX];			// Data to send via SPI bus
-
-
-#ifdef UART_TERM
-char u8a_buf[64];							// Buffer for UART debug messages
-#endif /* UART_TERM */
+uint8_t u8_spi_sent=0;						// Last indicator data sent via SPI bus
+uint8_t u8_spi_refresh=0;					// Indicator updates since last SPI transmission
 
 // Firmware description strings.
 volatile const uint8_t ucaf_version[] PROGMEM = "v0.14";			// Firmware version
@@ -46,11 +73,11 @@ ISR(SYST_INT, ISR_NAKED)
 }
 
 //-------------------------------------- Pin Change Interrupt Request 1.
-ISR(BTN_INT, ISR_NAKED)
+ISR(BTN_INT)
 {
-	// Used only to wakeup MCU.
-	NOP;
-	INTR_OUT_S;
+	// Button edge (also wakes up MCU), latch pressed buttons (including short bounces) for validation.
+	u8i_btn_latch&=BTN_SRC_1;
+	u8i_interrupts|=INTR_BTN_EDGE;
 }
 
 //-------------------------------------- Pin Change Interrupt Request 2.
@@ -61,6 +88,16 @@ ISR(SW_INT, ISR_NAKED)
 	INTR_OUT_S;
 }
 
+#ifdef EN_SLEEP_POLL
+//-------------------------------------- Watchdog timeout (interrupt mode during sleep).
+ISR(WDT_INT, ISR_NAKED)
+{
+	INTR_IN;
+	u8i_interrupts|=INTR_WDT_POLL;
+	INTR_OUT;
+}
+#endif /* EN_SLEEP_POLL */
+
 //-------------------------------------- SPI data transmittion finished.
 ISR(SPI_INT, ISR_NAKED)
 {
@@ -69,6 +106,15 @@ ISR(SPI_INT, ISR_NAKED)
 	INTR_OUT;
 }
 
+#ifdef USE_EEPROM
+//-------------------------------------- EEPROM ready for next erase/write.
+ISR(EEP_RDY_INT)
+{
+	// Perform next step of queued EEPROM job.
+	EEPROM_job_step();
+}
+#endif /* USE_EEPROM */
+
 #ifdef UART_TERM
 //-------------------------------------- USART, Tx Complete.
 ISR(UART_TX_INT, ISR_NAKED)
@@ -82,14 +128,36 @@ ISR(UART_TX_INT, ISR_NAKED)
 //-------------------------------------- Re-configure system for fast CPU.
 inline void core_prepare_on()
 {
-	// Disable interrupts from inputs
-	BTN_DIS_INTR2; SW_DIS_INTR2;
+	// Disable interrupts from switches (buttons interrupts are always enabled).
+	SW_DIS_INTR2;
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_sleep_out);
+	if(UART_LOG_ON(LOG_SUB_POWER, LOG_LVL_INFO))
+	{
+		UART_begin_line();
+		UART_add_flash_string((uint8_t *)cch_sleep_out);
+#ifdef EN_SLEEP_POLL
+		UART_add_flash_string((uint8_t *)cch_sleep_state); UART_add_flash_string((uint8_t *)cch_sleep_polls);
+		UART_add_dec16(u16_sleep_polls, 1); UART_add_flash_string((uint8_t *)cch_endl);
+#endif /* EN_SLEEP_POLL */
+		UART_end_line();
+	}
 	UART_dump_out();
 #endif /* UART_TERM */
 	// Reset sleep inhibition timer.
 	u8_sleep_inh_timer = 0;
+	if((u8i_interrupts&INTR_BTN_EDGE)!=0)
+	{
+		// Woken up by a button.
+		u8_kbd_fast = 1;
+#ifdef UART_TERM
+		// Start measuring latency from wake up to transport action.
+		u8_wake_track = WAKE_TRK_CMD;
+#endif /* UART_TERM */
+	}
+#ifdef UART_TERM
+	// System ticks were stopped during sleep, current value is the wake up time.
+	u16_wake_tick = u16_sys_ticks;
+#endif /* UART_TERM */
 	// Start system timing.
 	SYST_RESET; SYST_START;
 }
@@ -97,10 +165,16 @@ inline void core_prepare_on()
 //-------------------------------------- Re-configure system for slow CPU.
 inline void core_prepare_off()
 {
+#ifdef EN_CLK_SCALE
+	// Return to full clock for UART output and wake up.
+	PDM_set_clock(0);
+#endif /* EN_CLK_SCALE */
 	// Stop system timing.
 	SYST_STOP;
-	// Clear counters.
-	u8i_interrupts=0;
+	// Clear counters (keep button edge that could arrive after the last buffering).
+	cli();
+	u8i_interrupts&=INTR_BTN_EDGE;
+	sei();
 	u8_buf_interrupts=0;
 	u8_tasks=0;
 	u8_500hz_cnt=0;
@@ -108,14 +182,88 @@ inline void core_prepare_off()
 	u8_10hz_cnt=0;
 	u8_2hz_cnt=0;
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_sleep_in);
+	if(UART_LOG_ON(LOG_SUB_POWER, LOG_LVL_INFO))
+	{
+		UART_add_flash_string((uint8_t *)cch_sleep_in);
+	}
+	// Report log drops accumulated during active period.
+	UART_dump_log_stats();
 	UART_dump_out();
 #endif /* UART_TERM */
-	// Clear interrupt flags (write "1" to wherever "1" is).
-	PCIFR = PCIFR;
-	// Enable interrupts from inputs (acting as wakeup sources).
-	BTN_EN_INTR2; SW_EN_INTR2;
+#ifndef EN_SLEEP_POLL
+	// Clear switches interrupt flag.
+	SW_CLR_INTR;
+	// Enable interrupts from switches (acting as wakeup sources along with buttons).
+	SW_EN_INTR2;
+#endif /* EN_SLEEP_POLL */
+}
+
+#ifdef EN_CLK_SCALE
+//-------------------------------------- Check if core clock can be slowed down.
+// Full speed is kept for mode transitions and while there is something to send via UART.
+static inline uint8_t core_can_slow_down()
+{
+	if((u8_transition_timer!=0)||(u8_mech_mode!=u8_user_mode)||(SOLENOID_STATE!=0))
+	{
+		// Transport is switching modes.
+		return 0;
+	}
+	if(CAL_is_running()!=0)
+	{
+		// Calibration samples sensors each system tick.
+		return 0;
+	}
+#ifdef UART_TERM
+	if((UART_get_sending_number()!=0)||((PDM_get_state()&PDM_UART)!=0))
+	{
+		// USART is in use, baudrate depends on core clock.
+		return 0;
+	}
+#endif /* UART_TERM */
+	return 1;
+}
+#endif /* EN_CLK_SCALE */
+
+#ifdef EN_SLEEP_POLL
+//-------------------------------------- Short task for watchdog wake up during sleep (~10 us).
+// Returns 1 if MCU should wake up completely.
+static inline uint8_t sleep_poll()
+{
+	if((u8i_interrupts&INTR_WDT_POLL)==0)
+	{
+		// Woken up by a button.
+		return 1;
+	}
+	if((u8i_interrupts&INTR_BTN_EDGE)!=0)
+	{
+		// Button was pressed at the same time as the watchdog fired.
+		u8i_interrupts&=~INTR_WDT_POLL;
+		return 1;
+	}
+	u8i_interrupts&=~INTR_WDT_POLL;
+	if(u16_sleep_polls<0xFFFF)
+	{
+		u16_sleep_polls++;
+	}
+	if(BTN_ALL_STATE!=(BTN_1|BTN_2|BTN_3|BTN_4|BTN_5|BTN_6))
+	{
+		// Button is held down.
+		return 1;
+	}
+	// Debounce switches: new state should hold for several polls.
+	if(SW_POLL_STATE==u8_sleep_sw)
+	{
+		u8_sleep_deb = 0;
+		return 0;
+	}
+	u8_sleep_deb++;
+	if(u8_sleep_deb<SLEEP_POLL_DEB)
+	{
+		return 0;
+	}
+	return 1;
 }
+#endif /* EN_SLEEP_POLL */
 
 //-------------------------------------- MCU sleep procedure.
 static inline void CPU_power_down()
@@ -127,16 +275,46 @@ static inline void CPU_power_down()
 	// Turn off WDT for no reset during IDLE.
 	WDT_RESET_DIS;
 	WDT_PREP_OFF;
+#ifdef EN_SLEEP_POLL
+	// Switch WDT to periodic interrupt.
+	WDT_SW_POLL;
+	WDT_FLUSH_REASON;
+	u8_sleep_sw = SW_POLL_STATE;
+	u8_sleep_deb = 0;
+	u16_sleep_polls = 0;
+	// Enter IDLE mode.
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	do
+	{
+		// Do not sleep if a button was pressed after wake up sources were enabled.
+		if((u8i_interrupts&INTR_BTN_EDGE)==0)
+		{
+			sleep_enable();
+			sei();
+			// MCU goes to sleep here.
+			sleep_cpu();
+			// MCU wakes up and continues here.
+			sleep_disable();
+			cli();
+		}
+	}
+	while(sleep_poll()==0);
+#else
 	WDT_SW_OFF;
 	WDT_FLUSH_REASON;
 	// Enter IDLE mode.
 	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
-	sleep_enable();
-	sei();
-	// MCU goes to sleep here.
-	sleep_cpu();
-	// MCU wakes up and continues here.
-	sleep_disable();
+	// Do not sleep if a button was pressed after wake up sources were enabled.
+	if((u8i_interrupts&INTR_BTN_EDGE)==0)
+	{
+		sleep_enable();
+		sei();
+		// MCU goes to sleep here.
+		sleep_cpu();
+		// MCU wakes up and continues here.
+		sleep_disable();
+	}
+#endif /* EN_SLEEP_POLL */
 	// Re-configure WDT.
 	cli();
 	wdt_reset();
@@ -175,59 +353,211 @@ inline void system_startup(void)
 inline void read_settings(void)
 {
 	uint8_t eep_res;
+	uint8_t u8a_record[SET_RECORD_SIZE];
 #ifdef UART_TERM
-	UART_add_flash_string(cch_eeprom_settings); UART_dump_out();
+	if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+	{
+		UART_add_flash_string(cch_eeprom_settings); UART_dump_out();
+	}
 #endif /* UART_TERM */
-	eep_res	= EEPROM_search_data(u8a_settings, 0, SETTINGS_SIZE);
+	eep_res	= EEPROM_search_data(u8a_record, 0, (SET_RECORD_SIZE-1));
 	if(eep_res==EEPROM_NO_DATA)
 	{
-		// No settings found in EEPROM (empty EEPROM or corrupted data).
+		// No settings found in current format, check for settings saved by older firmware.
+		if(EEPROM_search_legacy(u8a_record, SET_OLD_SEGMENT, SET_OLD_LEN)==EEPROM_OK)
+		{
+			// Take transport type and features from old record, the rest keeps defaults.
+			SET_decode(u8a_record, u8a_settings);
+#ifdef UART_TERM
+			if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+			{
+				UART_add_flash_string(cch_set_legacy); UART_dump_out();
+			}
+#endif /* UART_TERM */
+		}
+		else
+		{
+			// No settings found in EEPROM (empty EEPROM or corrupted data).
 #ifdef UART_TERM
-		UART_add_flash_string(cch_eeprom_err); UART_dump_out();
+			if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_WARN))
+			{
+				UART_add_flash_string(cch_eeprom_err); UART_dump_out();
+			}
 #endif /* UART_TERM */
-		// Rewrite default settings into EEPROM.
-		EEPROM_write_segment(u8a_settings, 0, SETTINGS_SIZE);
+		}
+		// Rewrite converted or default settings into EEPROM
+		// (converted record is put after the old one, so old settings survive power loss during write,
+		// marker is written last, so interrupted write can not leave a record that passes CRC check by chance).
+		SET_encode(u8a_settings, u8a_record);
+		EEPROM_write_segment(&u8a_record[SET_IDX_MARKER+1], (SET_IDX_MARKER+1), (SET_RECORD_SIZE-1));
+		EEPROM_write_segment(&u8a_record[SET_IDX_MARKER], SET_IDX_MARKER, 1);
 		// Re-read settings (ensure that all variables in EEPROM driver are set correctly).
-		eep_res	= EEPROM_search_data(u8a_settings, 0, SETTINGS_SIZE);
+		eep_res	= EEPROM_search_data(u8a_record, 0, (SET_RECORD_SIZE-1));
 		if(eep_res==EEPROM_NO_DATA)
 		{
 			// Nearly impossible situation.
 			// Hardware fault: maybe EEPROM cycles are gone, it can not store any data.
 #ifdef UART_TERM
-			UART_add_flash_string(cch_endl); UART_add_flash_string(cch_eeprom_fail); UART_add_flash_string(cch_endl); UART_dump_out();
+			if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_ERROR))
+			{
+				UART_add_flash_string(cch_endl); UART_add_flash_string(cch_eeprom_fail); UART_add_flash_string(cch_endl); UART_dump_out();
+			}
 #endif /* UART_TERM */
 			// Try to switch to next (probably working) segment of EEEPROM.
 			EEPROM_goto_next_segment();
 			// Rewrite new settings into EEPROM.
-			EEPROM_write_segment(u8a_settings, 0, SETTINGS_SIZE);
+			EEPROM_write_segment(u8a_record, 0, SET_RECORD_SIZE);
 			// Hang waiting for watchdog reset.
 			while(1) {};
 		}
 	}
+	// Unpack settings blocks into RAM image.
+	eep_res = SET_decode(u8a_record, u8a_settings);
 #ifdef UART_TERM
-	UART_add_flash_string(cch_eeprom_load); UART_add_flash_string(cch_endl); UART_dump_out();
+	if((eep_res==SET_ERR_FORMAT)&&(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_WARN)))
+	{
+		UART_add_flash_string(cch_set_broken);
+	}
+	else if((eep_res==SET_LEGACY)&&(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO)))
+	{
+		UART_add_flash_string(cch_set_legacy);
+	}
+	if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+	{
+		UART_add_flash_string(cch_eeprom_load); UART_add_flash_string(cch_endl); UART_dump_out();
+	}
 #endif /* UART_TERM */
 }
 
 //-------------------------------------- Save configuration data to EEPROM.
+// Write is performed in background by EEPROM ready interrupt, result is reported by [check_settings_save()].
+// If EEPROM is busy with another job, save is retried by [check_settings_save()].
 inline void save_settings(void)
 {
+	uint8_t u8a_record[SET_RECORD_SIZE];
+	// Queue new settings record to be appended into the next segment of EEPROM
+	// (previous record stays intact for power loss protection and wear leveling).
+	SET_encode(u8a_settings, u8a_record);
+	if(EEPROM_queue_append(u8a_record, 0, SET_RECORD_SIZE)!=EEPROM_OK)
+	{
+		// EEPROM is busy, try again later.
+		u8_save_pending = 1;
+		return;
+	}
+	u8_save_pending = 0;
+#ifdef UART_TERM
+	if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+	{
+		UART_add_flash_string(cch_eeprom_settings);
+	}
+#endif /* UART_TERM */
+}
+
+//-------------------------------------- Check if background save of configuration data is finished.
+// Retries delayed save when EEPROM becomes free.
+inline void check_settings_save(void)
+{
+	uint8_t eep_res;
+	eep_res = EEPROM_get_job_result();
+	if((u8_save_pending!=0)&&(EEPROM_is_busy()==0))
+	{
+		save_settings();
+	}
+	if((eep_res&EEPROM_JOB_DONE)!=0)
+	{
 #ifdef UART_TERM
-	UART_add_flash_string(cch_eeprom_settings); UART_dump_out();
+		if((eep_res&EEPROM_JOB_FAIL)!=0)
+		{
+			if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_ERROR))
+			{
+				UART_add_flash_string(cch_eeprom_fail);
+				UART_add_flash_string(cch_endl);
+			}
+		}
+		else if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+		{
+			UART_add_flash_string(cch_eeprom_save);
+			UART_add_flash_string(cch_endl);
+		}
 #endif /* UART_TERM */
-	// Rewrite new settings into EEPROM.
-	EEPROM_write_segment(u8a_settings, 0, SETTINGS_SIZE);
-	// EEPROM wear leveling: jump to the next segment in EEPROM.
-	EEPROM_goto_next_segment();
+	}
+}
+
+//-------------------------------------- Load mechanism timing profile from settings.
+// Profile replaces defaults in RAM table of selected transport,
+// defaults are kept if profile is made for another transport or fails sanity check.
+inline void load_timing_profile(void)
+{
+	uint8_t u8_res, u8_idx, u8_size;
+	const uint8_t *p_profile;
+	u8_res = 1;
+	u8_size = 0;
+	p_profile = NULL;
+#ifdef SUPP_TANASHIN_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
+	{
+		if(u8a_settings[EPS_TIM_TYPE]==TTR_TYPE_TANASHIN)
+		{
+			u8_res = mech_tanashin_set_profile(&u8a_settings[EPS_TIM_DATA]);
+		}
+		p_profile = mech_tanashin_get_profile();
+		u8_size = PRF_TANA_MAX;
+	}
+#endif /* SUPP_TANASHIN_MECH */
+#ifdef SUPP_CRP42602Y_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
+	{
+		if(u8a_settings[EPS_TIM_TYPE]==TTR_TYPE_CRP42602Y)
+		{
+			u8_res = mech_crp42602y_set_profile(&u8a_settings[EPS_TIM_DATA]);
+		}
+		p_profile = mech_crp42602y_get_profile();
+		u8_size = PRF_42602_MAX;
+	}
+#endif /* SUPP_CRP42602Y_MECH */
+#ifdef SUPP_KENWOOD_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_KENWOOD)
+	{
+		if(u8a_settings[EPS_TIM_TYPE]==TTR_TYPE_KENWOOD)
+		{
+			u8_res = mech_knwd_set_profile(&u8a_settings[EPS_TIM_DATA]);
+		}
+		p_profile = mech_knwd_get_profile();
+		u8_size = PRF_KNWD_MAX;
+	}
+#endif /* SUPP_KENWOOD_MECH */
 #ifdef UART_TERM
-	UART_add_flash_string(cch_eeprom_save);
-	UART_add_flash_string(cch_endl);
+	if(UART_LOG_ON(LOG_SUB_EEPROM, LOG_LVL_INFO))
+	{
+		UART_begin_line();
+		UART_add_flash_string(cch_tim_profile);
+		if(u8_res==0)
+		{
+			UART_add_flash_string(cch_eeprom_load);
+		}
+		else
+		{
+			if(u8a_settings[EPS_TIM_TYPE]==u8a_settings[EPS_TTR_TYPE])
+			{
+				UART_add_flash_string(cch_tim_rejected);
+			}
+			UART_add_flash_string(cch_eeprom_err);
+		}
+		// Print active profile ("|%u" for each value in [PRF_xxx] order).
+		for(u8_idx=0;u8_idx<u8_size;u8_idx++)
+		{
+			UART_add_char('|'); UART_add_dec8(p_profile[u8_idx], 1);
+		}
+		UART_add_flash_string(cch_endl);
+		UART_end_line();
+	}
 #endif /* UART_TERM */
 }
 
 //-------------------------------------- Slow events dividers.
 inline void slow_timing(void)
 {
+	u16_sys_ticks++;
 	u8_500hz_cnt++;
 	if(u8_500hz_cnt>=2)		// 1000/2 = 500
 	{
@@ -264,6 +594,27 @@ inline void slow_timing(void)
 volatile uint8_t sw_state = 0;
 volatile uint8_t sw_pressed = 0;
 volatile uint8_t sw_released = 0;
+//-------------------------------------- Scan STOP sensor of the transport.
+inline void scan_stop_sensor(void)
+{
+	if(SW_STOP_STATE!=0)
+	{
+		if((sw_state&TTR_SW_STOP)==0)
+		{
+			sw_pressed|=TTR_SW_STOP;
+		}
+		sw_state|=TTR_SW_STOP;
+	}
+	else
+	{
+		if((sw_state&TTR_SW_STOP)!=0)
+		{
+			sw_released|=TTR_SW_STOP;
+		}
+		sw_state&=~TTR_SW_STOP;
+	}
+}
+
 //-------------------------------------- Scan sensors of the transport.
 inline void switches_scan(void)
 {
@@ -291,22 +642,7 @@ inline void switches_scan(void)
 		sw_state&=~TTR_SW_TAPE_IN;
 	}
 	// Check STOP sensor.
-	if(SW_STOP_STATE!=0)
-	{
-		if((sw_state&TTR_SW_STOP)==0)
-		{
-			sw_pressed|=TTR_SW_STOP;
-		}
-		sw_state|=TTR_SW_STOP;
-	}
-	else
-	{
-		if((sw_state&TTR_SW_STOP)!=0)
-		{
-			sw_released|=TTR_SW_STOP;
-		}
-		sw_state&=~TTR_SW_STOP;
-	}
+	scan_stop_sensor();
 	// Check REC_INHIBIT sensor for forward direction.
 	if(SW_NOREC_FWD_STATE!=0)
 	{
@@ -347,171 +683,157 @@ inline void switches_scan(void)
 		// Reset sleep inhibition timer.
 		u8_sleep_inh_timer = 0;
 #ifdef UART_TERM
-		sprintf(u8a_buf, "SWS|TAPE:%01d|F_REC:%01d|R_REC:%01d\n\r",
-				((sw_state&TTR_SW_TAPE_IN)==0)?0:1,
-				((sw_state&TTR_SW_NOREC_FWD)==0)?0:1,
-				((sw_state&TTR_SW_NOREC_REV)==0)?0:1);
-		UART_add_string(u8a_buf);
+		if(UART_LOG_ON(LOG_SUB_SWS, LOG_LVL_INFO))
+		{
+			UART_begin_line();
+			UART_add_flash_string((uint8_t *)cch_sws_tape); UART_add_char(((sw_state&TTR_SW_TAPE_IN)==0)?'0':'1');
+			UART_add_flash_string((uint8_t *)cch_sws_f_rec); UART_add_char(((sw_state&TTR_SW_NOREC_FWD)==0)?'0':'1');
+			UART_add_flash_string((uint8_t *)cch_sws_r_rec); UART_add_char(((sw_state&TTR_SW_NOREC_REV)==0)?'0':'1');
+			UART_add_flash_string((uint8_t *)cch_endl);
+			UART_end_line();
+		}
 #endif /* UART_TERM */
 	}
 }
 
-volatile uint8_t kbd_state = 0;		// Buttons states from the last [keys_simple_scan()] poll.
+volatile uint8_t kbd_state = 0;		// Buttons states from the last validated edge.
 volatile uint8_t kbd_pressed = 0;	// Flags for buttons that have been pressed (should be cleared after processing).
 volatile uint8_t kbd_released = 0;	// Flags for buttons that have been released (should be cleared after processing).
-//-------------------------------------- Keyboard scan routine.
-inline void keys_simple_scan(void)
+uint16_t u16_kbd_time = 0;			// Time of the first edge of the current button event (system ticks).
+//-------------------------------------- Convert buttons port state into [USR_BTN_xxx] flags.
+// [in_port] - buttons port state ("0" = pressed);
+static inline uint8_t keys_from_port(uint8_t in_port)
 {
-	// Button "STOP".
-	// Check button input.
-	if(BTN_STOP_STATE==0)
-	{
-		// Button is pressed.
-		// Compare with previous state.
-		if((kbd_state&USR_BTN_STOP)==0)
-		{
-			// Button was released before, now it is pressed.
-			kbd_pressed|=USR_BTN_STOP;
-		}
-		kbd_state|=USR_BTN_STOP;
-	}
-	else
+	uint8_t u8_keys;
+	u8_keys = 0;
+	if((in_port&BTN_STOP)==0) u8_keys |= USR_BTN_STOP;
+	if((in_port&BTN_PLAY)==0) u8_keys |= USR_BTN_PLAY;
+	if((in_port&BTN_PLAY_REV)==0) u8_keys |= USR_BTN_PLAY_REV;
+	if((in_port&BTN_FFWD)==0) u8_keys |= USR_BTN_FFORWARD;
+	if((in_port&BTN_REWD)==0) u8_keys |= USR_BTN_REWIND;
+	if((in_port&BTN_REC)==0) u8_keys |= USR_BTN_RECORD;
+	return u8_keys;
+}
+
+//-------------------------------------- Put button event into the queue.
+static inline void keys_enqueue(uint8_t in_pressed, uint8_t in_released)
+{
+	uint8_t u8_idx;
+	if(u8_kbd_q_count>=KBD_QUEUE_SIZE)
+	{
+		// Queue is full, drop the event.
+		return;
+	}
+	u8_idx = u8_kbd_q_head+u8_kbd_q_count;
+	if(u8_idx>=KBD_QUEUE_SIZE) u8_idx -= KBD_QUEUE_SIZE;
+	u8a_kbd_q_press[u8_idx] = in_pressed;
+	u8a_kbd_q_release[u8_idx] = in_released;
+	u16a_kbd_q_time[u8_idx] = u16_kbd_edge;
+	u8_kbd_q_count++;
+}
+
+//-------------------------------------- Validate buttons state and queue events.
+// Presses latched at edges are registered even if the button is already released (short press).
+// [in_settled] - contacts have settled, releases can be registered;
+static inline void keys_validate(uint8_t in_settled)
+{
+	uint8_t u8_press, u8_release;
+	u8_press = keys_from_port(u8_kbd_latch&BTN_SRC_1)&~kbd_state;
+	u8_kbd_latch = 0xFF;
+	kbd_state |= u8_press;
+	u8_release = 0;
+	if(in_settled!=0)
 	{
-		// Button is released.
-		// Compare with previous state.
-		if((kbd_state&USR_BTN_STOP)!=0)
-		{
-			// Button was pressed before, now it is released.
-			kbd_released|=USR_BTN_STOP;
-		}
-		kbd_state&=~USR_BTN_STOP;
+		u8_release = kbd_state&~keys_from_port(BTN_SRC_1);
+		kbd_state &= ~u8_release;
 	}
-	// Button "PLAY".
-	if(BTN_PLAY_STATE==0)
+	if(u8_press!=0)
 	{
-		if((kbd_state&USR_BTN_PLAY)==0)
-		{
-			kbd_pressed|=USR_BTN_PLAY;
-		}
-		kbd_state|=USR_BTN_PLAY;
+		keys_enqueue(u8_press, 0);
 	}
-	else
+	if(u8_release!=0)
 	{
-		if((kbd_state&USR_BTN_PLAY)!=0)
-		{
-			kbd_released|=USR_BTN_PLAY;
-		}
-		kbd_state&=~USR_BTN_PLAY;
+		keys_enqueue(0, u8_release);
 	}
-	// Button "PLAY IN REVERSE".
-	if(BTN_PLAY_REV_STATE==0)
+}
+
+//-------------------------------------- Process button edge (deferred from pin change interrupt).
+static inline void keys_edge(void)
+{
+	if(u8_kbd_deb_timer==0)
 	{
-		if((kbd_state&USR_BTN_PLAY_REV)==0)
-		{
-			kbd_pressed|=USR_BTN_PLAY_REV;
-		}
-		kbd_state|=USR_BTN_PLAY_REV;
+		// First edge in debounce window, event time.
+		u16_kbd_edge = u16_sys_ticks;
 	}
-	else
+	if(u8_kbd_fast!=0)
 	{
-		if((kbd_state&USR_BTN_PLAY_REV)!=0)
-		{
-			kbd_released|=USR_BTN_PLAY_REV;
-		}
-		kbd_state&=~USR_BTN_PLAY_REV;
+		// The edge has woken up the MCU, it is not a noise: register presses right away.
+		u8_kbd_fast = 0;
+		keys_validate(0);
 	}
-	// Button "FAST WIND FORWARD".
-	if(BTN_FFWD_STATE==0)
+	// Wait for contacts to settle after the last edge.
+	u8_kbd_deb_timer = KBD_DEB_TIME;
+}
+
+//-------------------------------------- Count down debounce window (must be called at 1000 Hz).
+static inline void keys_debounce(void)
+{
+	if(u8_kbd_deb_timer!=0)
 	{
-		if((kbd_state&USR_BTN_FFORWARD)==0)
+		u8_kbd_deb_timer--;
+		if(u8_kbd_deb_timer==0)
 		{
-			kbd_pressed|=USR_BTN_FFORWARD;
+			keys_validate(1);
 		}
-		kbd_state|=USR_BTN_FFORWARD;
 	}
-	else
+}
+
+#ifdef UART_TERM
+//-------------------------------------- Measure latency from wake up by a button to transport reaching requested mode.
+// Must be called after transport state machine.
+// Output format: "WAKE|CMD:%u|MODE:%u ms\n\r".
+static inline void wake_latency_check()
+{
+	uint16_t u16_time;
+	if(u8_wake_track==WAKE_TRK_OFF)
 	{
-		if((kbd_state&USR_BTN_FFORWARD)!=0)
-		{
-			kbd_released|=USR_BTN_FFORWARD;
-		}
-		kbd_state&=~USR_BTN_FFORWARD;
+		return;
 	}
-	// Button "FAST WIND IN REVERSE".
-	if(BTN_REWD_STATE==0)
+	u16_time = u16_sys_ticks-u16_wake_tick;
+	if((u16_time>WAKE_TRK_TIMEOUT)||(u8_transport_error!=TTR_ERR_NONE))
 	{
-		if((kbd_state&USR_BTN_REWIND)==0)
-		{
-			kbd_pressed|=USR_BTN_REWIND;
-		}
-		kbd_state|=USR_BTN_REWIND;
+		// Transport did not reach the mode, nothing to measure.
+		u8_wake_track = WAKE_TRK_OFF;
 	}
-	else
+	else if(u8_wake_track==WAKE_TRK_CMD)
 	{
-		if((kbd_state&USR_BTN_REWIND)!=0)
+		if(u8_user_mode!=USR_MODE_STOP)
 		{
-			kbd_released|=USR_BTN_REWIND;
+			// Command accepted.
+			u16_wake_cmd = u16_time;
+			u8_wake_track = WAKE_TRK_MODE;
 		}
-		kbd_state&=~USR_BTN_REWIND;
 	}
-	// Button "RECORD".
-	if(BTN_REC_STATE==0)
+	else if(u8_user_mode==USR_MODE_STOP)
 	{
-		if((kbd_state&USR_BTN_RECORD)==0)
-		{
-			kbd_pressed|=USR_BTN_RECORD;
-		}
-		kbd_state|=USR_BTN_RECORD;
+		// Command was cancelled.
+		u8_wake_track = WAKE_TRK_OFF;
 	}
-	else
+	else if((u8_mech_mode==u8_user_mode)&&(u8_transition_timer==0))
 	{
-		if((kbd_state&USR_BTN_RECORD)!=0)
+		// Transport has reached requested mode.
+		u8_wake_track = WAKE_TRK_OFF;
+		if(UART_LOG_ON(LOG_SUB_POWER, LOG_LVL_INFO))
 		{
-			kbd_released|=USR_BTN_RECORD;
+			UART_begin_line();
+			UART_add_flash_string((uint8_t *)cch_wake_cmd); UART_add_dec16(u16_wake_cmd, 1);
+			UART_add_flash_string((uint8_t *)cch_wake_mode); UART_add_dec16(u16_time, 1);
+			UART_add_flash_string((uint8_t *)cch_wake_unit);
+			UART_end_line();
 		}
-		kbd_state&=~USR_BTN_RECORD;
-	}
-	
-#ifdef UART_TERM
-	/*if(kbd_state!=0)
-	{
-		sprintf(u8a_buf, "KBD|REWN:%01d|STOP:%01d|FFWD:%01d|PB_F:%01d|PB_R:%01d|REC:%01d\n\r",
-		((kbd_state&USR_BTN_REWIND)==0)?0:1,
-		((kbd_state&USR_BTN_STOP)==0)?0:1,
-		((kbd_state&USR_BTN_FFORWARD)==0)?0:1,
-		((kbd_state&USR_BTN_PLAY)==0)?0:1,
-		((kbd_state&USR_BTN_PLAY_REV)==0)?0:1,
-		((kbd_state&USR_BTN_RECORD)==0)?0:1);
-		UART_add_string(u8a_buf);
-	}*/
-	if(kbd_released!=0)
-	{
-		sprintf(u8a_buf, "KBD-UP|REWN:%01d|STOP:%01d|FFWD:%01d|PB_F:%01d|PB_R:%01d|REC:%01d\n\r",
-		((kbd_released&USR_BTN_REWIND)==0)?0:1,
-		((kbd_released&USR_BTN_STOP)==0)?0:1,
-		((kbd_released&USR_BTN_FFORWARD)==0)?0:1,
-		((kbd_released&USR_BTN_PLAY)==0)?0:1,
-		((kbd_released&USR_BTN_PLAY_REV)==0)?0:1,
-		((kbd_released&USR_BTN_RECORD)==0)?0:1);
-		UART_add_string(u8a_buf);
-	}
-#endif /* UART_TERM */
-	if(kbd_pressed!=0)
-	{
-		// Reset sleep inhibition timer.
-		u8_sleep_inh_timer = 0;
-#ifdef UART_TERM
-		sprintf(u8a_buf, "KBD-DN|REWN:%01d|STOP:%01d|FFWD:%01d|PB_F:%01d|PB_R:%01d|REC:%01d\n\r",
-				((kbd_pressed&USR_BTN_REWIND)==0)?0:1,
-				((kbd_pressed&USR_BTN_STOP)==0)?0:1,
-				((kbd_pressed&USR_BTN_FFORWARD)==0)?0:1,
-				((kbd_pressed&USR_BTN_PLAY)==0)?0:1,
-				((kbd_pressed&USR_BTN_PLAY_REV)==0)?0:1,
-				((kbd_pressed&USR_BTN_RECORD)==0)?0:1);
-		UART_add_string(u8a_buf);
-#endif /* UART_TERM */
 	}
 }
+#endif /* UART_TERM */
 
 //-------------------------------------- Start-up test for number of connected playback buttons.
 void scan_pb_buttons(void)
@@ -562,35 +884,164 @@ void scan_pb_buttons(void)
 			// Check if REVERSE PLAY input has switched to "0".
 			if(BTN_PLAY_REV_STATE!=0)
 			{
-				// REVERSE PLAY stayed at "1".
-				// REVERSE PLAY as input doesn't follow state of PLAY pin set as output,
-				// implying that those pins are separate, requesting double play button operation.
-				u8a_settings[EPS_SRV_FTRS] |= SRV_FEA_TWO_PLAYS;
+				// REVERSE PLAY stayed at "1".
+				// REVERSE PLAY as input doesn't follow state of PLAY pin set as output,
+				// implying that those pins are separate, requesting double play button operation.
+				u8a_settings[EPS_SRV_FTRS] |= SRV_FEA_TWO_PLAYS;
+			}
+		}
+	}
+	// Set both pins to perform as pulled-up inputs.
+	BTN_DIR_1 &= ~(BTN_PLAY|BTN_PLAY_REV);
+	BTN_PORT_1 |= (BTN_PLAY|BTN_PLAY_REV);
+	// Let pins stabilize.
+	_delay_us(20);
+}
+
+//-------------------------------------- Start-up check for held down STOP button.
+void scan_selftest_buttons(void)
+{
+	// Test button several times.
+	for(uint8_t idx=0;idx<50;idx++)
+	{
+		_delay_us(10);
+		if(BTN_STOP_STATE!=0)
+		{
+			// STOP button is not pressed.
+			// Cancel self-test.
+			u8_tasks &= ~TASK_SCAN_STEST;
+			return;
+		}
+	}
+}
+
+//-------------------------------------- Start-up check for held down STOP and REWIND buttons.
+// Returns 1 if timing calibration is requested.
+uint8_t scan_calib_buttons(void)
+{
+	// Test buttons several times.
+	for(uint8_t idx=0;idx<50;idx++)
+	{
+		_delay_us(10);
+		if((BTN_STOP_STATE!=0)||(BTN_REWD_STATE!=0))
+		{
+			// Not both buttons are pressed.
+			return 0;
+		}
+	}
+	return 1;
+}
+
+//-------------------------------------- Start timing auto-calibration of the transport.
+// Calibration plan is taken from the selected transport, transport without a plan fails right away.
+void calib_start(void)
+{
+	uint16_t u16a_plan[CAL_STEP_MAX*CAL_PLAN_SIZE];
+	uint8_t u8_steps;
+	u8_steps = 0;
+#ifdef SUPP_TANASHIN_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
+	{
+		u8_steps = mech_tanashin_calib_plan(u16a_plan);
+	}
+#endif /* SUPP_TANASHIN_MECH */
+#ifdef SUPP_CRP42602Y_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
+	{
+		u8_steps = mech_crp42602y_calib_plan(u16a_plan);
+	}
+#endif /* SUPP_CRP42602Y_MECH */
+#ifdef UART_TERM
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+	{
+		UART_add_flash_string((uint8_t *)cch_cal_start); UART_dump_out();
+	}
+#endif /* UART_TERM */
+	CAL_start(u16a_plan, u8_steps);
+	if(CAL_is_running()==0)
+	{
+		calib_finish();
+	}
+}
+
+//-------------------------------------- Apply results of timing calibration.
+// Profile derived by the transport is applied and saved into settings,
+// it is rejected if it does not pass sanity check of the transport.
+void calib_finish(void)
+{
+	uint8_t u8_res, u8_idx, u8_size;
+	uint8_t u8a_profile[TIM_PROFILE_SIZE];
+	u8_res = 1;
+	u8_size = 0;
+	if(CAL_get_state()==CAL_ST_DONE)
+	{
+#ifdef SUPP_TANASHIN_MECH
+		if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
+		{
+			if(mech_tanashin_calib_profile(CAL_get_leave(), CAL_get_home(), u8a_profile)==0)
+			{
+				u8_res = mech_tanashin_set_profile(u8a_profile);
+			}
+			u8_size = PRF_TANA_MAX;
+		}
+#endif /* SUPP_TANASHIN_MECH */
+#ifdef SUPP_CRP42602Y_MECH
+		if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
+		{
+			if(mech_crp42602y_calib_profile(CAL_get_leave(), CAL_get_home(), u8a_profile)==0)
+			{
+				u8_res = mech_crp42602y_set_profile(u8a_profile);
+			}
+			u8_size = PRF_42602_MAX;
+		}
+#endif /* SUPP_CRP42602Y_MECH */
+		if(u8_res==0)
+		{
+			// Store new profile for the selected transport.
+			u8a_settings[EPS_TIM_TYPE] = u8a_settings[EPS_TTR_TYPE];
+			for(u8_idx=0;u8_idx<u8_size;u8_idx++)
+			{
+				u8a_settings[EPS_TIM_DATA+u8_idx] = u8a_profile[u8_idx];
+			}
+#ifdef USE_EEPROM
+			save_settings();
+#endif /* USE_EEPROM */
+		}
+		else
+		{
+			CAL_fail(CAL_ERR_PROFILE);
+		}
+	}
+#ifdef UART_TERM
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+	{
+		UART_begin_line();
+		UART_add_flash_string((uint8_t *)cch_cal_leave); UART_add_dec16(CAL_get_leave(), 1);
+		UART_add_flash_string((uint8_t *)cch_cal_home); UART_add_dec16(CAL_get_home(), 1);
+		UART_add_flash_string((uint8_t *)cch_cal_spread); UART_add_dec16(CAL_get_spread(), 1);
+		UART_add_flash_string((uint8_t *)cch_cal_tacho); UART_add_dec16(CAL_get_tacho(), 1);
+		UART_add_flash_string((uint8_t *)cch_cal_ms);
+		UART_end_line();
+		UART_begin_line();
+		if(u8_res==0)
+		{
+			// Print new profile ("|%u" for each value in [PRF_xxx] order).
+			UART_add_flash_string((uint8_t *)cch_tim_profile);
+			for(u8_idx=0;u8_idx<u8_size;u8_idx++)
+			{
+				UART_add_char('|'); UART_add_dec8(u8a_profile[u8_idx], 1);
 			}
 		}
-	}
-	// Set both pins to perform as pulled-up inputs.
-	BTN_DIR_1 &= ~(BTN_PLAY|BTN_PLAY_REV);
-	BTN_PORT_1 |= (BTN_PLAY|BTN_PLAY_REV);
-	// Let pins stabilize.
-	_delay_us(20);
-}
-
-//-------------------------------------- Start-up check for held down STOP button.
-void scan_selftest_buttons(void)
-{
-	// Test button several times.
-	for(uint8_t idx=0;idx<50;idx++)
-	{
-		_delay_us(10);
-		if(BTN_STOP_STATE!=0)
+		else
 		{
-			// STOP button is not pressed.
-			// Cancel self-test.
-			u8_tasks &= ~TASK_SCAN_STEST;
-			return;
+			UART_add_flash_string((uint8_t *)cch_cal_fail); UART_add_dec8(CAL_get_error(), 1);
 		}
+		UART_add_flash_string((uint8_t *)cch_endl);
+		UART_end_line();
 	}
+#endif /* UART_TERM */
+	// Show the result before resuming normal operation.
+	u8_stest_timer = CAL_SHOW_TIME;
 }
 
 //-------------------------------------- Poll tachometer transitions.
@@ -633,6 +1084,21 @@ inline void count_up_tacho(void)
 	}
 }
 
+//-------------------------------------- Send indicator states to SPI extender.
+// Unchanged data is resent only every [SPI_REFRESH_CALLS] calls, SPI is powered only for transmission.
+inline void send_indicators(void)
+{
+	u8_spi_refresh++;
+	if((u8a_spi_buf[SPI_IDX_IND]!=u8_spi_sent)||(u8_spi_refresh>=SPI_REFRESH_CALLS))
+	{
+		u8_spi_refresh = 0;
+		u8_spi_sent = u8a_spi_buf[SPI_IDX_IND];
+		PDM_request(PDM_SPI);
+		SPI_TX_START;
+		SPI_send_byte(u8_spi_sent);
+	}
+}
+
 //-------------------------------------- Update indication.
 inline void update_indicators(void)
 {
@@ -785,8 +1251,7 @@ inline void update_indicators(void)
 		}
 	}
 	// Transmit indicator information via SPI.
-	SPI_TX_START;
-	SPI_send_byte(u8a_spi_buf[SPI_IDX_IND]);
+	send_indicators();
 }
 
 //-------------------------------------- Self-test mode indication.
@@ -839,18 +1304,55 @@ inline void selftest_indicators(void)
 	// Reset sleep timer.
 	u8_sleep_inh_timer = 0;
 	// Transmit indicator information via SPI.
-	SPI_TX_START;
-	SPI_send_byte(u8a_spi_buf[SPI_IDX_IND]);
+	send_indicators();
+}
+
+//-------------------------------------- Calibration mode indication.
+inline void calib_indicators(void)
+{
+	u8a_spi_buf[SPI_IDX_IND] &= (uint8_t)~(IND_ERROR|IND_TAPE|IND_STOP|IND_PLAY_REV|IND_PLAY|IND_REWIND|IND_FFORWARD|IND_REC);
+	if(CAL_is_running()!=0)
+	{
+		// Blink STOP and REWIND lights while calibration is running.
+		if((u8_tasks&TASK_SLOW_BLINK)!=0)
+		{
+			u8a_spi_buf[SPI_IDX_IND] |= IND_STOP|IND_REWIND;
+		}
+	}
+	else
+	{
+		// Show the result: STOP - new profile is saved, ERROR - calibration failed.
+		if(CAL_get_state()==CAL_ST_DONE)
+		{
+			u8a_spi_buf[SPI_IDX_IND] |= IND_STOP;
+		}
+		else
+		{
+			u8a_spi_buf[SPI_IDX_IND] |= IND_ERROR;
+		}
+		// Count down result indication.
+		if(u8_stest_timer!=0) u8_stest_timer--;
+		if(u8_stest_timer==0)
+		{
+			// Clear service mode.
+			u8_tasks &= ~TASK_SCAN_STEST;
+			// Clear indicators.
+			u8a_spi_buf[SPI_IDX_IND] &= (uint8_t)~(IND_ERROR|IND_STOP);
+		}
+	}
+	// Reset sleep timer.
+	u8_sleep_inh_timer = 0;
+	// Transmit indicator information via SPI.
+	send_indicators();
 }
 
 //-------------------------------------- Process input from user.
 void process_user(void)
 {
-#ifdef UART_TERM
-	uint8_t last_user_mode;
-	// Save mode.
-	last_user_mode = u8_user_mode;
-#endif /* UART_TERM */
+	uint8_t last_user_mode, u8_req_mode;
+	// Evaluate buttons against the latest request (it can be still pending in the queue).
+	u8_req_mode = CMDQ_get_last(u8_user_mode);
+	last_user_mode = u8_req_mode;
 	uint8_t buf_kbd_state;
 	buf_kbd_state = kbd_state;
 
@@ -863,7 +1365,7 @@ void process_user(void)
 	// Don't allow switching to playback while in recording mode.
 	// Don't allow switching to fast wind while in recording mode.
 	
-	if(u8_user_mode!=USR_MODE_STOP)
+	if(u8_req_mode!=USR_MODE_STOP)
 	{
 		// Current mode is not STOP.
 		if((u8a_settings[EPS_SRV_FTRS]&SRV_FEA_ONE2REC)==0)
@@ -879,18 +1381,18 @@ void process_user(void)
 			kbd_pressed&=~USR_BTN_RECORD;
 		}
 	}
-	if((u8_user_mode!=USR_MODE_REC_FWD)&&(u8_user_mode!=USR_MODE_REC_REV))
+	if((u8_req_mode!=USR_MODE_REC_FWD)&&(u8_req_mode!=USR_MODE_REC_REV))
 	{
 		// Record guarding: don't allow fast wind activations from RECORD mode.
 		if((kbd_pressed&USR_BTN_REWIND)!=0)
 		{
 			// Rewind.
-			u8_user_mode = USR_MODE_FWIND_REV;
+			u8_req_mode = USR_MODE_FWIND_REV;
 		}
 		if((kbd_pressed&USR_BTN_FFORWARD)!=0)
 		{
 			// Fast forward.
-			u8_user_mode = USR_MODE_FWIND_FWD;
+			u8_req_mode = USR_MODE_FWIND_FWD;
 		}
 	}
 	// Check reverse settings.
@@ -911,10 +1413,10 @@ void process_user(void)
 					// Record button is not held.
 					// User requested PLAYBACK.
 					// Don't allow direct transition from RECORD to PLAY. 
-					if(u8_user_mode!=USR_MODE_REC_FWD)
+					if(u8_req_mode!=USR_MODE_REC_FWD)
 					{
 						// Start/resume playback in forward direction.
-						u8_user_mode = USR_MODE_PLAY_FWD;
+						u8_req_mode = USR_MODE_PLAY_FWD;
 					}
 				}
 				// Previous checks must ensure that TTR is in STOP.
@@ -922,7 +1424,7 @@ void process_user(void)
 				{
 					// REC INHIBIT in forward direction is NOT active.
 					// Start/resume recording in forward direction.
-					u8_user_mode = USR_MODE_REC_FWD;
+					u8_req_mode = USR_MODE_REC_FWD;
 				}
 			}
 		}
@@ -938,17 +1440,17 @@ void process_user(void)
 				{
 					// REC INHIBIT in forward direction is inactive.
 					// Start/resume recording in forward direction.
-					u8_user_mode = USR_MODE_REC_FWD;
+					u8_req_mode = USR_MODE_REC_FWD;
 				}
 			}
 			if((kbd_pressed&USR_BTN_PLAY)!=0)
 			{
 				// PLAY was pressed.
 				// Don't allow direct transition from RECORD to PLAY.
-				if(u8_user_mode!=USR_MODE_REC_FWD)
+				if(u8_req_mode!=USR_MODE_REC_FWD)
 				{
 					// Start/resume playback in forward direction.
-					u8_user_mode = USR_MODE_PLAY_FWD;
+					u8_req_mode = USR_MODE_PLAY_FWD;
 				}
 			}
 		}
@@ -973,29 +1475,29 @@ void process_user(void)
 					{
 						// Record is NOT requested.
 						// Check if current mode is playback already and check current direction.
-						if(u8_user_mode==USR_MODE_PLAY_FWD)
+						if(u8_req_mode==USR_MODE_PLAY_FWD)
 						{
 							// Swap tape side.
-							u8_user_mode = USR_MODE_PLAY_REV;
+							u8_req_mode = USR_MODE_PLAY_REV;
 						}
-						else if(u8_user_mode==USR_MODE_PLAY_REV)
+						else if(u8_req_mode==USR_MODE_PLAY_REV)
 						{
 							// Swap tape side.
-							u8_user_mode = USR_MODE_PLAY_FWD;
+							u8_req_mode = USR_MODE_PLAY_FWD;
 						}
-						else if((u8_user_mode!=USR_MODE_REC_FWD)&&(u8_user_mode!=USR_MODE_REC_REV))
+						else if((u8_req_mode!=USR_MODE_REC_FWD)&&(u8_req_mode!=USR_MODE_REC_REV))
 						{
 							// Record is NOT requested and TTR is not in PLAY or RECORD.
 							// Check last playback direction.
 							if(u8_last_play_dir==PB_DIR_FWD)
 							{
 								// Start/resume playback in forward direction.
-								u8_user_mode = USR_MODE_PLAY_FWD;
+								u8_req_mode = USR_MODE_PLAY_FWD;
 							}
 							else
 							{
 								// Start/resume playback in reverse direction.
-								u8_user_mode = USR_MODE_PLAY_REV;
+								u8_req_mode = USR_MODE_PLAY_REV;
 							}
 						}
 					}
@@ -1011,7 +1513,7 @@ void process_user(void)
 							{
 								// Recording in forward is allowed.
 								// Start/resume recording in forward direction.
-								u8_user_mode = USR_MODE_REC_FWD;
+								u8_req_mode = USR_MODE_REC_FWD;
 							}
 						}
 						else
@@ -1021,7 +1523,7 @@ void process_user(void)
 							{
 								// Recording in reverse is allowed.
 								// Start/resume recording in reverse direction.
-								u8_user_mode = USR_MODE_REC_REV;
+								u8_req_mode = USR_MODE_REC_REV;
 							}
 						}
 					}
@@ -1043,7 +1545,7 @@ void process_user(void)
 						{
 							// Recording in forward is allowed.
 							// Start/resume recording in forward direction.
-							u8_user_mode = USR_MODE_REC_FWD;
+							u8_req_mode = USR_MODE_REC_FWD;
 						}
 					}
 					else
@@ -1053,7 +1555,7 @@ void process_user(void)
 						{
 							// Recording in reverse is allowed.
 							// Start/resume recording in reverse direction.
-							u8_user_mode = USR_MODE_REC_REV;
+							u8_req_mode = USR_MODE_REC_REV;
 						}
 					}
 				}
@@ -1062,30 +1564,30 @@ void process_user(void)
 				{
 					// PLAY was pressed.
 					// Check if current mode is playback already and check current direction.
-					if(u8_user_mode==USR_MODE_PLAY_FWD)
+					if(u8_req_mode==USR_MODE_PLAY_FWD)
 					{
 						// Swap tape side.
-						u8_user_mode = USR_MODE_PLAY_REV;
+						u8_req_mode = USR_MODE_PLAY_REV;
 					}
-					else if(u8_user_mode==USR_MODE_PLAY_REV)
+					else if(u8_req_mode==USR_MODE_PLAY_REV)
 					{
 						// Swap tape side.
-						u8_user_mode = USR_MODE_PLAY_FWD;
+						u8_req_mode = USR_MODE_PLAY_FWD;
 					}
 					// Don't allow direct transition from RECORD to PLAY.
-					else if((u8_user_mode!=USR_MODE_REC_FWD)&&(u8_user_mode!=USR_MODE_REC_REV))
+					else if((u8_req_mode!=USR_MODE_REC_FWD)&&(u8_req_mode!=USR_MODE_REC_REV))
 					{
 						// Record is NOT requested or TTR is not in PLAY.
 						// Check last playback direction.
 						if(u8_last_play_dir==PB_DIR_FWD)
 						{
 							// Start/resume playback in forward direction.
-							u8_user_mode = USR_MODE_PLAY_FWD;
+							u8_req_mode = USR_MODE_PLAY_FWD;
 						}
 						else
 						{
 							// Start/resume playback in reverse direction.
-							u8_user_mode = USR_MODE_PLAY_REV;
+							u8_req_mode = USR_MODE_PLAY_REV;
 						}
 					}
 				}
@@ -1102,17 +1604,17 @@ void process_user(void)
 				{
 					// Record is NOT requested.
 					// Don't allow direct transition from RECORD to PLAY.
-					if((u8_user_mode!=USR_MODE_REC_FWD)&&(u8_user_mode!=USR_MODE_REC_REV))
+					if((u8_req_mode!=USR_MODE_REC_FWD)&&(u8_req_mode!=USR_MODE_REC_REV))
 					{
 						if((kbd_pressed&USR_BTN_PLAY_REV)!=0)
 						{
 							// Start/resume playback in reverse direction (less priority).
-							u8_user_mode = USR_MODE_PLAY_REV;
+							u8_req_mode = USR_MODE_PLAY_REV;
 						}
 						if((kbd_pressed&USR_BTN_PLAY)!=0)
 						{
 							// Start/resume playback in forward direction (more priority).
-							u8_user_mode = USR_MODE_PLAY_FWD;
+							u8_req_mode = USR_MODE_PLAY_FWD;
 						}
 					}
 				}
@@ -1127,7 +1629,7 @@ void process_user(void)
 						{
 							// Recording in reverse is allowed.
 							// Start/resume recording in reverse direction (less priority).
-							u8_user_mode = USR_MODE_REC_REV;
+							u8_req_mode = USR_MODE_REC_REV;
 						}
 					}
 					if((kbd_pressed&USR_BTN_PLAY)!=0)
@@ -1138,7 +1640,7 @@ void process_user(void)
 						{
 							// Recording in forward is allowed.
 							// Start/resume recording in forward direction (more priority).
-							u8_user_mode = USR_MODE_REC_FWD;
+							u8_req_mode = USR_MODE_REC_FWD;
 						}
 					}
 				}
@@ -1159,7 +1661,7 @@ void process_user(void)
 						{
 							// Recording in forward is allowed.
 							// Start/resume record in forward direction.
-							u8_user_mode = USR_MODE_REC_FWD;
+							u8_req_mode = USR_MODE_REC_FWD;
 						}
 					}
 					else
@@ -1169,22 +1671,22 @@ void process_user(void)
 						{
 							// Recording in reverse is allowed.
 							// Start/resume record in reverse direction.
-							u8_user_mode = USR_MODE_REC_REV;
+							u8_req_mode = USR_MODE_REC_REV;
 						}
 					}
 				}
 				// Don't allow direct transition from RECORD to PLAY.
-				if((u8_user_mode!=USR_MODE_REC_FWD)&&(u8_user_mode!=USR_MODE_REC_REV))
+				if((u8_req_mode!=USR_MODE_REC_FWD)&&(u8_req_mode!=USR_MODE_REC_REV))
 				{
 					if((kbd_pressed&USR_BTN_PLAY_REV)!=0)
 					{
 						// Start/resume playback in reverse direction (less priority).
-						u8_user_mode = USR_MODE_PLAY_REV;
+						u8_req_mode = USR_MODE_PLAY_REV;
 					}
 					if((kbd_pressed&USR_BTN_PLAY)!=0)
 					{
 						// Start/resume playback in forward direction (more priority).
-						u8_user_mode = USR_MODE_PLAY_FWD;
+						u8_req_mode = USR_MODE_PLAY_FWD;
 					}
 				}
 			}
@@ -1193,19 +1695,76 @@ void process_user(void)
 	if((kbd_pressed&USR_BTN_STOP)!=0)
 	{
 		// Stop the tape.
+		u8_req_mode = USR_MODE_STOP;
+	}
+	if((last_user_mode==u8_req_mode)&&(u8_req_mode!=USR_MODE_STOP))
+	{
+		// No new request.
+		return;
+	}
+	// Pass the request to the transport through the command queue.
+	if(CMDQ_push(u8_req_mode, u8_user_mode)==CMDQ_RES_CANCEL)
+	{
+		// STOP cancels everything and applies right away.
 		u8_user_mode = USR_MODE_STOP;
 	}
 #ifdef UART_TERM
-	if(last_user_mode!=u8_user_mode)
+	if((last_user_mode!=u8_req_mode)&&UART_LOG_ON(LOG_SUB_KBD, LOG_LVL_INFO))
 	{
 		// Log user mode change.
 		UART_add_flash_string((uint8_t *)cch_new_user_mode);
-		UART_dump_user_mode(last_user_mode); UART_add_flash_string((uint8_t *)cch_arrow); UART_dump_user_mode(u8_user_mode);
+		UART_dump_user_mode(last_user_mode); UART_add_flash_string((uint8_t *)cch_arrow); UART_dump_user_mode(u8_req_mode);
 		UART_add_flash_string((uint8_t *)cch_endl);
 	}
 #endif /* UART_TERM */
 }
 
+//-------------------------------------- Feed queued button events to user input processing.
+static inline void keys_process(void)
+{
+	while(u8_kbd_q_count!=0)
+	{
+		kbd_pressed = u8a_kbd_q_press[u8_kbd_q_head];
+		kbd_released = u8a_kbd_q_release[u8_kbd_q_head];
+		u16_kbd_time = u16a_kbd_q_time[u8_kbd_q_head];
+		u8_kbd_q_head++;
+		if(u8_kbd_q_head>=KBD_QUEUE_SIZE) u8_kbd_q_head = 0;
+		u8_kbd_q_count--;
+#ifdef UART_TERM
+		if((kbd_released!=0)&&UART_LOG_ON(LOG_SUB_KBD, LOG_LVL_DEBUG))
+		{
+			UART_begin_line();
+			UART_add_flash_string((uint8_t *)cch_kbd_up); UART_add_flash_string((uint8_t *)cch_kbd_time); UART_add_dec16(u16_kbd_time, 1);
+			UART_dump_buttons(kbd_released);
+			UART_end_line();
+		}
+#endif /* UART_TERM */
+		if(kbd_pressed!=0)
+		{
+			// Reset sleep inhibition timer.
+			u8_sleep_inh_timer = 0;
+#ifdef UART_TERM
+			if(UART_LOG_ON(LOG_SUB_KBD, LOG_LVL_DEBUG))
+			{
+				UART_begin_line();
+				UART_add_flash_string((uint8_t *)cch_kbd_down); UART_add_flash_string((uint8_t *)cch_kbd_time); UART_add_dec16(u16_kbd_time, 1);
+				UART_dump_buttons(kbd_pressed);
+				UART_end_line();
+			}
+#endif /* UART_TERM */
+		}
+		if((u8_tasks&TASK_SCAN_STEST)==0)
+		{
+			// Process user input.
+			process_user();
+			// Update LEDs.
+			update_indicators();
+		}
+		// Clear processed events.
+		kbd_pressed = kbd_released = 0;
+	}
+}
+
 //-------------------------------------- Print feature set.
 void UART_dump_settings(uint8_t in_ttr_settings, uint8_t in_srv_settings)
 {
@@ -1275,9 +1834,300 @@ void UART_dump_settings(uint8_t in_ttr_settings, uint8_t in_srv_settings)
 	{
 		UART_add_flash_string((uint8_t *)cch_set_fw_auto_rewind); UART_add_flash_string((uint8_t *)cch_disabled);
 	}
+	if((in_srv_settings&SRV_FEA_PRESPIN)!=0)
+	{
+		UART_add_flash_string((uint8_t *)cch_set_prespin); UART_add_flash_string((uint8_t *)cch_enabled);
+	}
+	else
+	{
+		UART_add_flash_string((uint8_t *)cch_set_prespin); UART_add_flash_string((uint8_t *)cch_disabled);
+	}
 	#endif /* UART_TERM */
 }
 
+//-------------------------------------- Print buttons states.
+void UART_dump_buttons(uint8_t in_buttons)
+{
+#ifdef UART_TERM
+	UART_add_flash_string((uint8_t *)cch_kbd_rewind); UART_add_char(((in_buttons&USR_BTN_REWIND)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_kbd_stop); UART_add_char(((in_buttons&USR_BTN_STOP)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_kbd_ffwd); UART_add_char(((in_buttons&USR_BTN_FFORWARD)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_kbd_pb_fwd); UART_add_char(((in_buttons&USR_BTN_PLAY)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_kbd_pb_rev); UART_add_char(((in_buttons&USR_BTN_PLAY_REV)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_kbd_rec); UART_add_char(((in_buttons&USR_BTN_RECORD)==0)?'0':'1');
+	UART_add_flash_string((uint8_t *)cch_endl);
+#endif /* UART_TERM */
+}
+
+//-------------------------------------- Print log filter configuration and drop counters.
+// Output format: "LOG|CFG:0x%02x|FLT:%u/%u/%u/%u/%u|LOST:%u\n\r" (filtered per subsystem in [LOG_SUB_xxx] order).
+void UART_dump_log_stats(void)
+{
+#ifdef UART_TERM
+	uint8_t u8_sub;
+	UART_begin_line();
+	UART_add_flash_string((uint8_t *)cch_log_cfg); UART_add_hex8(UART_log_get_setup());
+	UART_add_flash_string((uint8_t *)cch_log_filtered);
+	for(u8_sub=0;u8_sub<LOG_SUB_MAX;u8_sub++)
+	{
+		if(u8_sub!=0) UART_add_char('/');
+		UART_add_dec16(UART_log_get_filtered(u8_sub), 1);
+	}
+	UART_add_flash_string((uint8_t *)cch_log_lost); UART_add_dec16(UART_log_get_lost(), 1);
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+#endif /* UART_TERM */
+}
+
+#ifdef UART_TERM
+//-------------------------------------- Add current (in 10 uA units) as "%u.%02u" text in mA to output buffer.
+static void UART_add_current(uint16_t in_value)
+{
+	UART_add_dec16(in_value/100, 1);
+	UART_add_char('.');
+	UART_add_dec8((uint8_t)(in_value%100), 2);
+}
+#endif /* UART_TERM */
+
+//-------------------------------------- Print usage statistics.
+// Output format: "STAT|PB:0x%08x|RC:0x%08x|FW:0x%08x|CAP:0x%08x|SOL:0x%08x|RTR:0x%08x|HLT:0x%08x\n\r" (times in seconds).
+void UART_dump_usage_stats(void)
+{
+#ifdef UART_TERM
+#ifdef EN_STAT_EEPROM
+	const uint8_t *p_labels[STAT_CNT_MAX] = {cch_stat_play, cch_stat_record, cch_stat_fwind, cch_stat_capstan, cch_stat_solenoid, cch_stat_retries, cch_stat_halts};
+	uint8_t u8_idx;
+	uint32_t u32_value;
+	UART_begin_line();
+	for(u8_idx=0;u8_idx<STAT_CNT_MAX;u8_idx++)
+	{
+		u32_value = STAT_get_counter(u8_idx);
+		UART_add_flash_string(p_labels[u8_idx]);
+		UART_add_hex8((uint8_t)(u32_value>>24)); UART_add_hex8((uint8_t)(u32_value>>16));
+		UART_add_hex8((uint8_t)(u32_value>>8)); UART_add_hex8((uint8_t)u32_value);
+	}
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+#endif /* EN_STAT_EEPROM */
+#endif /* UART_TERM */
+}
+
+#ifdef CRC_BENCH
+#define CRC_BENCH_LEN		64		// Benchmark data buffer length
+#define CRC_BENCH_PASSES	4		// Number of passes through the buffer (256 bytes in total)
+
+//-------------------------------------- Stand-in engines to measure loop and call overhead.
+static uint8_t CRC8_calc_none(uint8_t CRC_data, uint8_t in_data)
+{
+	return CRC_data^in_data;
+}
+
+static uint16_t CRC16_calc_none(uint16_t CRC_data, uint8_t in_data)
+{
+	return CRC_data^in_data;
+}
+
+//-------------------------------------- Run CRC engine through the buffer.
+// Returns number of CPU cycles, CRC result is stored into [p_crc].
+static uint16_t CRC8_bench_run(uint8_t (*p_calc)(uint8_t, uint8_t), const uint8_t *p_buf, uint8_t *p_crc)
+{
+	uint8_t u8_crc, u8_pass, u8_idx;
+	uint16_t u16_cycles;
+	u8_crc = CRC8_init();
+	cli();
+	CYCT_RESET;
+	CYCT_START;
+	for(u8_pass=0;u8_pass<CRC_BENCH_PASSES;u8_pass++)
+	{
+		for(u8_idx=0;u8_idx<CRC_BENCH_LEN;u8_idx++)
+		{
+			u8_crc = p_calc(u8_crc, p_buf[u8_idx]);
+		}
+	}
+	CYCT_STOP;
+	u16_cycles = CYCT_DATA_16;
+	sei();
+	(*p_crc) = u8_crc;
+	return u16_cycles;
+}
+
+static uint16_t CRC16_bench_run(uint16_t (*p_calc)(uint16_t, uint8_t), const uint8_t *p_buf)
+{
+	uint8_t u8_pass, u8_idx;
+	uint16_t u16_crc, u16_cycles;
+	u16_crc = CRC16_init();
+	cli();
+	CYCT_RESET;
+	CYCT_START;
+	for(u8_pass=0;u8_pass<CRC_BENCH_PASSES;u8_pass++)
+	{
+		for(u8_idx=0;u8_idx<CRC_BENCH_LEN;u8_idx++)
+		{
+			u16_crc = p_calc(u16_crc, p_buf[u8_idx]);
+		}
+	}
+	CYCT_STOP;
+	u16_cycles = CYCT_DATA_16;
+	sei();
+	return u16_cycles;
+}
+#endif /* CRC_BENCH */
+
+//-------------------------------------- Measure and print CPU cycles per byte for all CRC engines.
+// Output format: "CRC|ENG:%u|CPB:%u|TBL:%u\n\r" per engine in [CRC8_ENG_xxx] order, CRC-16 last (engine number [CRC8_ENG_MAX]).
+// Cycles do not include loop and call overhead, "|MISMATCH" is added if CRC-8 result differs from [CRC8_ENG_LUT256].
+void UART_dump_crc_bench(void)
+{
+#ifdef UART_TERM
+#ifdef CRC_BENCH
+	uint8_t (* const p_engines[CRC8_ENG_MAX])(uint8_t, uint8_t) = {CRC8_calc_lut256, CRC8_calc_lut16, CRC8_calc_bitwise};
+	const uint16_t u16a_tables[CRC8_ENG_MAX+1] = {CRC8_LUT256_SIZE, CRC8_LUT16_SIZE, 0, CRC16_LUT_SIZE};
+	uint8_t u8a_data[CRC_BENCH_LEN];
+	uint8_t u8_idx, u8_crc, u8_ref_crc;
+	uint16_t u16_base, u16_cycles;
+	// Power up Timer 1 for cycle counting.
+	PDM_request(PDM_T1);
+	// Fill buffer with some data.
+	for(u8_idx=0;u8_idx<CRC_BENCH_LEN;u8_idx++)
+	{
+		u8a_data[u8_idx] = (uint8_t)(u8_idx*29+7);
+	}
+	u16_base = CRC8_bench_run(CRC8_calc_none, u8a_data, &u8_crc);
+	u8_ref_crc = 0;
+	for(u8_idx=0;u8_idx<=CRC8_ENG_MAX;u8_idx++)
+	{
+		if(u8_idx<CRC8_ENG_MAX)
+		{
+			u16_cycles = CRC8_bench_run(p_engines[u8_idx], u8a_data, &u8_crc);
+			u16_cycles -= u16_base;
+		}
+		else
+		{
+			u16_cycles = CRC16_bench_run(CRC16_calc, u8a_data)-CRC16_bench_run(CRC16_calc_none, u8a_data);
+		}
+		if(u8_idx==CRC8_ENG_LUT256)
+		{
+			u8_ref_crc = u8_crc;
+		}
+		UART_begin_line();
+		UART_add_flash_string((uint8_t *)cch_crc_engine); UART_add_dec8(u8_idx, 1);
+		UART_add_flash_string((uint8_t *)cch_crc_cycles); UART_add_dec16((u16_cycles+(CRC_BENCH_LEN*CRC_BENCH_PASSES/2))/(CRC_BENCH_LEN*CRC_BENCH_PASSES), 1);
+		UART_add_flash_string((uint8_t *)cch_crc_table); UART_add_dec16(u16a_tables[u8_idx], 1);
+		if((u8_idx<CRC8_ENG_MAX)&&(u8_crc!=u8_ref_crc))
+		{
+			UART_add_flash_string((uint8_t *)cch_crc_mismatch);
+		}
+		UART_add_flash_string((uint8_t *)cch_endl);
+		UART_end_line();
+		UART_dump_out();
+	}
+	PDM_release(PDM_T1);
+#endif /* CRC_BENCH */
+#endif /* UART_TERM */
+}
+
+//-------------------------------------- Print estimated current budget for all power profiles.
+// Output format: "PWR|IDLE:%u.%02u|STOP:...|PLAY:...|REC:...|WIND:... mA\n\r", "PWR|SLEEP:%u uA\n\r".
+void UART_dump_power_budget(void)
+{
+#ifdef UART_TERM
+	const uint8_t *p_labels[PDM_MODE_MAX] = {cch_pwr_idle, cch_pwr_stop, cch_pwr_play, cch_pwr_rec, cch_pwr_wind};
+	uint8_t u8_idx;
+	UART_begin_line();
+	for(u8_idx=0;u8_idx<PDM_MODE_MAX;u8_idx++)
+	{
+		UART_add_flash_string(p_labels[u8_idx]);
+		UART_add_current(PDM_get_budget(u8_idx));
+	}
+	UART_add_flash_string((uint8_t *)cch_pwr_unit);
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+	UART_begin_line();
+	UART_add_flash_string((uint8_t *)cch_pwr_sleep);
+#ifdef EN_SLEEP_POLL
+	UART_add_dec16(PDM_get_standby(WDT_POLL_MS), 1);
+#else
+	UART_add_dec16(PDM_get_standby(0), 1);
+#endif /* EN_SLEEP_POLL */
+	UART_add_flash_string((uint8_t *)cch_pwr_unit_ua);
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+#endif /* UART_TERM */
+}
+
+//-------------------------------------- Print state of adaptive capstan shutdown policy.
+// Output format: "IDLE|TO:%u s|AVD:%u|SPN:%u\n\r" (current timeout, spin-ups avoided, spin-ups after timeout).
+void UART_dump_idle_policy(void)
+{
+#ifdef UART_TERM
+#ifdef EN_IDLE_ADAPT
+	UART_begin_line();
+	UART_add_flash_string((uint8_t *)cch_idle_timeout); UART_add_dec16(IDL_get_timeout()/500, 1);
+	UART_add_flash_string((uint8_t *)cch_idle_avoided); UART_add_dec16(IDL_get_avoided(), 1);
+	UART_add_flash_string((uint8_t *)cch_idle_spinups); UART_add_dec16(IDL_get_spinups(), 1);
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+#endif /* EN_IDLE_ADAPT */
+#endif /* UART_TERM */
+}
+
+//-------------------------------------- Send binary telemetry frame.
+// Frame layout is described by [TLM_IDX_xxx] in [common_log.h].
+// <100 us @ 8 MHz, the frame is dropped as a whole if UART buffer is full.
+void UART_send_telemetry(void)
+{
+#ifdef UART_TELEMETRY
+	uint8_t u8a_frame[TLM_FRAME_SIZE];
+	uint8_t u8_idx, u8_crc;
+	u8a_frame[TLM_IDX_SYNC_1] = TLM_SYNC_1;
+	u8a_frame[TLM_IDX_SYNC_2] = TLM_SYNC_2;
+	u8a_frame[TLM_IDX_TICK_L] = (uint8_t)(u16_sys_ticks&0xFF);
+	u8a_frame[TLM_IDX_TICK_H] = (uint8_t)(u16_sys_ticks>>8);
+	u8a_frame[TLM_IDX_SWS] = sw_state;
+	u8a_frame[TLM_IDX_KBD] = kbd_state;
+	u8a_frame[TLM_IDX_USR_MODE] = u8_user_mode;
+	u8a_frame[TLM_IDX_MECH_MODE] = 0xFF;
+	u8a_frame[TLM_IDX_MECH_TARGET] = 0xFF;
+#ifdef SUPP_TANASHIN_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
+	{
+		u8a_frame[TLM_IDX_MECH_MODE] = mech_tanashin_get_state();
+		u8a_frame[TLM_IDX_MECH_TARGET] = mech_tanashin_get_target();
+	}
+#endif /* SUPP_TANASHIN_MECH */
+#ifdef SUPP_CRP42602Y_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
+	{
+		u8a_frame[TLM_IDX_MECH_MODE] = mech_crp42602y_get_state();
+		u8a_frame[TLM_IDX_MECH_TARGET] = mech_crp42602y_get_target();
+	}
+#endif /* SUPP_CRP42602Y_MECH */
+#ifdef SUPP_KENWOOD_MECH
+	if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_KENWOOD)
+	{
+		u8a_frame[TLM_IDX_MECH_MODE] = mech_knwd_get_state();
+		u8a_frame[TLM_IDX_MECH_TARGET] = mech_knwd_get_target();
+	}
+#endif /* SUPP_KENWOOD_MECH */
+	u8a_frame[TLM_IDX_TRANS_TMR] = u8_transition_timer;
+	u8a_frame[TLM_IDX_TACHO_TMR] = u8_tacho_timer;
+	u8a_frame[TLM_IDX_OUTPUTS] = 0;
+	if(SOLENOID_STATE!=0) u8a_frame[TLM_IDX_OUTPUTS] |= TLM_OUT_SOLENOID;
+	if(CAPSTAN_STATE!=0) u8a_frame[TLM_IDX_OUTPUTS] |= TLM_OUT_CAPSTAN;
+	if(MUTE_EN_STATE!=0) u8a_frame[TLM_IDX_OUTPUTS] |= TLM_OUT_MUTE;
+	if(REC_EN_STATE!=0) u8a_frame[TLM_IDX_OUTPUTS] |= TLM_OUT_REC;
+	u8a_frame[TLM_IDX_ERROR] = u8_transport_error;
+	// Calculate CRC for everything after sync bytes.
+	u8_crc = CRC8_init();
+	for(u8_idx=TLM_IDX_TICK_L;u8_idx<TLM_IDX_CRC;u8_idx++)
+	{
+		u8_crc = CRC8_calc(u8_crc, u8a_frame[u8_idx]);
+	}
+	u8a_frame[TLM_IDX_CRC] = u8_crc;
+	UART_add_data(u8a_frame, TLM_FRAME_SIZE);
+#endif /* UART_TELEMETRY */
+}
+
 //-------------------------------------- Main function.
 int main(void)
 {
@@ -1287,7 +2137,7 @@ int main(void)
 	// Start SPI comms.
 	SPI_int_enable();
 	SPI_TX_START;
-	SPI_send_byte(0x00);
+	SPI_send_byte(u8_spi_sent);
 
 	// Preload startup tests.
 	u8_tasks |= (TASK_SCAN_PB_BTNS|TASK_SCAN_STEST);
@@ -1310,11 +2160,23 @@ int main(void)
 	u8a_settings[EPS_TTR_FTRS] = TTR_FEA_DEFAULT;
 	// Default service features.
 	u8a_settings[EPS_SRV_FTRS] = SRV_FEA_DEFAULT;
+	// Default log configuration.
+	u8a_settings[EPS_LOG_CFG] = UART_LOG_DEFAULT;
+	// Default timings for all transports.
+	u8a_settings[EPS_TIM_TYPE] = TIM_PROFILE_NONE;
 
 #ifdef USE_EEPROM
 	// Read feature settings from EEPROM.
 	read_settings();
 #endif
+#ifdef EN_STAT_EEPROM
+	// Restore usage counters from the journal.
+	STAT_load();
+#endif /* EN_STAT_EEPROM */
+#ifdef UART_TERM
+	// Apply log filter from settings.
+	UART_log_setup(u8a_settings[EPS_LOG_CFG]);
+#endif /* UART_TERM */
 
 	if((u8_tasks&TASK_SCAN_PB_BTNS)!=0)
 	{
@@ -1329,13 +2191,12 @@ int main(void)
 		// Disable functions for non-reverse mech.
 		u8a_settings[EPS_TTR_FTRS] &= ~(TTR_FEA_STOP_TACHO|TTR_FEA_REV_ENABLE);	
 		u8a_settings[EPS_SRV_FTRS] &= ~(SRV_FEA_TWO_PLAYS|SRV_FEA_PB_AUTOREV|SRV_FEA_PB_LOOP);
-#ifdef SUPP_TANASHIN_MECH
-		// This transport does not have reverse record inhibit switch,
-		// using this pin as power supply for tacho sensor.
-		TANA_TACHO_PWR_SETUP;
-		TANA_TACHO_PWR_EN;
-#endif		
 	}
+	// Take control over power domains.
+	// (Tanashin does not have reverse record inhibit switch, its pin is used as power supply for tacho sensor)
+	PDM_init((u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)?1:0);
+	// Replace default mechanism timings with profile from settings.
+	load_timing_profile();
 
 	// Init modes to selected transport.
 	u8_user_mode = USR_MODE_STOP;
@@ -1364,7 +2225,10 @@ int main(void)
 	}
 #endif /* SUPP_KENWOOD_MECH */
 	UART_add_flash_string((uint8_t *)cch_endl); UART_dump_settings(u8a_settings[EPS_TTR_FTRS], u8a_settings[EPS_SRV_FTRS]); UART_add_flash_string((uint8_t *)cch_endl);
+	UART_dump_usage_stats();
+	UART_dump_power_budget();
 	UART_dump_out();
+	UART_dump_crc_bench();
 #endif /* UART_TERM */
 
 	// Check if STOP button is held at start-up
@@ -1372,9 +2236,25 @@ int main(void)
 	scan_selftest_buttons();
 	if((u8_tasks&TASK_SCAN_STEST)!=0)
 	{
-		u8_stest_timer = 100;
+		// Check if REWIND button is held as well
+		// to run timing calibration instead of self-test.
+		if(scan_calib_buttons()!=0)
+		{
+			calib_start();
+		}
+		else
+		{
+			u8_stest_timer = 100;
+		}
 	}
 
+	// Start buttons scanning by pin change interrupt (after start-up tests have finished toggling button pins).
+	BTN_CLR_INTR;
+	BTN_EN_INTR2;
+	// Register buttons held at start-up.
+	u16_kbd_edge = u16_sys_ticks;
+	u8_kbd_deb_timer = KBD_DEB_TIME;
+
     // Main cycle.
     while(1)
     {
@@ -1384,16 +2264,35 @@ int main(void)
 	    u8_buf_interrupts|=u8i_interrupts;
 	    // Clear all interrupt flags.
 	    u8i_interrupts=0;
+		// Buffer buttons states latched at edges.
+		u8_kbd_latch&=u8i_btn_latch;
+		u8i_btn_latch=0xFF;
 		// Enable interrupts globally.
 	    sei();
 
 	    // Process deferred tasks.
+		if((u8_buf_interrupts&INTR_BTN_EDGE)!=0)
+		{
+			u8_buf_interrupts&=~INTR_BTN_EDGE;
+			// Start debounce window (or register the button that has woken up the MCU).
+			keys_edge();
+		}
 		if((u8_buf_interrupts&INTR_SYS_TICK)!=0)
 		{
 			u8_buf_interrupts&=~INTR_SYS_TICK;
 			// System timing: 1000 Hz, 1000 us period.
 			// Process additional slow timers.
 			slow_timing();
+			// Validate buttons after debounce window.
+			keys_debounce();
+			if(CAL_is_running()!=0)
+			{
+				// Timing calibration drives the transport, sample sensors each tick.
+				if(CAL_tick((SW_STOP_STATE!=0), (SW_TACHO_STATE!=0))>=CAL_ST_DONE)
+				{
+					calib_finish();
+				}
+			}
 
 			// Process slow events.
 			if((u8_tasks&TASK_2HZ)!=0)
@@ -1404,14 +2303,34 @@ int main(void)
 				u8_tasks^=TASK_SLOW_BLINK;
 				// Reset watchdog timer.
 				wdt_reset();
+#ifdef UART_TERM
+				// Power down USART if there was nothing to send for a while.
+				if(UART_is_idle()!=0)
+				{
+					PDM_release(PDM_UART);
+				}
+#endif /* UART_TERM */
 				// Increase sleep inhibition timer.
 				if(u8_sleep_inh_timer<SLEEP_INHIBIT_2HZ)
 				{
 					u8_sleep_inh_timer++;
 				}
+#ifdef EN_STAT_EEPROM
+				// Account run time and flush usage stats periodically.
+				if((u8_tasks&TASK_SCAN_STEST)==0)
+				{
+					STAT_count_time(u8_mech_mode, CAPSTAN_STATE);
+				}
+#endif /* EN_STAT_EEPROM */
 #ifdef UART_TERM
-				//sprintf(u8a_buf, "SLEEP|%05u|%03u\n\r", u16_crp42602y_idle_time, u8_tacho_timer);
-				//UART_add_string(u8a_buf);
+				// Report messages lost due to output buffer overflow.
+				if(UART_log_get_lost()!=u16_log_lost_old)
+				{
+					u16_log_lost_old = UART_log_get_lost();
+					UART_dump_log_stats();
+				}
+				//UART_add_flash_string((uint8_t *)cch_sleep_state); UART_add_dec16(u16_crp42602y_idle_time, 5);
+				//UART_add_char('|'); UART_add_dec8(u8_tacho_timer, 3); UART_add_flash_string((uint8_t *)cch_endl);
 #endif /* UART_TERM */
 			}
 			if((u8_tasks&TASK_10HZ)!=0)
@@ -1420,14 +2339,27 @@ int main(void)
 				// 10 Hz event, 100 ms period.
 				// Toggle fast blink flag.
 				u8_tasks^=TASK_FAST_BLINK;
+#ifdef USE_EEPROM
+				// Report finished EEPROM jobs.
+				check_settings_save();
+#endif /* USE_EEPROM */
 				if((u8_tasks&TASK_SCAN_STEST)!=0)
 				{
-					// Self-test indication.
-					selftest_indicators();
+					if(CAL_get_state()!=CAL_ST_OFF)
+					{
+						// Calibration indication.
+						calib_indicators();
+					}
+					else
+					{
+						// Self-test indication.
+						selftest_indicators();
+					}
 				}
 #ifdef UART_TERM
-				//sprintf(u8a_buf, "SLEEP|%02u|%05u|%03u\n\r", u8_crp42602y_mode, u16_crp42602y_idle_time, u8_tacho_timer);
-				//UART_add_string(u8a_buf);
+				//UART_add_flash_string((uint8_t *)cch_sleep_state); UART_add_dec8(u8_crp42602y_mode, 2);
+				//UART_add_char('|'); UART_add_dec16(u16_crp42602y_idle_time, 5);
+				//UART_add_char('|'); UART_add_dec8(u8_tacho_timer, 3); UART_add_flash_string((uint8_t *)cch_endl);
 #endif /* UART_TERM */
 			}
 			if((u8_tasks&TASK_50HZ)!=0)
@@ -1435,21 +2367,24 @@ int main(void)
 				// ~105 us @ 1 MHz (without UART logging)
 				u8_tasks&=~TASK_50HZ;
 				// 50 Hz event, 20 ms period.
-				// Scan user keys.
-				keys_simple_scan();
 				// Scan switches and sensors.
 				switches_scan();
 				// Increase tachometer timer.
 				count_up_tacho();
 				if((u8_tasks&TASK_SCAN_STEST)==0)
 				{
-					// Process user input.
-					process_user();
 					// Update LEDs.
 					update_indicators();
 				}
-				// Clear unused events.
-				kbd_pressed = kbd_released = 0;
+#ifdef UART_TELEMETRY
+				// Stream transport state.
+				u8_tlm_div++;
+				if(u8_tlm_div>=TLM_RATE_DIV)
+				{
+					u8_tlm_div = 0;
+					UART_send_telemetry();
+				}
+#endif /* UART_TELEMETRY */
 			}
 			if((u8_tasks&TASK_500HZ)!=0)
 			{
@@ -1459,9 +2394,48 @@ int main(void)
 				DBG_MODE_SINC_ON;
 				// Scan tachometer.
 				poll_tacho();
+#ifdef EN_STOP_ANCHOR
+				// Scan STOP sensor at state machine rate for cyclogram re-anchoring.
+				scan_stop_sensor();
+#endif /* EN_STOP_ANCHOR */
 				// Check if transport operation is allowed.
 				if((u8_tasks&TASK_SCAN_STEST)==0)
 				{
+					// Chain the next queued command right after transport has reached the previous one.
+					if((CMDQ_get_count()!=0)&&(u8_transition_timer==0)&&(u8_mech_mode==u8_user_mode))
+					{
+						u8_user_mode = CMDQ_pop();
+#ifdef UART_TERM
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+						{
+							UART_add_flash_string((uint8_t *)cch_cmd_next); UART_dump_user_mode(u8_user_mode);
+							UART_add_flash_string((uint8_t *)cch_endl);
+						}
+#endif /* UART_TERM */
+					}
+					// Check if cassette was just inserted (event from [switches_scan()]).
+					if(((u8a_settings[EPS_SRV_FTRS]&SRV_FEA_PRESPIN)!=0)&&((sw_pressed&TTR_SW_TAPE_IN)!=0)&&(u8_user_mode==USR_MODE_STOP))
+					{
+						// Spin up capstan now, so the first command does not wait for it.
+#ifdef SUPP_TANASHIN_MECH
+						if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
+						{
+							mech_tanashin_prespin();
+						}
+#endif /* SUPP_TANASHIN_MECH */
+#ifdef SUPP_CRP42602Y_MECH
+						if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
+						{
+							mech_crp42602y_prespin();
+						}
+#endif /* SUPP_CRP42602Y_MECH */
+#ifdef SUPP_KENWOOD_MECH
+						if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_KENWOOD)
+						{
+							mech_knwd_prespin();
+						}
+#endif /* SUPP_KENWOOD_MECH */
+					}
 					// Update transport state machine and solenoid action.
 					if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_TANASHIN)
 					{
@@ -1471,6 +2445,7 @@ int main(void)
 						u8_mech_mode = mech_tanashin_get_mode();
 						u8_transition_timer = mech_tanashin_get_transition();
 						u8_transport_error = mech_tanashin_get_error();
+						u8_mode_retries = mech_tanashin_get_retries();
 #endif /* SUPP_TANASHIN_MECH */
 					}
 					else if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_CRP42602Y)
@@ -1481,6 +2456,7 @@ int main(void)
 						u8_mech_mode = mech_crp42602y_get_mode();
 						u8_transition_timer = mech_crp42602y_get_transition();
 						u8_transport_error = mech_crp42602y_get_error();
+						u8_mode_retries = mech_crp42602y_get_retries();
 #endif /* SUPP_CRP42602Y_MECH */
 					}
 					else if(u8a_settings[EPS_TTR_TYPE]==TTR_TYPE_KENWOOD)
@@ -1491,6 +2467,7 @@ int main(void)
 						u8_mech_mode = mech_knwd_get_mode();
 						u8_transition_timer = mech_knwd_get_transition();
 						u8_transport_error = mech_knwd_get_error();
+						u8_mode_retries = mech_knwd_get_retries();
 #endif /* SUPP_KENWOOD_MECH */
 					}
 					else
@@ -1499,13 +2476,48 @@ int main(void)
 						u8_mech_mode = USR_MODE_STOP;
 						u8_transition_timer = 0;
 						u8_transport_error = TTR_ERR_LOGIC_FAULT;
+						u8_mode_retries = 0;
 					}
+					if((u8_transport_error!=TTR_ERR_NONE)||((sw_state&TTR_SW_TAPE_IN)==0))
+					{
+						// Pending commands can not be executed.
+						CMDQ_clear();
+					}
+#ifdef EN_STAT_EEPROM
+					// Count solenoid actuations, retries and HALT events.
+					STAT_count_events(SOLENOID_STATE, u8_mode_retries, u8_transport_error);
+#endif /* EN_STAT_EEPROM */
+				}
+#ifdef UART_TERM
+				// Track the first command after wake up.
+				wake_latency_check();
+#endif /* UART_TERM */
+				// Switch power domains for current transport mode.
+				if(PDM_update(u8_mech_mode, CAPSTAN_STATE)!=0)
+				{
+#ifdef UART_TERM
+					if(UART_LOG_ON(LOG_SUB_POWER, LOG_LVL_DEBUG))
+					{
+						UART_begin_line();
+						UART_add_flash_string((uint8_t *)cch_pwr_mode); UART_add_dec8(PDM_get_mode(), 1);
+						UART_add_flash_string((uint8_t *)cch_pwr_domains); UART_add_hex8(PDM_get_state());
+						UART_add_flash_string((uint8_t *)cch_pwr_budget); UART_add_current(PDM_get_budget(PDM_get_mode()));
+						UART_add_flash_string((uint8_t *)cch_endl);
+						UART_end_line();
+					}
+#endif /* UART_TERM */
 				}
 #ifdef UART_TERM
+				// Report capstan shutdown policy when capstan stops.
+				if((CAPSTAN_STATE==0)&&(u8_capst_old!=0)&&UART_LOG_ON(LOG_SUB_POWER, LOG_LVL_INFO))
+				{
+					UART_dump_idle_policy();
+				}
+				u8_capst_old = (CAPSTAN_STATE!=0);
 				uint8_t u8_old_dir;
 				// Log tape direction change.
 				u8_old_dir = u8_last_play_dir;
-				if(u8_old_dir!=u8_last_play_dir)
+				if((u8_old_dir!=u8_last_play_dir)&&UART_LOG_ON(LOG_SUB_KBD, LOG_LVL_INFO))
 				{
 					if(u8_last_play_dir==PB_DIR_FWD)
 					{
@@ -1529,12 +2541,23 @@ int main(void)
 			// Clear all timed flags.
 			//u8_tasks&=~(TASK_1HZ|TASK_2HZ|TASK_10HZ|TASK_50HZ|TASK_250HZ|TASK_500HZ);
 		}
+		if(u8_kbd_q_count!=0)
+		{
+			// Process validated button events.
+			keys_process();
+		}
 		if((u8_buf_interrupts&INTR_SPI_READY)!=0)
 		{
 			u8_buf_interrupts&=~INTR_SPI_READY;
 			// Finish SPI transmittion by releasing /CS.
 			SPI_TX_END;
+			// SPI is not needed until indicators change.
+			PDM_release(PDM_SPI);
 		}
+#ifdef EN_CLK_SCALE
+		// Select core clock for the next cycle (before sending UART data).
+		PDM_set_clock(core_can_slow_down());
+#endif /* EN_CLK_SCALE */
 #ifdef UART_TERM
 		if((u8_buf_interrupts&INTR_UART_SENT)!=0)
 		{
@@ -1551,10 +2574,19 @@ int main(void)
 		}
 		else if((CAPSTAN_STATE==0)&&					// Capstan was stopped by timeout
 			(u8_sleep_inh_timer>=SLEEP_INHIBIT_2HZ)&&	// Sleep is allowed
+			(u8_kbd_deb_timer==0)&&						// Buttons are validated
+			(EEPROM_is_busy()==0)&&						// EEPROM write is finished
+			(u8_save_pending==0)&&						// No delayed settings save
 			(u8_transport_error==TTR_ERR_NONE))			// No pending errors
 		{
-			// Go to sleep.
-			CPU_power_down();
+#ifdef EN_STAT_EEPROM
+			// Flush usage stats before sleep (if wear budget allows), sleep after the record is written.
+			if(STAT_flush(STAT_FLUSH_GAP)==0)
+#endif /* EN_STAT_EEPROM */
+			{
+				// Go to sleep.
+				CPU_power_down();
+			}
 		}
 
     }
@@ -38,6 +38,12 @@ Processes switches reading, user input (buttons) reading, mode indication, timin
 #include "common_log.h"
 #include "drv_eeprom.h"
 #include "drv_io.h"
+#include "cmd_queue.h"
+#include "idle_policy.h"
+#include "mech_calib.h"
+#include "power_dom.h"
+#include "settings.h"
+#include "usage_stats.h"
 #ifdef SUPP_TANASHIN_MECH
 #include "mech_tanashin.h"
 #endif /* SUPP_TANASHIN_MECH */
@@ -54,6 +60,8 @@ Processes switches reading, user input (buttons) reading, mode indication, timin
 #define INTR_SPI_READY		(1<<2)
 #define INTR_UART_SENT		(1<<3)
 #define INTR_UART_RECEIVED	(1<<4)
+#define INTR_WDT_POLL		(1<<5)
+#define INTR_BTN_EDGE		(1<<6)
 
 // Flags for [u8_tasks].
 #define	TASK_500HZ			(1<<0)	// 500 Hz event
@@ -63,7 +71,7 @@ Processes switches reading, user input (buttons) reading, mode indication, timin
 #define	TASK_SLOW_BLINK		(1<<4)	// Indicator slow blink source
 #define	TASK_FAST_BLINK		(1<<5)	// Indicator fast blink source
 #define	TASK_SCAN_PB_BTNS	(1<<6)	// Start-up scan for number of playback buttons
-#define	TASK_SCAN_STEST		(1<<7)	// Start-up scan for self-test mode
+#define	TASK_SCAN_STEST		(1<<7)	// Start-up scan for service mode (self-test or timing calibration)
 
 // Flags for [kbd_state], [kbd_pressed] and [kbd_released].
 #define USR_BTN_REWIND		(1<<0)	// Rewind button
@@ -101,21 +109,36 @@ enum
 	SPI_IDX_MAX						// Index limit
 };
 
-// EEPROM settings offsets.
+#define SLEEP_INHIBIT_2HZ	6		// Time for sleep inhibition with 2HZ rate
+#define SLEEP_POLL_DEB		2		// Number of watchdog polls for switch state to settle before waking up
+#define KBD_DEB_TIME		5		// Buttons debounce window after the last edge (ms)
+#define KBD_QUEUE_SIZE		4		// Number of validated button events in the queue
+
+// States of wake-to-action latency measurement.
 enum
 {
-	EPS_MARKER,						// Start marker position
-	EPS_TTR_TYPE,					// Transport type (if several types are enabled on compile time)
-	EPS_TTR_FTRS,					// Transport features (tacho in stop, reverse enable, etc.)
-	EPS_SRV_FTRS,					// Service features (auto-reverse, auto-rewind, etc.)
+	WAKE_TRK_OFF,					// Not measuring
+	WAKE_TRK_CMD,					// Woken up by a button, waiting for a command
+	WAKE_TRK_MODE					// Waiting for transport to reach requested mode
 };
-
-#define SLEEP_INHIBIT_2HZ	6		// Time for sleep inhibition with 2HZ rate
+#define WAKE_TRK_TIMEOUT	10000	// Latency measurement is dropped after this time (ms)
+#define SPI_REFRESH_CALLS	50		// Number of indicator updates before resending unchanged data (~1 s at 50 Hz)
+#define CAL_SHOW_TIME		30		// Time to show calibration result before normal operation (10 Hz ticks)
 
 void scan_pb_buttons(void);
 void scan_selftest_buttons(void);
+uint8_t scan_calib_buttons(void);
+void calib_start(void);
+void calib_finish(void);
 void process_user(void);
 void UART_dump_settings(uint8_t in_ttr_settings, uint8_t in_srv_settings);
+void UART_dump_buttons(uint8_t in_buttons);
+void UART_dump_log_stats(void);
+void UART_dump_usage_stats(void);
+void UART_dump_crc_bench(void);
+void UART_dump_power_budget(void);
+void UART_dump_idle_policy(void);
+void UART_send_telemetry(void);
 int main(void);
 
 #endif /* AVRTAPE_H_ */
\ No newline at end of file
@@ -1,7 +1,8 @@
-﻿#include "calc_CRC.h"
+﻿#include "calc_crc.h"
 
+#if (CRC8_ENGINE==CRC8_ENG_LUT256)||defined(CRC_ALL_ENGINES)
 #ifdef CRC8_ROM_DATA
-static const uint8_t lut_crc8[256] PROGMEM = {
+static const uint8_t lut_crc8[CRC8_LUT256_SIZE] PROGMEM = {
 	0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
 	0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
 	0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
@@ -36,7 +37,7 @@ static const uint8_t lut_crc8[256] PROGMEM = {
 	0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
 };
 #else
-static const uint8_t lut_crc8[256] = {
+static const uint8_t lut_crc8[CRC8_LUT256_SIZE] = {
 	0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
 	0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
 	0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
@@ -71,13 +72,38 @@ static const uint8_t lut_crc8[256] = {
 	0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
 };
 #endif
+#endif
+
+#if (CRC8_ENGINE==CRC8_ENG_LUT16)||defined(CRC_ALL_ENGINES)
+// CRC of a nibble (same as the first 16 entries of [lut_crc8]).
+#ifdef CRC8_ROM_DATA
+static const uint8_t lut_crc8_nibble[CRC8_LUT16_SIZE] PROGMEM = {
+#else
+static const uint8_t lut_crc8_nibble[CRC8_LUT16_SIZE] = {
+#endif
+	0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+	0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E
+};
+#endif
+
+#ifdef EN_CRC16
+#ifdef CRC8_ROM_DATA
+static const uint16_t lut_crc16_nibble[CRC16_LUT_SIZE/2] PROGMEM = {
+#else
+static const uint16_t lut_crc16_nibble[CRC16_LUT_SIZE/2] = {
+#endif
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+#endif /* EN_CRC16 */
 
 uint8_t CRC8_init(void)
 {
 	return 0xFF;
 }
 
-uint8_t CRC8_calc(uint8_t CRC_data, uint8_t in_data)
+#if (CRC8_ENGINE==CRC8_ENG_LUT256)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_lut256(uint8_t CRC_data, uint8_t in_data)
 {
 	uint8_t offset;
 	offset=CRC_data^in_data;
@@ -87,3 +113,72 @@ uint8_t CRC8_calc(uint8_t CRC_data, uint8_t in_data)
 	return lut_crc8[offset];
 #endif
 }
+#endif
+
+#if (CRC8_ENGINE==CRC8_ENG_LUT16)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_lut16(uint8_t CRC_data, uint8_t in_data)
+{
+	uint8_t offset;
+	CRC_data^=in_data;
+	// High nibble.
+	offset=(CRC_data>>4);
+#ifdef CRC8_ROM_DATA
+	CRC_data=(CRC_data<<4)^pgm_read_byte_near(lut_crc8_nibble+offset);
+#else
+	CRC_data=(CRC_data<<4)^lut_crc8_nibble[offset];
+#endif
+	// Low nibble.
+	offset=(CRC_data>>4);
+#ifdef CRC8_ROM_DATA
+	return (CRC_data<<4)^pgm_read_byte_near(lut_crc8_nibble+offset);
+#else
+	return (CRC_data<<4)^lut_crc8_nibble[offset];
+#endif
+}
+#endif
+
+#if (CRC8_ENGINE==CRC8_ENG_BITWISE)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_bitwise(uint8_t CRC_data, uint8_t in_data)
+{
+	uint8_t cycle;
+	CRC_data^=in_data;
+	for(cycle=0;cycle<8;cycle++)
+	{
+		if((CRC_data&0x80)!=0)
+		{
+			CRC_data=(CRC_data<<1)^CRC8_POLY;
+		}
+		else
+		{
+			CRC_data=(CRC_data<<1);
+		}
+	}
+	return CRC_data;
+}
+#endif
+
+#ifdef EN_CRC16
+uint16_t CRC16_init(void)
+{
+	return 0xFFFF;
+}
+
+uint16_t CRC16_calc(uint16_t CRC_data, uint8_t in_data)
+{
+	uint8_t offset;
+	// High nibble.
+	offset=(uint8_t)(CRC_data>>12)^(in_data>>4);
+#ifdef CRC8_ROM_DATA
+	CRC_data=(CRC_data<<4)^pgm_read_word_near(lut_crc16_nibble+offset);
+#else
+	CRC_data=(CRC_data<<4)^lut_crc16_nibble[offset];
+#endif
+	// Low nibble.
+	offset=(uint8_t)(CRC_data>>12)^(in_data&0x0F);
+#ifdef CRC8_ROM_DATA
+	return (CRC_data<<4)^pgm_read_word_near(lut_crc16_nibble+offset);
+#else
+	return (CRC_data<<4)^lut_crc16_nibble[offset];
+#endif
+}
+#endif /* EN_CRC16 */
@@ -18,17 +18,80 @@ limitations under the License.
 Created: 2010-09-07
 
 Part of the [AVRTapeControl] project.
-CRC8 table-based calculation module for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+CRC8 (and optional CRC16) calculation module for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+
+CRC-8 can be calculated by one of the interchangeable engines, selected by [CRC8_ENGINE] at compile time.
+All engines produce the same result (polynomial [CRC8_POLY], MSB first), only speed and size differ:
+	- [CRC8_ENG_LUT256]: one look-up per byte in 256-byte table, fastest;
+	- [CRC8_ENG_LUT16]: two look-ups per byte in 16-byte table, ~2x slower;
+	- [CRC8_ENG_BITWISE]: bit-by-bit shifting without a table, smallest and slowest.
+Tables are put in ROM or RAM by [CRC8_ROM_DATA]. If [CRC8_ENGINE] is not set, 256-byte table is used
+on MCUs with 16 kB of ROM or more and 16-byte table on smaller ones (ATmega48/88).
+CRC-16/CCITT ([CRC16_POLY], 16-entry table) is compiled if [EN_CRC16] is defined, for data blocks too long for CRC-8.
+Measured cycles per byte for each engine can be printed at start-up with [CRC_BENCH] (see README).
 
 **************************************************************************************************************************************************************/
 
 #ifndef CALC_CRC_H_
 #define CALC_CRC_H_
 
+#include <avr/io.h>
 #include <avr/pgmspace.h>
 #include "config.h"
 
+#define CRC8_POLY			0x31	// CRC-8 polynomial (x^8+x^5+x^4+1)
+#define CRC16_POLY			0x1021	// CRC-16/CCITT polynomial (x^16+x^12+x^5+1)
+
+// CRC-8 engines for [CRC8_ENGINE].
+enum
+{
+	CRC8_ENG_LUT256,		// 256-byte look-up table
+	CRC8_ENG_LUT16,			// 16-byte look-up table (nibble at a time)
+	CRC8_ENG_BITWISE,		// No table (bit at a time)
+	CRC8_ENG_MAX
+};
+
+#define CRC8_LUT256_SIZE	256		// Table size for [CRC8_ENG_LUT256] (bytes)
+#define CRC8_LUT16_SIZE		16		// Table size for [CRC8_ENG_LUT16] (bytes)
+#define CRC16_LUT_SIZE		32		// Table size for CRC-16 (bytes)
+
+#ifndef CRC8_ENGINE
+	#if FLASHEND<0x3FFF
+		#define CRC8_ENGINE		CRC8_ENG_LUT16		// Save ROM on ATmega48/88
+	#else
+		#define CRC8_ENGINE		CRC8_ENG_LUT256
+	#endif
+#endif
+
+#ifdef CRC_BENCH
+	#define CRC_ALL_ENGINES			// Compile all engines for comparison
+	#define EN_CRC16
+#endif /* CRC_BENCH */
+
+// [CRC8_calc()] calls selected engine directly.
+#if CRC8_ENGINE==CRC8_ENG_LUT256
+	#define CRC8_calc		CRC8_calc_lut256
+#elif CRC8_ENGINE==CRC8_ENG_LUT16
+	#define CRC8_calc		CRC8_calc_lut16
+#elif CRC8_ENGINE==CRC8_ENG_BITWISE
+	#define CRC8_calc		CRC8_calc_bitwise
+#else
+	#error Unknown CRC8_ENGINE
+#endif
+
 uint8_t CRC8_init(void);
-uint8_t CRC8_calc(uint8_t, uint8_t);
+#if (CRC8_ENGINE==CRC8_ENG_LUT256)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_lut256(uint8_t, uint8_t);
+#endif
+#if (CRC8_ENGINE==CRC8_ENG_LUT16)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_lut16(uint8_t, uint8_t);
+#endif
+#if (CRC8_ENGINE==CRC8_ENG_BITWISE)||defined(CRC_ALL_ENGINES)
+uint8_t CRC8_calc_bitwise(uint8_t, uint8_t);
+#endif
+#ifdef EN_CRC16
+uint16_t CRC16_init(void);
+uint16_t CRC16_calc(uint16_t, uint8_t);
+#endif /* EN_CRC16 */
 
 #endif /* CALC_CRC_H_ */
@@ -0,0 +1,82 @@
+﻿#include "cmd_queue.h"
+
+static uint8_t u8a_cmdq_modes[CMDQ_SIZE];		// Pending commands ([USR_MODE_xxx])
+static uint8_t u8_cmdq_head=0;					// Index of the oldest pending command
+static uint8_t u8_cmdq_count=0;					// Number of pending commands
+
+//-------------------------------------- Cancel all pending commands.
+void CMDQ_clear(void)
+{
+	u8_cmdq_head = 0;
+	u8_cmdq_count = 0;
+}
+
+//-------------------------------------- Add user request to the queue.
+// [in_mode] - requested mode ([USR_MODE_xxx]);
+// [in_current] - mode that transport is working on now;
+// Returns result of merging ([CMDQ_RES_xxx]).
+uint8_t CMDQ_push(uint8_t in_mode, uint8_t in_current)
+{
+	uint8_t u8_idx;
+	if(in_mode==USR_MODE_STOP)
+	{
+		// STOP has the highest priority, nothing should be done after it.
+		CMDQ_clear();
+		return CMDQ_RES_CANCEL;
+	}
+	if(in_mode==CMDQ_get_last(in_current))
+	{
+		// Same mode is already requested.
+		return CMDQ_RES_DROPPED;
+	}
+	if(u8_cmdq_count>=CMDQ_SIZE)
+	{
+		// No room, the latest request wins.
+		u8_idx = u8_cmdq_head+CMDQ_SIZE-1;
+		if(u8_idx>=CMDQ_SIZE) u8_idx -= CMDQ_SIZE;
+		u8a_cmdq_modes[u8_idx] = in_mode;
+		return CMDQ_RES_REPLACED;
+	}
+	u8_idx = u8_cmdq_head+u8_cmdq_count;
+	if(u8_idx>=CMDQ_SIZE) u8_idx -= CMDQ_SIZE;
+	u8a_cmdq_modes[u8_idx] = in_mode;
+	u8_cmdq_count++;
+	return CMDQ_RES_QUEUED;
+}
+
+//-------------------------------------- Get the oldest pending command and remove it from the queue.
+// Returns [USR_MODE_xxx] (STOP if nothing is pending).
+uint8_t CMDQ_pop(void)
+{
+	uint8_t u8_mode;
+	if(u8_cmdq_count==0)
+	{
+		return USR_MODE_STOP;
+	}
+	u8_mode = u8a_cmdq_modes[u8_cmdq_head];
+	u8_cmdq_head++;
+	if(u8_cmdq_head>=CMDQ_SIZE) u8_cmdq_head = 0;
+	u8_cmdq_count--;
+	return u8_mode;
+}
+
+//-------------------------------------- Get the latest requested mode.
+// New user requests should be evaluated against this mode (not against the mode transport is working on).
+// [in_current] - mode that transport is working on now (returned if nothing is pending);
+uint8_t CMDQ_get_last(uint8_t in_current)
+{
+	uint8_t u8_idx;
+	if(u8_cmdq_count==0)
+	{
+		return in_current;
+	}
+	u8_idx = u8_cmdq_head+u8_cmdq_count-1;
+	if(u8_idx>=CMDQ_SIZE) u8_idx -= CMDQ_SIZE;
+	return u8a_cmdq_modes[u8_idx];
+}
+
+//-------------------------------------- Get number of pending commands.
+uint8_t CMDQ_get_count(void)
+{
+	return u8_cmdq_count;
+}
@@ -0,0 +1,54 @@
+﻿/**************************************************************************************************************************************************************
+cmd_queue.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-08-02
+
+Part of the [AVRTapeControl] project.
+User command queue for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+
+Buffers user-requested modes ([USR_MODE_xxx]) between user input processing and transport state machines,
+so requests made during a mode transition are executed one after another instead of collapsing into the last one.
+Merge rules: STOP cancels all pending commands (and is applied right away by the caller),
+a request equal to the last pending command (or to the current mode if nothing is pending) is dropped,
+if the queue is full the last pending command is replaced.
+
+**************************************************************************************************************************************************************/
+
+#ifndef CMD_QUEUE_H_
+#define CMD_QUEUE_H_
+
+#include <stdint.h>
+#include "common_log.h"
+
+#define CMDQ_SIZE			4			// Maximum number of pending commands
+
+// Results of [CMDQ_push()].
+enum
+{
+	CMDQ_RES_DROPPED,				// Request duplicates the last one, nothing changed
+	CMDQ_RES_QUEUED,				// Request is added to the queue
+	CMDQ_RES_REPLACED,				// Queue is full, the last pending command is replaced
+	CMDQ_RES_CANCEL					// STOP: pending commands are cancelled, caller should stop transport right away
+};
+
+void CMDQ_clear(void);									// Cancel all pending commands
+uint8_t CMDQ_push(uint8_t in_mode, uint8_t in_current);	// Add user request to the queue, returns [CMDQ_RES_xxx]
+uint8_t CMDQ_pop(void);									// Get the oldest pending command (STOP if nothing is pending)
+uint8_t CMDQ_get_last(uint8_t in_current);				// Get the latest requested mode
+uint8_t CMDQ_get_count(void);							// Get number of pending commands
+
+#endif /* CMD_QUEUE_H_ */
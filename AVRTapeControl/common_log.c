@@ -41,3 +41,24 @@ void UART_dump_user_mode(uint8_t in_mode)
 #endif /* UART_TERM */
 }
 
+//-------------------------------------- Print transport state machine debug line.
+// Output format: "MODE|>t%03u<|u%01u}%01u>%01u|0x%02x\n\r" (timer, user mode, transport mode, target mode, switches).
+void UART_dump_mech_state(uint8_t in_timer, uint8_t in_user, uint8_t in_mode, uint8_t in_target, uint8_t in_sws)
+{
+#ifdef UART_TERM
+	UART_begin_line();
+	UART_add_flash_string((uint8_t *)cch_mech_timer);
+	UART_add_dec8(in_timer, 3);
+	UART_add_flash_string((uint8_t *)cch_mech_user);
+	UART_add_dec8(in_user, 1);
+	UART_add_char('}');
+	UART_add_dec8(in_mode, 1);
+	UART_add_char('>');
+	UART_add_dec8(in_target, 1);
+	UART_add_flash_string((uint8_t *)cch_mech_sws);
+	UART_add_hex8(in_sws);
+	UART_add_flash_string((uint8_t *)cch_endl);
+	UART_end_line();
+#endif /* UART_TERM */
+}
+
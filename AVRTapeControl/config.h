@@ -36,20 +36,52 @@ Defines/switches for configuring compile-time options.
 // Data saving into EEPROM
 #define USE_EEPROM					// Enable usage of EEPROM for settings
 #define CRC8_ROM_DATA				// Put CRC table into ROM instead of RAM.
-#define SETTINGS_SIZE		5		// Number of bytes for full [settings_data] union
+//#define CRC8_ENGINE		CRC8_ENG_BITWISE	// Force CRC-8 engine (default depends on ROM size, see [calc_crc.h])
+//#define EN_CRC16					// Compile CRC-16 routines
+#define TIM_PROFILE_SIZE	13		// Number of bytes reserved for mechanism timing profile in settings (fits the largest [PRF_xxx_MAX])
+#define SETTINGS_SIZE		(6+TIM_PROFILE_SIZE)	// Number of bytes for RAM image of settings ([EPS_xxx] in [settings.h])
+#define SET_RECORD_SIZE		29		// Number of bytes for settings container in EEPROM (29 is the maximum for 32-byte segment)
 // Set target size of saving/restoring block for EEPROM driver.
-#define EEPROM_TARGET_SIZE	SETTINGS_SIZE
+#ifndef EEPROM_TARGET_SIZE
+#define EEPROM_TARGET_SIZE	SET_RECORD_SIZE
+#endif
 //#define EN_STAT_EEPROM				// Save usage stats to EEPROM
+#ifdef EN_STAT_EEPROM
+#define EEPROM_AREA_SIZE	512		// EEPROM space for settings records, the rest is used by usage stats journal (see [usage_stats.h])
+#define EEPROM_JOB_BUF_SIZE	32		// EEPROM job buffer (must fit [STAT_REC_SIZE])
+#define STAT_FLUSH_PERIOD	900		// Usage stats flush period while transport is active (seconds)
+#define STAT_FLUSH_GAP		120		// Wear budget: minimum active time between usage stats flushes (seconds), used before going to sleep
+									// journal life = (EEPROM size - [EEPROM_AREA_SIZE]) / 32 * 100k cycles * [STAT_FLUSH_GAP] s of active time (~6 years of non-stop operation)
+#endif /* EN_STAT_EEPROM */
+
+#define EN_FAST_AREV				// Fast auto-reverse for CRP42602Y: start reverse cyclogram as soon as STOP is reached instead of waiting for full transition to STOP
+#define EN_STOP_ANCHOR				// Re-anchor CRP42602Y cyclogram timer by STOP sensor release instead of timing selection marks from the start pulse only
+// Adaptive capstan shutdown timeout with tape loaded, picked from inter-command gap history (see [idle_policy.h]).
+#define EN_IDLE_ADAPT				// Use adaptive timeout instead of fixed [IDLE_CAP_TAPE_IN]
+#define IDLE_ADAPT_MIN		5000	// Shortest allowed timeout (2 ms ticks, 10 s)
+#define IDLE_ADAPT_MAX		IDLE_CAP_TAPE_IN	// Longest allowed timeout (2 ms ticks, 120 s)
+#define IDLE_SPINUP_COST	10000	// Penalty for capstan spin-up, expressed as capstan run time (2 ms ticks, 20 s)
+#define EN_CLK_SCALE				// Slow down CPU core clock while transport is stable and UART is idle (see [PDM_set_clock()])
+#define EN_SLEEP_POLL				// Poll switches by watchdog interrupt during sleep instead of waking up on their pin change
+// Power domain manager estimates for current budget (10 uA units, depend on hardware, see [power_dom.h]).
+#define PDM_CUR_TACHO_EXT	500		// Tachometer sensor supply (photo-interrupter LED)
+#define PDM_CUR_CAPSTAN_EXT	8000	// Capstan motor with tape loaded
+#define PDM_WAKE_TIME		2050	// Wake up from sleep: oscillator start-up (16K CK for Xtal fuses) and poll task (us)
 
 // UART console stuff.
 #define UART_IN_LEN			8		// UART receiving buffer length
 #define UART_OUT_LEN		512		// UART transmitting buffer length
 #define UART_SPEED			UART_BAUD_500k
 //#define UART_TERM					// Enable UART debug output (slows down execution and takes up ROM and RAM).
+#define UART_LOG_FLOOR		LOG_LVL_DEBUG	// Log messages below this level are removed from firmware
+#define UART_LOG_DEFAULT	0x20	// Log configuration if not set in EEPROM (all subsystems, INFO and above, see [LOG_CFG_xxx] in [drv_uart.h])
+//#define UART_TELEMETRY				// Output binary telemetry frames (requires [UART_TERM], frame format in [common_log.h])
+#define TLM_RATE_DIV		1		// Telemetry rate divider from 50 Hz (1 = 50 Hz, 5 = 10 Hz, etc.)
+//#define CRC_BENCH					// Measure CRC engines speed at start-up (requires [UART_TERM], uses Timer 1)
 
 // Default feature sets (described in [common_log.h]).
 #define TTR_FEA_DEFAULT				(TTR_FEA_REV_ENABLE)	// Default transport feature settings
-#define SRV_FEA_DEFAULT				(/*SRV_FEA_TWO_PLAYS|*//*SRV_FEA_ONE2REC|*/SRV_FEA_PB_AUTOREV/*|SRV_FEA_PB_LOOP|SRV_FEA_PBF2REW|SRV_FEA_FF2REW*/)		// Default service feature settings
+#define SRV_FEA_DEFAULT				(/*SRV_FEA_TWO_PLAYS|*//*SRV_FEA_ONE2REC|*/SRV_FEA_PB_AUTOREV/*|SRV_FEA_PB_LOOP|SRV_FEA_PBF2REW|SRV_FEA_FF2REW|SRV_FEA_PRESPIN*/)		// Default service feature settings
 
 //#define DBG_ACT_MON					// Output mode transition activity instead of "record" and "mute" outputs.
 
@@ -1,7 +1,30 @@
-﻿#include "drv_EEPROM.h"
+﻿#include "drv_eeprom.h"
 
 static uint16_t u16_current_address=0;
 
+// Phases of asynchronous job.
+enum
+{
+	EEP_PH_IDLE,		// No job in progress
+	EEP_PH_WRITE,		// Writing shadow image into current segment
+	EEP_PH_COPY,		// Writing shadow image into next segment
+	EEP_PH_CLEAR,		// Erasing current segment after copy
+	EEP_PH_RAW			// Writing raw block outside of segment area
+};
+
+static uint8_t u8a_job_shadow[EEPROM_JOB_BUF_SIZE];	// Full segment image (or raw block) for the job (not inverted, CRC included)
+static volatile uint8_t u8_job_flags=0;				// Queued jobs and result ([EEPROM_JOB_xxx])
+static volatile uint8_t u8_job_phase=EEP_PH_IDLE;	// Current phase of the job
+static uint16_t u16_job_address=0;					// Base address for [EEP_PH_WRITE], [EEP_PH_COPY] and [EEP_PH_RAW]
+#ifdef EEP_16BIT_ADDR
+static uint16_t job_index=0;						// Current byte offset within the segment
+static uint16_t job_length=0;						// Number of bytes to process in current phase
+#else
+static uint8_t job_index=0;							// Current byte offset within the segment
+static uint8_t job_length=0;						// Number of bytes to process in current phase
+#endif	/*EEP_16BIT_ADDR*/
+static uint8_t u8_job_ops=0;						// Erase/write operations done on current byte
+
 // Erase a byte in EEPROM.
 // This function turns off interrupts globally and turns them back on by itself!
 // [u16_addr] - base EEPROM address;
@@ -159,12 +182,16 @@ uint8_t EEPROM_calc_CRC(void)
 	return CRC_data;
 }
 
-// Search a data segment in EEPROM and read it back. 
+// Search the newest data segment in EEPROM and read it back.
 // Also this function sets up local [u16_current_address] that holds base address for all EEPROM operations via [EEPROM_read_segment()] and [EEPROM_write_segment()] funtions.
+// Only marker and sequence number are read from each segment, full CRC check is done only for the newest record.
+// If the newest record is corrupted (interrupted write), previous one is checked, up to [EEPROM_SEGMENT_COUNT] attempts.
+// Sequence numbers are compared with serial number arithmetic (8-bit wrap-around),
+// records with equal sequence numbers (copies made by segment move) are ordered by address.
 // This function is not interrupt-sensitive.
 // [data] - pointer to an array where data will be read to if it will be found successfully;
 // [start] - offset (in bytes) from start of the detected data in EEPROM from which data will be read into [data] starting from 0;
-// [end] - offset (in bytes) from start of the detected data in EEPROM up to which data will be read into [data];
+// [end] - offset (in bytes) from start of the detected data in EEPROM up to which (inclusive) data will be read into [data];
 // Returns [EEPROM_NO_DATA] if no marked segment was found in EEPROM or data is corrupted.
 // Returns [EEPROM_OK] if data segment was successfully found and read into [data].
 #ifdef EEP_16BIT_ADDR
@@ -173,52 +200,129 @@ uint8_t EEPROM_search_data(uint8_t *data, uint16_t start, uint16_t end)
 uint8_t EEPROM_search_data(uint8_t *data, uint8_t start, uint8_t end)
 #endif	/*EEP_16BIT_ADDR*/
 {
-	uint8_t u8_answer, u8_data_found;
+	uint8_t u8_answer, u8_data_found, u8_seq, u8_best_seq, u8_limit_seq, u8_limited, u8_attempt;
 #ifdef EEP_16BIT_ADDR
 	uint16_t cycle, data_index;
 #else
 	uint8_t cycle, data_index;
 #endif
+	uint16_t u16_offset, u16_best, u16_limit;
+	u8_limit_seq=0;
+	u16_limit=0;
+	u8_limited=0;
+	for(u8_attempt=0;u8_attempt<EEPROM_SEGMENT_COUNT;u8_attempt++)
+	{
+		// Find the newest marked segment (older than the last rejected one).
+		u16_best=EEPROM_AREA_SIZE;
+		u8_best_seq=0;
+		u16_offset=0;
+		do
+		{
+			// Try to read first symbol (detect marker).
+			EEPROM_read_byte(&u16_offset, 0, &u8_data_found);
+			if(u8_data_found==EEPROM_START_MARKER)
+			{
+				EEPROM_read_byte(&u16_offset, EEPROM_SEQ_POSITION, &u8_seq);
+				if((u8_limited==0)||((int8_t)(u8_limit_seq-u8_seq)>0)||((u8_seq==u8_limit_seq)&&(u16_offset<u16_limit)))
+				{
+					if((u16_best==EEPROM_AREA_SIZE)||((int8_t)(u8_seq-u8_best_seq)>0)||((u8_seq==u8_best_seq)&&(u16_offset>u16_best)))
+					{
+						u16_best=u16_offset;
+						u8_best_seq=u8_seq;
+					}
+				}
+			}
+			// Go to the next segment.
+			u16_offset+=EEPROM_STORE_SIZE;
+		}
+		while(u16_offset<=(EEPROM_AREA_SIZE-EEPROM_STORE_SIZE));
+		if(u16_best==EEPROM_AREA_SIZE)
+		{
+			// No more candidates.
+			break;
+		}
+		// Save new address.
+		u16_current_address=u16_best;
+		// Calculate CRC for the detected data.
+		u8_answer=EEPROM_calc_CRC();
+		// Read CRC byte from EEPROM.
+		EEPROM_read_byte(&u16_current_address, EEPROM_CRC_POSITION, &u8_data_found);
+		// Check CRC match.
+		if(u8_data_found==u8_answer)
+		{
+			// Read settings.
+			data_index=0;
+			cycle=start;
+			while(cycle<=end)
+			{
+				EEPROM_read_byte(&u16_current_address, cycle, data+data_index);
+				data_index++;
+				cycle++;
+			}
+			return EEPROM_OK;
+		}
+		// CRC mismatch, try previous record.
+		u8_limit_seq=u8_best_seq;
+		u16_limit=u16_best;
+		u8_limited=1;
+	}
+	// Run out of EEPROM and no valid data found.
+	// Reset base address.
+	u16_current_address=0;
+	// [data] is not affected.
+	return EEPROM_NO_DATA;
+}
+
+// Search a data segment saved with another segment size (by older firmware without sequence numbers) and read it back.
+// Segments of [stride] bytes are checked through all EEPROM: marker in the first byte, CRC-8 of the rest in the last byte.
+// On success [u16_current_address] is set to the first segment after the found data,
+// so new data written via [EEPROM_write_segment()] does not overwrite old data until it is saved.
+// This function is not interrupt-sensitive.
+// [data] - pointer to an array where data will be read to if it will be found successfully;
+// [stride] - segment size of older firmware in bytes;
+// [count] - how many bytes to read into [data] from the start of the found segment;
+// Returns [EEPROM_NO_DATA] if no valid segment was found.
+// Returns [EEPROM_OK] if data segment was successfully found and read into [data].
+uint8_t EEPROM_search_legacy(uint8_t *data, uint8_t stride, uint8_t count)
+{
+	uint8_t u8_answer, u8_data_found, cycle;
 	uint16_t u16_offset;
-	// Reset to default address.
-	u16_current_address=0x0;
 	u16_offset=0;
-	// Search marker through all segments of EEPROM.
 	do
 	{
 		// Try to read first symbol (detect marker).
 		EEPROM_read_byte(&u16_offset, 0, &u8_data_found);
 		if(u8_data_found==EEPROM_START_MARKER)
 		{
-			// Save new address.
-			u16_current_address=u16_offset;
-			// Calculate CRC for the detected data.
-			u8_answer=EEPROM_calc_CRC();
+			// Calculate CRC for the detected data (all bytes except the last one).
+			u8_answer=CRC8_init();
+			for(cycle=0;cycle<(stride-1);cycle++)
+			{
+				EEPROM_read_byte(&u16_offset, cycle, &u8_data_found);
+				u8_answer=CRC8_calc(u8_answer, u8_data_found);
+			}
 			// Read CRC byte from EEPROM.
-			EEPROM_read_byte(&u16_current_address, EEPROM_CRC_POSITION, &u8_data_found);
-			// Check CRC match.
+			EEPROM_read_byte(&u16_offset, (stride-1), &u8_data_found);
 			if(u8_data_found==u8_answer)
 			{
-				// Read settings.
-				data_index=0;
-				cycle=start;
-				while(cycle<=end)
+				for(cycle=0;cycle<count;cycle++)
+				{
+					EEPROM_read_byte(&u16_offset, cycle, data+cycle);
+				}
+				// Select the first segment that does not hold any of old data.
+				u16_current_address=u16_offset+stride+EEPROM_STORE_SIZE-1;
+				u16_current_address-=(u16_current_address%EEPROM_STORE_SIZE);
+				if(u16_current_address>(EEPROM_AREA_SIZE-EEPROM_STORE_SIZE))
 				{
-					EEPROM_read_byte(&u16_current_address, cycle, data+data_index);
-					data_index++;
-					cycle++;
+					u16_current_address=0;
 				}
 				return EEPROM_OK;
 			}
-			// CRC mismatch.
 		}
 		// Go to the next segment.
-		u16_offset+=EEPROM_STORE_SIZE;
+		u16_offset+=stride;
 	}
-	while(u16_offset<=(EEPROM_ROM_SIZE-EEPROM_STORE_SIZE));
-	// Run out of EEPROM and no valid data found.
-	// Reset base address.
-	u16_current_address=0;
+	while(u16_offset<=(EEPROM_ROM_SIZE-stride));
 	// [data] is not affected.
 	return EEPROM_NO_DATA;
 }
@@ -385,10 +489,10 @@ void EEPROM_goto_next_segment(void)
 #endif
 	uint8_t read_data, tmp_data;
 	// Check current EEPROM position.
-	temp_addr=EEPROM_ROM_SIZE-u16_current_address;
+	temp_addr=EEPROM_AREA_SIZE-u16_current_address;
 	if(temp_addr<=EEPROM_STORE_SIZE)
 	{
-		// No place for next segment before end of EEPROM space.
+		// No place for next segment before end of segment area.
 		// Reset address.
 		temp_addr=0;
 	}
@@ -461,3 +565,275 @@ void EEPROM_goto_next_segment(void)
 	// Set new internal data address.
 	u16_current_address=temp_addr;
 }
+
+// Calculate address of the next segment after [u16_current_address].
+static uint16_t EEPROM_next_address(void)
+{
+	if((EEPROM_AREA_SIZE-u16_current_address)<=EEPROM_STORE_SIZE)
+	{
+		// No place for next segment before end of segment area.
+		return 0;
+	}
+	return (u16_current_address+EEPROM_STORE_SIZE);
+}
+
+// Load current segment into job shadow image.
+static void EEPROM_load_shadow(void)
+{
+#ifdef EEP_16BIT_ADDR
+	uint16_t cycle;
+#else
+	uint8_t cycle;
+#endif	/*EEP_16BIT_ADDR*/
+	for(cycle=0;cycle<EEPROM_STORE_SIZE;cycle++)
+	{
+		EEPROM_read_byte(&u16_current_address, cycle, u8a_job_shadow+cycle);
+	}
+}
+
+// Start the phase of asynchronous job from the first byte.
+static void EEPROM_start_phase(uint8_t new_phase, uint16_t u16_addr)
+{
+	u8_job_phase=new_phase;
+	u16_job_address=u16_addr;
+	job_index=0;
+	job_length=EEPROM_STORE_SIZE;
+	u8_job_ops=0;
+}
+
+// Build job shadow image: current segment with new data and new sequence number, CRC is pre-calculated.
+#ifdef EEP_16BIT_ADDR
+static void EEPROM_build_shadow(const uint8_t *data, uint16_t offset, uint16_t count)
+#else
+static void EEPROM_build_shadow(const uint8_t *data, uint8_t offset, uint8_t count)
+#endif	/*EEP_16BIT_ADDR*/
+{
+#ifdef EEP_16BIT_ADDR
+	uint16_t cycle;
+#else
+	uint8_t cycle;
+#endif	/*EEP_16BIT_ADDR*/
+	uint8_t CRC_data;
+	EEPROM_load_shadow();
+	for(cycle=0;cycle<count;cycle++)
+	{
+		u8a_job_shadow[offset+cycle]=data[cycle];
+	}
+	u8a_job_shadow[EEPROM_SEQ_POSITION]++;
+	CRC_data=CRC8_init();
+	for(cycle=0;cycle<EEPROM_CRC_POSITION;cycle++)
+	{
+		CRC_data=CRC8_calc(CRC_data, u8a_job_shadow[cycle]);
+	}
+	u8a_job_shadow[EEPROM_CRC_POSITION]=CRC_data;
+}
+
+// Queue append of updated record into the next segment after [u16_current_address].
+// Record is built from current segment with new data and incremented sequence number,
+// previous record is not erased and stays valid until the new one is fully written (CRC last).
+// After the job is finished [u16_current_address] points to the new record.
+// Data is copied into internal buffer, [data] can be changed right after the call.
+// [data] - pointer to the data that will be written into EEPROM;
+// [offset] - offset from base address in EEPROM in bytes;
+// [count] - how many bytes to write;
+// Returns [EEPROM_BUSY] if previous job is not finished yet or segment bounds are exceeded.
+// Returns [EEPROM_OK] if the job is queued.
+#ifdef EEP_16BIT_ADDR
+uint8_t EEPROM_queue_append(const uint8_t *data, uint16_t offset, uint16_t count)
+#else
+uint8_t EEPROM_queue_append(const uint8_t *data, uint8_t offset, uint8_t count)
+#endif	/*EEP_16BIT_ADDR*/
+{
+	if((offset+count)>EEPROM_SEQ_POSITION) return EEPROM_BUSY;
+	if(EEPROM_is_busy()!=0) return EEPROM_BUSY;
+	// Build new record.
+	EEPROM_build_shadow(data, offset, count);
+	// Start the job.
+	cli();
+	u8_job_flags=EEPROM_JOB_WRITE;
+	EEPROM_start_phase(EEP_PH_WRITE, EEPROM_next_address());
+	EEP_RDY_INT_EN;
+	sei();
+	return EEPROM_OK;
+}
+
+// Queue move of all data to next segment (wear leveling).
+// If segment write is queued, move starts after it is finished.
+// Procedure is fail-safe in the same way as [EEPROM_goto_next_segment()].
+// Returns [EEPROM_BUSY] if move is already queued.
+// Returns [EEPROM_OK] if the job is queued.
+uint8_t EEPROM_queue_next_segment(void)
+{
+	if((u8_job_flags&(EEPROM_JOB_MOVE|EEPROM_JOB_RAW))!=0) return EEPROM_BUSY;
+	cli();
+	if((u8_job_flags&EEPROM_JOB_WRITE)!=0)
+	{
+		// Shadow image already holds new data, move will be started after write.
+		u8_job_flags|=EEPROM_JOB_MOVE;
+		sei();
+		return EEPROM_OK;
+	}
+	sei();
+	// No jobs in progress, copy current data.
+	EEPROM_load_shadow();
+	cli();
+	u8_job_flags=EEPROM_JOB_MOVE;
+	EEPROM_start_phase(EEP_PH_COPY, EEPROM_next_address());
+	EEP_RDY_INT_EN;
+	sei();
+	return EEPROM_OK;
+}
+
+// Queue write of a raw block of data at absolute EEPROM address (outside of segment area).
+// Data is copied into internal buffer, [data] can be changed right after the call.
+// Bytes are written in order, so the last byte of the block (CRC, for example) is written last.
+// Result is not reported by [EEPROM_get_job_result()], block integrity has to be checked on read.
+// [u16_addr] - EEPROM address of the first byte;
+// [data] - pointer to the data that will be written into EEPROM;
+// [count] - how many bytes to write (up to [EEPROM_JOB_BUF_SIZE]);
+// Returns [EEPROM_BUSY] if previous job is not finished yet or block does not fit.
+// Returns [EEPROM_OK] if the job is queued.
+#ifdef EEP_16BIT_ADDR
+uint8_t EEPROM_queue_raw(uint16_t u16_addr, const uint8_t *data, uint16_t count)
+#else
+uint8_t EEPROM_queue_raw(uint16_t u16_addr, const uint8_t *data, uint8_t count)
+#endif	/*EEP_16BIT_ADDR*/
+{
+#ifdef EEP_16BIT_ADDR
+	uint16_t cycle;
+#else
+	uint8_t cycle;
+#endif	/*EEP_16BIT_ADDR*/
+	if(count>EEPROM_JOB_BUF_SIZE) return EEPROM_BUSY;
+	if((u16_addr+count)>EEPROM_ROM_SIZE) return EEPROM_BUSY;
+	if(EEPROM_is_busy()!=0) return EEPROM_BUSY;
+	for(cycle=0;cycle<count;cycle++)
+	{
+		u8a_job_shadow[cycle]=data[cycle];
+	}
+	// Start the job.
+	cli();
+	// Keep unread result of the previous segment job.
+	u8_job_flags=(u8_job_flags&(EEPROM_JOB_DONE|EEPROM_JOB_FAIL))|EEPROM_JOB_RAW;
+	EEPROM_start_phase(EEP_PH_RAW, u16_addr);
+	job_length=count;
+	EEP_RDY_INT_EN;
+	sei();
+	return EEPROM_OK;
+}
+
+// Perform one step of asynchronous job.
+// Must be called from EEPROM ready interrupt ([EEP_RDY_INT]), starts no more than one erase or write per call.
+// Bytes that already hold required data are skipped without waiting.
+void EEPROM_job_step(void)
+{
+	uint8_t read_data, target_data;
+	const uint16_t *p_addr;
+	while(1)
+	{
+		if(job_index>=job_length)
+		{
+			// Phase finished, select next one.
+			if(u8_job_phase==EEP_PH_WRITE)
+			{
+				// Switch to written record (if it was appended).
+				u16_current_address=u16_job_address;
+				u8_job_flags&=~EEPROM_JOB_WRITE;
+				if((u8_job_flags&EEPROM_JOB_MOVE)!=0)
+				{
+					EEPROM_start_phase(EEP_PH_COPY, EEPROM_next_address());
+					continue;
+				}
+			}
+			else if(u8_job_phase==EEP_PH_COPY)
+			{
+				if(u16_job_address!=u16_current_address)
+				{
+					// Data is safe in the next segment, old one can be erased.
+					EEPROM_start_phase(EEP_PH_CLEAR, u16_job_address);
+					continue;
+				}
+				// Only one segment fits in EEPROM, nothing to erase.
+				u8_job_flags&=~EEPROM_JOB_MOVE;
+			}
+			else if(u8_job_phase==EEP_PH_CLEAR)
+			{
+				// Set new internal data address.
+				u16_current_address=u16_job_address;
+				u8_job_flags&=~EEPROM_JOB_MOVE;
+			}
+			else if(u8_job_phase==EEP_PH_RAW)
+			{
+				// Raw block is written, nothing to report.
+				u8_job_flags&=~EEPROM_JOB_RAW;
+				u8_job_phase=EEP_PH_IDLE;
+				EEP_RDY_INT_DIS;
+				return;
+			}
+			// All done.
+			u8_job_phase=EEP_PH_IDLE;
+			u8_job_flags|=EEPROM_JOB_DONE;
+		}
+		if(u8_job_phase==EEP_PH_IDLE)
+		{
+			EEP_RDY_INT_DIS;
+			return;
+		}
+		// Select address and data for current phase.
+		if(u8_job_phase==EEP_PH_CLEAR)
+		{
+			p_addr=&u16_current_address;
+			target_data=EEPROM_ERASED_DATA;
+		}
+		else
+		{
+			p_addr=&u16_job_address;
+			target_data=u8a_job_shadow[job_index];
+		}
+		// Read current byte (trying do decide, do we need to update it at all).
+		EEPROM_read_byte(p_addr, job_index, &read_data);
+		if((read_data==target_data)||(u8_job_ops>=EEPROM_JOB_MAX_OPS))
+		{
+			if((read_data!=target_data)&&(u8_job_phase!=EEP_PH_RAW))
+			{
+				// Byte is stuck, give up on it.
+				u8_job_flags|=EEPROM_JOB_FAIL;
+			}
+			job_index++;
+			u8_job_ops=0;
+			continue;
+		}
+		u8_job_ops++;
+#ifndef EEP_NO_ERASE
+		if(read_data!=EEPROM_ERASED_DATA)
+		{
+			// Erase the byte, write (if needed) will be done on the next interrupt.
+			EEPROM_erase_byte_intfree(p_addr, job_index);
+			return;
+		}
+#endif	/*EEP_NO_ERASE*/
+		// Write the new value.
+		EEPROM_write_byte_intfree(p_addr, job_index, target_data);
+		return;
+	}
+}
+
+// Check if asynchronous job is queued or in progress.
+// Returns non-zero value if EEPROM is busy.
+uint8_t EEPROM_is_busy(void)
+{
+	return (u8_job_flags&(EEPROM_JOB_WRITE|EEPROM_JOB_MOVE|EEPROM_JOB_RAW));
+}
+
+// Get result of asynchronous jobs.
+// [EEPROM_JOB_DONE] and [EEPROM_JOB_FAIL] flags are cleared after the call.
+// Returns [EEPROM_JOB_xxx] flags.
+uint8_t EEPROM_get_job_result(void)
+{
+	uint8_t u8_result;
+	cli();
+	u8_result=u8_job_flags;
+	u8_job_flags&=~(EEPROM_JOB_DONE|EEPROM_JOB_FAIL);
+	sei();
+	return u8_result;
+}
@@ -25,9 +25,17 @@ This driver handles automatic boot-up data search and load via first [EEPROM_STA
 This driver can detect corruption in the data with help of CRC-8 algorithm (at the end of data, CRC calculation functions are in a separate file).
 This driver implements several wear-leveling techniques: moving active segment around all available memory,
 inverting bytes (zeros are more often in data than 0xFF), data-dependent writes and erases.
+Segments are also records of a log: each one holds a sequence number (before CRC), [EEPROM_queue_append()] writes
+updated record into the next segment without erasing the previous one, [EEPROM_search_data()] picks the newest valid record.
+Data saved by older firmware with another segment size can be found with [EEPROM_search_legacy()] to be converted.
 There are two variants of interrupt-sensitive functions: ones with "_intfree" must be used after you turn off all interrupts,
 other functions will deal with interrupts themselves.
 It is NOT RECOMMENDED to use any of the functions of this driver in an interrupt routines.
+Record append and move to the next segment can also be done asynchronously: [EEPROM_queue_append()] and [EEPROM_queue_next_segment()]
+queue a job and return immediately, [EEPROM_job_step()] must be called from EEPROM ready interrupt ([EEP_RDY_INT]) to perform one erase/write per interrupt.
+Other functions of the driver must not be used while [EEPROM_is_busy()] returns non-zero.
+Segments are kept within first [EEPROM_AREA_SIZE] bytes of EEPROM, the rest can be used for other data
+via [EEPROM_queue_raw()] (asynchronous write of a block at absolute address) and [EEPROM_read_byte()].
 
 Part of the [AVRTapeControl] project.
 Supported MCUs:	ATmega32(A), ATmega88(A/PA), ATmega168(A/PA), ATmega328(P).
@@ -40,49 +48,75 @@ Supported MCUs:	ATmega32(A), ATmega88(A/PA), ATmega168(A/PA), ATmega328(P).
 #include <avr/interrupt.h>
 #include <avr/wdt.h>
 #include "config.h"		// Contains [EEPROM_TARGET_SIZE]
-#include "calc_CRC.h"	// Contains CRC-8 calculation routines
+#include "calc_crc.h"	// Contains CRC-8 calculation routines
 
 // AVR EEPROM size (bytes)
 #define EEPROM_ROM_SIZE		(E2END+1)
+// EEPROM space for data segments (bytes from the start of EEPROM).
+#ifndef EEPROM_AREA_SIZE
+	#define EEPROM_AREA_SIZE	EEPROM_ROM_SIZE
+#elif EEPROM_AREA_SIZE>EEPROM_ROM_SIZE
+	#error Segment area is larger than EEPROM! (EEPROM_AREA_SIZE)
+#endif
 
-// Total size of data to be stored in EEPROM.
+// Total size of data to be stored in EEPROM (two more bytes are reserved for sequence number and CRC).
 #ifndef EEPROM_TARGET_SIZE
 	#error You must set EEPROM target size! (EEPROM_TARGET_SIZE)
-#elif EEPROM_TARGET_SIZE>1023
+#elif EEPROM_TARGET_SIZE>1021
 	#define EEPROM_STORE_SIZE	2048
 	#define EEP_16BIT_ADDR		1
-#elif EEPROM_TARGET_SIZE>511
+#elif EEPROM_TARGET_SIZE>509
 	#define EEPROM_STORE_SIZE	1024
 	#define EEP_16BIT_ADDR		1
-#elif EEPROM_TARGET_SIZE>255
+#elif EEPROM_TARGET_SIZE>253
 	#define EEPROM_STORE_SIZE	512
 	#define EEP_16BIT_ADDR		1
-#elif EEPROM_TARGET_SIZE>127
+#elif EEPROM_TARGET_SIZE>125
 	#define EEPROM_STORE_SIZE	256
 	#define EEP_16BIT_ADDR		1
-#elif EEPROM_TARGET_SIZE>63
+#elif EEPROM_TARGET_SIZE>61
 	#define EEPROM_STORE_SIZE 	128
 	#undef EEP_16BIT_ADDR
-#elif EEPROM_TARGET_SIZE>31
+#elif EEPROM_TARGET_SIZE>29
 	#define EEPROM_STORE_SIZE	64
 	#undef EEP_16BIT_ADDR
-#elif EEPROM_TARGET_SIZE>15
+#elif EEPROM_TARGET_SIZE>13
 	#define EEPROM_STORE_SIZE	32
 	#undef EEP_16BIT_ADDR
 #else
 	#define EEPROM_STORE_SIZE	16
 	#undef EEP_16BIT_ADDR
 #endif
-#if EEPROM_STORE_SIZE>EEPROM_ROM_SIZE
+#if EEPROM_STORE_SIZE>EEPROM_AREA_SIZE
 	#error Not enough EEPROM in the device!
 #endif
+// Size of the job buffer (maximum size of a block for [EEPROM_queue_raw()]).
+#ifndef EEPROM_JOB_BUF_SIZE
+	#define EEPROM_JOB_BUF_SIZE	EEPROM_STORE_SIZE
+#elif EEPROM_JOB_BUF_SIZE<EEPROM_STORE_SIZE
+	#error Job buffer can not be smaller than segment! (EEPROM_JOB_BUF_SIZE)
+#endif
 
 #define EEPROM_START_MARKER		0xA5		// Marker byte (first byte for search).
+#define EEPROM_SEQ_POSITION		(EEPROM_STORE_SIZE-2)	// Position (offset from the start) of the record sequence number.
 #define EEPROM_CRC_POSITION		(EEPROM_STORE_SIZE-1)	// Position (offset from the start) of the CRC byte.
+#define EEPROM_SEGMENT_COUNT	(EEPROM_AREA_SIZE/EEPROM_STORE_SIZE)	// Number of records that fit in segment area.
+#if EEPROM_SEGMENT_COUNT>=128
+	#error Too many segments for 8-bit sequence numbers! (EEPROM_TARGET_SIZE)
+#endif
 #define EEPROM_ERASED_DATA		0x00		// EEPROM cell state after erasing (inverted).
 
 #define EEPROM_OK			0			// Everything went fine.
 #define EEPROM_NO_DATA		1			// No valid data found.
+#define EEPROM_BUSY			2			// Job can not be queued.
+
+// Asynchronous job flags (for [EEPROM_get_job_result()]).
+#define EEPROM_JOB_WRITE	(1<<0)		// Segment write is queued or in progress.
+#define EEPROM_JOB_MOVE		(1<<1)		// Move to the next segment is queued or in progress.
+#define EEPROM_JOB_RAW		(1<<2)		// Raw block write is in progress (does not report [EEPROM_JOB_DONE] and [EEPROM_JOB_FAIL]).
+#define EEPROM_JOB_DONE		(1<<6)		// All queued jobs are finished.
+#define EEPROM_JOB_FAIL		(1<<7)		// Some byte did not verify after erase/write.
+#define EEPROM_JOB_MAX_OPS	4			// Maximum erase/write operations per byte before giving up on it.
 
 // HAL
 #if defined(__AVR_ATmega32__)	// ATmega32(A)
@@ -325,6 +359,15 @@ Supported MCUs:	ATmega32(A), ATmega88(A/PA), ATmega168(A/PA), ATmega328(P).
 #undef EEP_NO_ERASE
 #endif
 
+// EEPROM ready interrupt.
+#if defined(__AVR_ATmega32__) || defined(__AVR_ATmega32A__)
+#define EEP_RDY_INT		EE_RDY_vect
+#else
+#define EEP_RDY_INT		EE_READY_vect
+#endif
+#define EEP_RDY_INT_EN	EECR|=(1<<EERIE)
+#define EEP_RDY_INT_DIS	EECR&=~(1<<EERIE)
+
 #ifdef EEP_16BIT_ADDR
 void EEPROM_erase_byte(const uint16_t *, uint16_t);
 void EEPROM_erase_byte_intfree(const uint16_t *, uint16_t);
@@ -336,6 +379,8 @@ uint8_t EEPROM_search_data(uint8_t *, uint16_t, uint16_t);
 void EEPROM_read_segment(uint8_t *, uint16_t, uint16_t);
 void EEPROM_write_segment(uint8_t *, uint16_t, uint16_t);
 void EEPROM_write_segment_intfree(uint8_t *, uint16_t, uint16_t);
+uint8_t EEPROM_queue_append(const uint8_t *, uint16_t, uint16_t);
+uint8_t EEPROM_queue_raw(uint16_t, const uint8_t *, uint16_t);
 #else
 void EEPROM_erase_byte(const uint16_t *, uint8_t);
 void EEPROM_erase_byte_intfree(const uint16_t *, uint8_t);
@@ -347,7 +392,14 @@ uint8_t EEPROM_search_data(uint8_t *, uint8_t, uint8_t);
 void EEPROM_read_segment(uint8_t *, uint8_t, uint8_t);
 void EEPROM_write_segment(uint8_t *, uint8_t, uint8_t);
 void EEPROM_write_segment_intfree(uint8_t *, uint8_t, uint8_t);
+uint8_t EEPROM_queue_append(const uint8_t *, uint8_t, uint8_t);
+uint8_t EEPROM_queue_raw(uint16_t, const uint8_t *, uint8_t);
 #endif	/*EEP_16BIT_ADDR*/
+uint8_t EEPROM_search_legacy(uint8_t *, uint8_t, uint8_t);
 void EEPROM_goto_next_segment(void);
+uint8_t EEPROM_queue_next_segment(void);
+void EEPROM_job_step(void);
+uint8_t EEPROM_is_busy(void);
+uint8_t EEPROM_get_job_result(void);
 
 #endif /* DRV_EEPROM_H_ */
@@ -59,6 +59,8 @@ Hardware defines (pseudo-HAL) and setup routines.
 #define BTN_EN_INTR2		PCICR|=(1<<PCIE1)
 #define BTN_DIS_INTR2		PCICR&=~(1<<PCIE1)
 #define BTN_INT				PCINT1_vect					// Pin change interrupt
+#define BTN_CLR_INTR		PCIFR=(1<<PCIF1)			// Clear pending interrupt
+#define BTN_ALL_STATE		(BTN_SRC_1&(BTN_1|BTN_2|BTN_3|BTN_4|BTN_5|BTN_6))	// All buttons ("1" = released)
 
 // Sensors and switches.
 #define SW_PORT				PORTD
@@ -83,6 +85,12 @@ Hardware defines (pseudo-HAL) and setup routines.
 #define SW_EN_INTR2			PCICR|=(1<<PCIE2)
 #define SW_DIS_INTR2		PCICR&=~(1<<PCIE2)
 #define SW_INT				PCINT2_vect					// Pin change interrupt
+#define SW_CLR_INTR			PCIFR=(1<<PCIF2)			// Clear pending interrupt
+#define SW_POLL_STATE		(SW_SRC&(SW_STOP|SW_TAPE_IN|SW_NOREC_FWD|SW_NOREC_REV))	// Switches polled during sleep
+// Tachometer sensor supply through reverse record inhibit switch pin (for transports without that switch).
+#define TACHO_PWR_SETUP		SW_DIR|=SW_NOREC_REV		// Set pin as output
+#define TACHO_PWR_EN		SW_PORT|=SW_NOREC_REV		// Enable power for tacho sensor
+#define TACHO_PWR_DIS		SW_PORT&=~SW_NOREC_REV		// Disable power for tacho sensor
 
 // Playback mute output control.
 #define MUTE_EN_PORT		PORTD
@@ -138,6 +146,14 @@ Hardware defines (pseudo-HAL) and setup routines.
 #define WDT_FLUSH_REASON	MCUSR=(0<<WDRF)|(0<<BORF)|(0<<EXTRF)|(0<<PORF)
 #define WDT_PREP_ON			WDTCSR|=(1<<WDCE)|(1<<WDE)
 #define WDT_SW_ON			WDTCSR=(1<<WDE)|(1<<WDP0)|(1<<WDP1)|(1<<WDP2)	// MCU reset after ~2.0 s
+#define WDT_SW_POLL			WDTCSR=(1<<WDIE)|(1<<WDP2)	// Interrupt (no reset) every ~0.25 s
+#define WDT_POLL_MS			250							// Period of [WDT_SW_POLL] (ms)
+#define WDT_INT				WDT_vect					// Interrupt vector alias
+
+// Core clock prescaler (timed sequence, interrupts must be disabled).
+#define CLK_PREP			CLKPR=(1<<CLKPCE)			// Enable prescaler change for 4 cycles
+#define CLK_SET_FULL		CLKPR=0						// Core clock: INclk/1 (8 MHz)
+#define CLK_SET_SLOW		CLKPR=(1<<CLKPS1)|(1<<CLKPS0)	// Core clock: INclk/8 (1 MHz)
 
 // System timer setup.
 #define SYST_INT			TIMER2_COMPA_vect			// Interrupt vector alias
@@ -147,9 +163,17 @@ Hardware defines (pseudo-HAL) and setup routines.
 #define SYST_DIS_INTR		TIMSK2&=~(1<<OCIE2A)		// Disable interrupt
 #define SYST_START			TCCR2B|=(1<<CS22)			// Start timer with clk/64 clock (125 kHz)
 #define SYST_STOP			TCCR2B&=~((1<<CS20)|(1<<CS21)|(1<<CS22))	// Stop timer
+#define SYST_CLK_FULL		TCCR2B=(1<<CS22)			// Timer clock for full core clock: clk/64 (125 kHz)
+#define SYST_CLK_SLOW		TCCR2B=(1<<CS21)			// Timer clock for slow core clock: clk/8 (125 kHz)
 #define SYST_DATA_8			TCNT2						// Count register
 #define SYST_RESET			SYST_DATA_8=0				// Reset count
 
+// Cycle counter for profiling (Timer 1 is not used by the firmware, must be powered up with [PDM_T1]).
+#define CYCT_START			TCCR1A=0;TCCR1B=(1<<CS10)	// Start timer with clk/1 clock
+#define CYCT_STOP			TCCR1B=0					// Stop timer
+#define CYCT_DATA_16		TCNT1						// Count register
+#define CYCT_RESET			CYCT_DATA_16=0				// Reset count
+
 // Power consumption optimizations.
 #define PWR_COMP_OFF		ACSR|=(1<<ACD)
 #define PWR_ADC_OFF			PRR|=(1<<PRADC)
@@ -159,6 +183,9 @@ Hardware defines (pseudo-HAL) and setup routines.
 #define PWR_I2C_OFF			PRR|=(1<<PRTWI)
 #define PWR_SPI_OFF			PRR|=(1<<PRSPI)
 #define PWR_UART_OFF		PRR|=(1<<PRUSART0)
+#define PWR_T1_ON			PRR&=~(1<<PRTIM1)
+#define PWR_SPI_ON			PRR&=~(1<<PRSPI)
+#define PWR_UART_ON			PRR&=~(1<<PRUSART0)
 
 // Debug outputs in place of analog output controls.
 #ifdef DBG_ACT_MON
@@ -206,7 +233,7 @@ inline void HW_init(void)
 	// Init transport switches inputs.
 	SW_DIR&=~(SW_1|SW_2|SW_3|SW_4|SW_5);	// Set pins as inputs
 	SW_PORT|=SW_1|SW_2|SW_3|SW_4|SW_5;		// Turn on pull-ups
-	// Pre-configure (but not enable) pin change interrupts for sleep mode.
+	// Pre-configure (but not enable) pin change interrupts for buttons and sleep mode.
 	BTN_EN_INTR1;
 	SW_EN_INTR1;
 
@@ -1,5 +1,4 @@
-﻿#include "drv_UART.h"
-#include <stdio.h>
+﻿#include "drv_uart.h"
 
 #ifdef UART_TERM
 
@@ -8,8 +7,16 @@ static volatile uint16_t p_write=0;		// Points to next free cell inside TX buffe
 static volatile uint16_t p_receive=0;	// Points to next free cell inside RX buffer from UART.
 static volatile uint16_t p_read=0;		// Points to first unread symbol inside RX buffer.
 static uint16_t send_char_count=0;
+static uint8_t u8_tx_activity=0;		// Byte was put into USART since last [UART_is_idle()] call.
 static volatile uint16_t receive_char_count=0;
 static uint8_t c_send_arr[UART_OUTPUT_BUF_LEN], c_receive_arr[UART_INPUT_BUF_LEN];
+static uint8_t u8_log_level=LOG_LVL_DEBUG;			// Minimum level of log messages to pass.
+static uint8_t u8_log_mute=0;						// Bit mask of muted subsystems.
+static uint16_t u16a_log_filtered[LOG_SUB_MAX];		// Number of filtered out messages per subsystem.
+static uint16_t u16_log_lost=0;						// Number of messages (lines) dropped due to buffer overflow.
+static uint16_t u16_line_bytes=0;					// Number of bytes of the open line in output buffer.
+static uint8_t u8_line_state=UART_LINE_OFF;			// State of line assembly ([UART_LINE_xxx]).
+static uint8_t u8_out_rejected=0;					// Previous data outside of a line was rejected.
 
 //-------------------------------------- Set UART speed.
 void UART_set_speed(uint16_t set_speed)
@@ -38,16 +45,108 @@ void UART_disable(void)
 	UART_CONF2_REG&=~(UART_RX_EN|UART_TX_EN|UART_RX_INT_EN|UART_TX_INT_EN);
 }
 
+//-------------------------------------- Count one lost message.
+static void count_lost(void)
+{
+	if(u16_log_lost<0xFFFF) u16_log_lost++;
+}
+
+//-------------------------------------- Check if output buffer has room for [length] bytes.
+// Inside a line (see [UART_begin_line()]) the first fragment that does not fit removes the whole line,
+// the rest of the line is dropped as well and the line is counted as one lost message.
+// Outside of a line each run of rejected fragments is counted as one lost message.
+static uint8_t out_buf_fits(uint16_t length)
+{
+	if(u8_line_state==UART_LINE_DROP)
+	{
+		// Line is already rejected.
+		return 0;
+	}
+	// Correct error if required.
+	//if(send_char_count>UART_OUTPUT_BUF_LEN) send_char_count=UART_OUTPUT_BUF_LEN;
+	// Check available space.
+	if(length>(UART_OUTPUT_BUF_LEN-send_char_count))
+	{
+#ifdef UART_EN_OVWR
+		// Count dropped data.
+		count_lost();
+		// Reset buffer.
+		p_send=0;
+		p_write=3;
+		send_char_count=3;
+		c_send_arr[0]='?';
+		c_send_arr[1]='\n';
+		c_send_arr[2]='\r';
+		// Beginning of the line is lost with the buffer.
+		u16_line_bytes=0;
+#else
+		if(u8_line_state==UART_LINE_OPEN)
+		{
+			// Remove already added part of the line (nothing of it could be sent yet).
+			if(p_write<u16_line_bytes)
+			{
+				p_write+=UART_OUTPUT_BUF_LEN;
+			}
+			p_write-=u16_line_bytes;
+			send_char_count-=u16_line_bytes;
+			u16_line_bytes=0;
+			u8_line_state=UART_LINE_DROP;
+			count_lost();
+		}
+		else if(u8_out_rejected==0)
+		{
+			u8_out_rejected=1;
+			count_lost();
+		}
+		// Do not overfill the buffer.
+		return 0;
+#endif /*UART_EN_OVWR*/
+	}
+	u8_out_rejected=0;
+	return 1;
+}
+
+//-------------------------------------- Put one byte into output buffer (available space should be checked beforehand).
+static inline void put_to_out_buf(uint8_t in_byte)
+{
+	c_send_arr[p_write]=in_byte;
+	// Move pointer.
+	p_write++;
+	// Loop within buffer.
+	if(p_write>=UART_OUTPUT_BUF_LEN) p_write=0;
+	// Increase sending data counter.
+	send_char_count++;
+	if(u8_line_state==UART_LINE_OPEN)
+	{
+		u16_line_bytes++;
+	}
+}
+
+//-------------------------------------- Start a new line of text.
+// All data added until [UART_end_line()] is put into output buffer as a whole or dropped as a whole.
+// Line must be assembled and ended without sending data in between (no [UART_send_byte()] or [UART_dump_out()]).
+void UART_begin_line(void)
+{
+	u16_line_bytes=0;
+	u8_line_state=UART_LINE_OPEN;
+}
+
+//-------------------------------------- Finish current line of text.
+// Returns 1 if the line was put into output buffer, 0 if it was dropped.
+uint8_t UART_end_line(void)
+{
+	uint8_t u8_res;
+	u8_res=(u8_line_state!=UART_LINE_DROP);
+	u16_line_bytes=0;
+	u8_line_state=UART_LINE_OFF;
+	return u8_res;
+}
+
 //-------------------------------------- Add string to output buffer.
 void add_str_to_out_buf(const uint8_t *input_ptr, const uint8_t data_mode)
 {
-	volatile uint16_t available, length;
-	uint16_t i;
+	uint16_t i, length;
 	uint8_t read_byte;
-	// Correct error if required.
-	//if(send_char_count>UART_OUTPUT_BUF_LEN) send_char_count=UART_OUTPUT_BUF_LEN;
-	// Calculate available bytes in buffer.
-	available=UART_OUTPUT_BUF_LEN-send_char_count;
 	// Reset variables.
 	i=0;
 	length=0;
@@ -72,46 +171,22 @@ void add_str_to_out_buf(const uint8_t *input_ptr, const uint8_t data_mode)
 	}
 	// Correct offset.
 	length--;
-#ifdef UART_EN_OVWR
 	// Check available space.
-	if(length>available)
-	{
-		// Reset buffer.
-		p_send=0;
-		p_write=3;
-		send_char_count=3;
-		c_send_arr[0]='?';
-		c_send_arr[1]='\n';
-		c_send_arr[2]='\r';
-	}
-#else
-	// Check available space.
-	if(length>available)
-	{
-		// Do not overfill the buffer.
-		return;
-	}
-#endif /*UART_EN_OVWR*/
+	if(out_buf_fits(length)==0) return;
 	// Fill the buffer.
 	while(i<length)
 	{
 		if(data_mode==UART_ROM)
 		{
 			// Copy byte from ROM.
-			c_send_arr[p_write]=pgm_read_byte_near(input_ptr+i);
+			put_to_out_buf(pgm_read_byte_near(input_ptr+i));
 		}
 		else
 		{
 			// Copy byte from RAM.
-			c_send_arr[p_write]=input_ptr[i];
+			put_to_out_buf(input_ptr[i]);
 		}
-		// Move pointer.
-		p_write++;
-		// Loop within buffer.
-		if(p_write>=UART_OUTPUT_BUF_LEN) p_write=0;
-		// Increase sending data counter.
 		i++;
-		send_char_count++;
 	}
 }
 
@@ -127,17 +202,110 @@ void UART_add_flash_string(const uint8_t *u8_input)
 	add_str_to_out_buf((uint8_t*)u8_input, UART_ROM);
 }
 
+//-------------------------------------- Add one character to output buffer.
+void UART_add_char(uint8_t in_char)
+{
+	if(out_buf_fits(1)==0) return;
+	put_to_out_buf(in_char);
+}
+
+//-------------------------------------- Add binary data block to output buffer.
+// Block is added only as a whole (no partial blocks in the stream), zero bytes are allowed.
+void UART_add_data(const uint8_t *in_data, uint8_t in_length)
+{
+	uint8_t i;
+	if(out_buf_fits(in_length)==0) return;
+	for(i=0;i<in_length;i++)
+	{
+		put_to_out_buf(in_data[i]);
+	}
+}
+
+//-------------------------------------- Add 8-bit unsigned value as decimal text to output buffer.
+// Leading zeros are added up to [in_digits] total digits (same as "%0Nu" for printf()).
+// No division, each digit takes 9 subtractions at most, no more than ~70 cycles per call.
+void UART_add_dec8(uint8_t in_value, uint8_t in_digits)
+{
+	uint8_t u8_hundreds, u8_tens;
+	if(out_buf_fits(3)==0) return;
+	u8_hundreds=0;
+	while(in_value>=100)
+	{
+		in_value-=100;
+		u8_hundreds++;
+	}
+	u8_tens=0;
+	while(in_value>=10)
+	{
+		in_value-=10;
+		u8_tens++;
+	}
+	if((u8_hundreds!=0)||(in_digits>=3))
+	{
+		put_to_out_buf('0'+u8_hundreds);
+	}
+	if((u8_hundreds!=0)||(u8_tens!=0)||(in_digits>=2))
+	{
+		put_to_out_buf('0'+u8_tens);
+	}
+	put_to_out_buf('0'+in_value);
+}
+
+static const uint16_t u16a_dec_weights[] PROGMEM = {10000, 1000, 100, 10};
+//-------------------------------------- Add 16-bit unsigned value as decimal text to output buffer.
+// Leading zeros are added up to [in_digits] total digits (same as "%0Nu" for printf()).
+// No division, each digit takes 9 subtractions at most, no more than ~300 cycles per call.
+void UART_add_dec16(uint16_t in_value, uint8_t in_digits)
+{
+	uint16_t u16_weight;
+	uint8_t u8_idx, u8_digit, u8_started;
+	if(out_buf_fits(5)==0) return;
+	u8_started=0;
+	for(u8_idx=0;u8_idx<4;u8_idx++)
+	{
+		u16_weight=pgm_read_word_near(u16a_dec_weights+u8_idx);
+		u8_digit='0';
+		while(in_value>=u16_weight)
+		{
+			in_value-=u16_weight;
+			u8_digit++;
+		}
+		// Skip leading zeros that are not required by [in_digits].
+		if((u8_digit!='0')||(u8_started!=0)||(in_digits>=(5-u8_idx)))
+		{
+			put_to_out_buf(u8_digit);
+			u8_started=1;
+		}
+	}
+	put_to_out_buf('0'+(uint8_t)in_value);
+}
+
+//-------------------------------------- Add 8-bit value as two-digit hex text to output buffer.
+// Lower-case digits (same as "%02x" for printf()).
+void UART_add_hex8(uint8_t in_value)
+{
+	uint8_t u8_nibble;
+	if(out_buf_fits(2)==0) return;
+	u8_nibble=(in_value>>4);
+	put_to_out_buf((u8_nibble<10)?('0'+u8_nibble):('a'-10+u8_nibble));
+	u8_nibble=(in_value&0x0F);
+	put_to_out_buf((u8_nibble<10)?('0'+u8_nibble):('a'-10+u8_nibble));
+}
+
 //-------------------------------------- Send one byte from output buffer to UART.
 void UART_send_byte(void)
 {
 	// Check number of bytes in buffer.
 	if(send_char_count>0)
 	{
+		// Make sure USART is not powered down.
+		UART_PWR_ON;
 		// Wait for USART register to empty.
 		if((UART_STATE_REG&UART_DATA_EMPTY)!=0)
 		{
 			// Put data into USART register.
 			UART_DATA_REG=c_send_arr[p_send];
+			u8_tx_activity=1;
 			// Clear byte (for simulation).
 			c_send_arr[p_send]=0;
 			// Move pointer.
@@ -216,6 +384,21 @@ uint16_t UART_get_sending_number(void)
 	return send_char_count;
 }
 
+//-------------------------------------- Check if transmitter is idle.
+// Returns 1 if transmitting buffer is empty and no byte was put into USART since previous call
+// (call period must be longer than one byte time, then USART can be powered down).
+uint8_t UART_is_idle(void)
+{
+	uint8_t u8_activity;
+	u8_activity=u8_tx_activity;
+	u8_tx_activity=0;
+	if((send_char_count==0)&&(u8_activity==0))
+	{
+		return 1;
+	}
+	return 0;
+}
+
 //-------------------------------------- Clear all data from USART input buffer.
 void UART_flush_in(void)
 {
@@ -241,4 +424,44 @@ void UART_dump_out(void)
 	}
 }
 
+//-------------------------------------- Apply packed log configuration.
+// Lower bits [LOG_CFG_MUTE_MASK] mute subsystems, upper bits [LOG_CFG_LVL_MASK] set minimum level.
+void UART_log_setup(uint8_t in_cfg)
+{
+	u8_log_mute=(in_cfg&LOG_CFG_MUTE_MASK);
+	u8_log_level=((in_cfg&LOG_CFG_LVL_MASK)>>LOG_CFG_LVL_SHIFT);
+}
+
+//-------------------------------------- Get packed log configuration.
+uint8_t UART_log_get_setup(void)
+{
+	return (u8_log_mute|(u8_log_level<<LOG_CFG_LVL_SHIFT));
+}
+
+//-------------------------------------- Check if log message passes the filter.
+// Filtered out messages are counted per subsystem.
+uint8_t UART_log_check(uint8_t in_sub, uint8_t in_level)
+{
+	if(in_sub>=LOG_SUB_MAX) return 0;
+	if((in_level<u8_log_level)||((u8_log_mute&(1<<in_sub))!=0))
+	{
+		if(u16a_log_filtered[in_sub]<0xFFFF) u16a_log_filtered[in_sub]++;
+		return 0;
+	}
+	return 1;
+}
+
+//-------------------------------------- Get number of filtered out messages for the subsystem.
+uint16_t UART_log_get_filtered(uint8_t in_sub)
+{
+	if(in_sub>=LOG_SUB_MAX) return 0;
+	return u16a_log_filtered[in_sub];
+}
+
+//-------------------------------------- Get number of messages dropped due to output buffer overflow.
+uint16_t UART_log_get_lost(void)
+{
+	return u16_log_lost;
+}
+
 #endif /* UART_TERM */
@@ -22,6 +22,9 @@ The driver is buffer-based, both on transmit and receive sides.
 The driver is targeted for real-time systems with no wait loops inside it.
 Buffer length is configurable via defines [UART_IN_LEN] and [UART_OUT_LEN].
 The driver can set UART speed on-the-fly, using [UART_BAUD_xxxx] defines in [UART_set_speed()] and [F_CPU] define for CPU clock (in Hz).
+Numbers can be put into transmitting buffer as text via [UART_add_dec8()], [UART_add_dec16()] and [UART_add_hex8()] without printf() and any intermediate buffers.
+Fragments between [UART_begin_line()] and [UART_end_line()] are put into transmitting buffer as a whole line or not at all.
+Log messages can be filtered by subsystem and level at runtime via [UART_log_setup()] and cut out at compile time via [UART_LOG_FLOOR] define.
 
 Part of the [AVRTapeControl] project.
 Supported MCUs:	ATmega32, ATmega32A, ATmega168PA, ATmega328, ATmega328P.
@@ -82,6 +85,7 @@ Supported MCUs:	ATmega32, ATmega32A, ATmega168PA, ATmega328, ATmega328P.
 #define UART_PARITY_ERR		(1<<UPE)
 #define UART_DATA_OVERRUN	(1<<DOR)
 #define UART_MODE_8N1		UCSRC=(1<<URSEL)|(1<<UCSZ1)|(1<<UCSZ0)
+#define UART_PWR_ON							// No power reduction register
 #endif	/*SIGNATURE_2*/
 
 #if SIGNATURE_2 == 0x0B	// ATmega168PA
@@ -105,6 +109,7 @@ Supported MCUs:	ATmega32, ATmega32A, ATmega168PA, ATmega328, ATmega328P.
 #define UART_PARITY_ERR		(1<<UPE0)
 #define UART_DATA_OVERRUN	(1<<DOR0)
 #define UART_MODE_8N1		UCSR0C=(1<<UCSZ01)|(1<<UCSZ00)
+#define UART_PWR_ON			PRR&=~(1<<PRUSART0)	// Power up USART module (registers keep their settings)
 #endif	/*SIGNATURE_2*/
 
 #if SIGNATURE_2 == 0x0F	// ATmega328P
@@ -128,6 +133,7 @@ Supported MCUs:	ATmega32, ATmega32A, ATmega168PA, ATmega328, ATmega328P.
 #define UART_PARITY_ERR		(1<<UPE0)
 #define UART_DATA_OVERRUN	(1<<DOR0)
 #define UART_MODE_8N1		UCSR0C=(1<<UCSZ01)|(1<<UCSZ00)
+#define UART_PWR_ON			PRR&=~(1<<PRUSART0)	// Power up USART module (registers keep their settings)
 #endif	/*SIGNATURE_2*/
 
 #if SIGNATURE_2 == 0x14	// ATmega328
@@ -151,26 +157,75 @@ Supported MCUs:	ATmega32, ATmega32A, ATmega168PA, ATmega328, ATmega328P.
 #define UART_PARITY_ERR		(1<<UPE0)
 #define UART_DATA_OVERRUN	(1<<DOR0)
 #define UART_MODE_8N1		UCSR0C=(1<<UCSZ01)|(1<<UCSZ00)
+#define UART_PWR_ON			PRR&=~(1<<PRUSART0)	// Power up USART module (registers keep their settings)
 #endif	/*SIGNATURE_2*/
 
 // Interrupt header and footer if [ISR_NAKED] is used.
 #define INTR_UART_IN	asm volatile("push	r1\npush	r0\nin	r0, 0x3f\npush	r0\neor	r1, r1\npush	r24\npush	r25\npush	r30\npush	r31\n")
 #define INTR_UART_OUT	asm volatile("pop	r31\npop	r30\npop	r25\npop	r24\npop	r0\nout	0x3f, r0\npop	r0\npop	r1")
 
+// Line assembly states (for [UART_begin_line()] and [UART_end_line()]).
+#define UART_LINE_OFF		0	// Data is added fragment by fragment
+#define UART_LINE_OPEN		1	// Line is being assembled
+#define UART_LINE_DROP		2	// Line did not fit, the rest of it is dropped
+
 // Allow transmitting buffer to be flushed and overwritten if overflow occurs.
 //#define UART_EN_OVWR	1	
 
+// Log levels (for use in [UART_LOG_ON()]).
+#define LOG_LVL_DEBUG		0	// Verbose state dumps
+#define LOG_LVL_INFO		1	// Normal operation events
+#define LOG_LVL_WARN		2	// Recoverable problems
+#define LOG_LVL_ERROR		3	// Fatal problems
+
+// Log subsystems (for use in [UART_LOG_ON()]).
+enum
+{
+	LOG_SUB_KBD,		// User buttons
+	LOG_SUB_SWS,		// Transport switches
+	LOG_SUB_MECH,		// Transport state machine
+	LOG_SUB_EEPROM,		// Settings storage
+	LOG_SUB_POWER,		// Power and sleep management
+	LOG_SUB_MAX			// Subsystem limit
+};
+
+// Packed log configuration byte (for [UART_log_setup()]).
+// Value of 0 enables all subsystems on all levels.
+#define LOG_CFG_MUTE_MASK	0x1F					// Bit per subsystem: 1 = muted
+#define LOG_CFG_LVL_SHIFT	5
+#define LOG_CFG_LVL_MASK	(0x03<<LOG_CFG_LVL_SHIFT)	// Minimum level to output
+
+#ifndef UART_LOG_FLOOR
+#define UART_LOG_FLOOR		LOG_LVL_DEBUG
+#endif /* UART_LOG_FLOOR */
+
+// Check if log message should be output. Messages below [UART_LOG_FLOOR] are removed at compile time.
+#define UART_LOG_ON(sub, lvl)	(((lvl)>=UART_LOG_FLOOR)&&(UART_log_check((sub), (lvl))!=0))
+
 void UART_set_speed(uint16_t);					// Set UART speed with "UART_BAUD_xxxx" defines.
 void UART_enable(void);							// Enable UART hardware.
 void UART_disable(void);						// Disable UART hardware.
 void UART_add_string(const char*);				// Add char* string into transmitting buffer (buffer length in [UART_OUTPUT_BUF_LEN]).
 void UART_add_flash_string(const uint8_t*);		// Add string from PROGMEM into transmitting buffer (buffer length in [UART_OUTPUT_BUF_LEN]).
+void UART_add_char(uint8_t);					// Add one character into transmitting buffer.
+void UART_add_data(const uint8_t*, uint8_t);	// Add binary data block (whole or nothing) into transmitting buffer.
+void UART_add_dec8(uint8_t, uint8_t);			// Add 8-bit unsigned value as decimal text with minimum number of digits into transmitting buffer.
+void UART_add_dec16(uint16_t, uint8_t);			// Add 16-bit unsigned value as decimal text with minimum number of digits into transmitting buffer.
+void UART_add_hex8(uint8_t);					// Add 8-bit value as two-digit hex text into transmitting buffer.
+void UART_begin_line(void);						// Start a line of text that is put into transmitting buffer as a whole or not at all.
+uint8_t UART_end_line(void);					// Finish the line of text (returns 0 if it was dropped).
 void UART_send_byte(void);						// Transmit on byte from transmitting buffer to UART.
 void UART_receive_byte(void);					// Receive on byte from UART and put it into receiving buffer (buffer length in [UART_INPUT_BUF_LEN]).
 int8_t UART_get_byte(void);						// Read on byte from receiving buffer.
 uint16_t UART_get_received_number(void);		// Get number of unread bytes in receiving buffer.
 uint16_t UART_get_sending_number(void);			// Get number of not transmitted bytes in transmitting buffer.
+uint8_t UART_is_idle(void);						// Check if nothing was transmitted since previous call and transmitting buffer is empty.
 void UART_flush_in(void);						// Clear out receiving buffer.
 void UART_dump_out(void);						// Dump all bytes one-by-one from transmitting buffer to UART (clear space in transmitting buffer).
+void UART_log_setup(uint8_t);					// Apply packed log configuration (muted subsystems and minimum level).
+uint8_t UART_log_get_setup(void);				// Get packed log configuration.
+uint8_t UART_log_check(uint8_t, uint8_t);		// Check if message of subsystem and level passes the filter (and count it if not).
+uint16_t UART_log_get_filtered(uint8_t);		// Get number of filtered out messages for the subsystem.
+uint16_t UART_log_get_lost(void);				// Get number of messages lost due to transmitting buffer overflow.
 
 #endif /* DRV_UART_H_ */
@@ -0,0 +1,177 @@
+﻿#include "idle_policy.h"
+
+#ifdef EN_IDLE_ADAPT
+
+// Upper edges of gap histogram bins (2 ms ticks), also candidates for the timeout.
+static const uint16_t u16a_idl_edges[IDL_BIN_CNT-1] PROGMEM =
+{
+	2500,		// 5 s
+	5000,		// 10 s
+	7500,		// 15 s
+	15000,		// 30 s
+	22500,		// 45 s
+	30000,		// 60 s
+	45000,		// 90 s
+	IDLE_CAP_MAX
+};
+
+static uint8_t u8a_idl_hist[IDL_BIN_CNT];				// Gap histogram
+static uint8_t u8_idl_gaps=0;							// Number of collected gaps (saturates at [IDL_MIN_GAPS])
+static uint16_t u16_idl_timeout=IDLE_ADAPT_MAX;			// Current capstan shutdown timeout (2 ms ticks)
+static uint16_t u16_idl_avoided=0;						// Number of commands that found capstan running after [IDLE_ADAPT_MIN]
+static uint16_t u16_idl_spinups=0;						// Number of commands that needed capstan spin-up after idle timeout
+
+//-------------------------------------- Find histogram bin for the gap.
+static uint8_t IDL_gap_to_bin(uint16_t in_gap)
+{
+	uint8_t u8_bin;
+	for(u8_bin=0;u8_bin<(IDL_BIN_CNT-1);u8_bin++)
+	{
+		if(in_gap<=pgm_read_word(&u16a_idl_edges[u8_bin]))
+		{
+			break;
+		}
+	}
+	return u8_bin;
+}
+
+//-------------------------------------- Calculate expected cost of the timeout for collected gaps.
+// Cost is measured in capstan run time (2 ms ticks), each spin-up costs [IDLE_SPINUP_COST].
+static uint32_t IDL_get_cost(uint16_t in_timeout)
+{
+	uint8_t u8_bin;
+	uint16_t u16_edge;
+	uint32_t u32_cost;
+	u32_cost = 0;
+	for(u8_bin=0;u8_bin<IDL_BIN_CNT;u8_bin++)
+	{
+		if(u8_bin<(IDL_BIN_CNT-1))
+		{
+			u16_edge = pgm_read_word(&u16a_idl_edges[u8_bin]);
+		}
+		else
+		{
+			u16_edge = 0xFFFF;
+		}
+		if(u16_edge<=in_timeout)
+		{
+			// Capstan keeps running through the whole gap.
+			u32_cost += (uint32_t)u8a_idl_hist[u8_bin]*u16_edge;
+		}
+		else
+		{
+			// Capstan is stopped by timeout and has to be spun up for the next command.
+			u32_cost += (uint32_t)u8a_idl_hist[u8_bin]*((uint32_t)in_timeout+IDLE_SPINUP_COST);
+		}
+	}
+	return u32_cost;
+}
+
+//-------------------------------------- Pick the timeout with the lowest expected cost.
+static void IDL_update(void)
+{
+	uint8_t u8_bin;
+	uint16_t u16_cand;
+	uint32_t u32_cost, u32_best;
+	// Start from the shortest allowed timeout, longer one has to be strictly better.
+	u16_idl_timeout = IDLE_ADAPT_MIN;
+	u32_best = IDL_get_cost(IDLE_ADAPT_MIN);
+	for(u8_bin=0;u8_bin<(IDL_BIN_CNT-1);u8_bin++)
+	{
+		u16_cand = pgm_read_word(&u16a_idl_edges[u8_bin]);
+		if(u16_cand<=IDLE_ADAPT_MIN)
+		{
+			continue;
+		}
+		if(u16_cand>IDLE_ADAPT_MAX)
+		{
+			u16_cand = IDLE_ADAPT_MAX;
+		}
+		u32_cost = IDL_get_cost(u16_cand);
+		if(u32_cost<u32_best)
+		{
+			u32_best = u32_cost;
+			u16_idl_timeout = u16_cand;
+		}
+		if(u16_cand>=IDLE_ADAPT_MAX)
+		{
+			break;
+		}
+	}
+}
+
+//-------------------------------------- Account idle time in STOP before user command.
+// Must be called when transport leaves idle STOP with tape loaded.
+// [in_idle] - idle timer value (2 ms ticks, saturates at [IDLE_CAP_MAX]);
+// [in_capstan] - capstan state (0 - capstan was stopped).
+void IDL_log_gap(uint16_t in_idle, uint8_t in_capstan)
+{
+	uint8_t u8_bin;
+	if(in_capstan!=0)
+	{
+		// Capstan is still running.
+		if(in_idle<IDL_GAP_MIN)
+		{
+			// Not an idle gap.
+			return;
+		}
+		if((in_idle>=IDLE_ADAPT_MIN)&&(u16_idl_avoided<0xFFFF))
+		{
+			// Capstan would be stopped with the shortest timeout.
+			u16_idl_avoided++;
+		}
+		u8_bin = IDL_gap_to_bin(in_idle);
+	}
+	else
+	{
+		// Capstan is stopped.
+		if(in_idle<u16_idl_timeout)
+		{
+			// Capstan was not stopped by idle timeout (power-up, no tape), gap is unknown.
+			return;
+		}
+		if(u16_idl_spinups<0xFFFF)
+		{
+			u16_idl_spinups++;
+		}
+		// Real gap is unknown (MCU could sleep), count it as just longer than the timeout.
+		u8_bin = IDL_gap_to_bin(u16_idl_timeout+1);
+	}
+	u8a_idl_hist[u8_bin]++;
+	if(u8a_idl_hist[u8_bin]>=IDL_HIST_AGE)
+	{
+		// Fade out old gaps.
+		for(u8_bin=0;u8_bin<IDL_BIN_CNT;u8_bin++)
+		{
+			u8a_idl_hist[u8_bin] = u8a_idl_hist[u8_bin]/2;
+		}
+	}
+	if(u8_idl_gaps<IDL_MIN_GAPS)
+	{
+		u8_idl_gaps++;
+	}
+	if(u8_idl_gaps>=IDL_MIN_GAPS)
+	{
+		IDL_update();
+	}
+}
+
+//-------------------------------------- Get capstan shutdown timeout with tape loaded (2 ms ticks).
+uint16_t IDL_get_timeout(void)
+{
+	return u16_idl_timeout;
+}
+
+//-------------------------------------- Get number of spin-ups avoided by keeping capstan running longer than [IDLE_ADAPT_MIN].
+uint16_t IDL_get_avoided(void)
+{
+	return u16_idl_avoided;
+}
+
+//-------------------------------------- Get number of spin-ups after idle timeout.
+uint16_t IDL_get_spinups(void)
+{
+	return u16_idl_spinups;
+}
+
+#endif /* EN_IDLE_ADAPT */
@@ -0,0 +1,70 @@
+﻿/**************************************************************************************************************************************************************
+idle_policy.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-08-09
+
+Part of the [AVRTapeControl] project.
+Adaptive capstan idle shutdown policy for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+
+Transport state machine reports how long the transport idled in STOP (with tape loaded) before the next user command
+and whether capstan was still running at that moment. Gaps are collected into a small histogram,
+timeout for capstan shutdown is picked to minimize expected cost: capstan run time for each gap
+plus [IDLE_SPINUP_COST] for each gap that is longer than the timeout (next command would need a spin-up).
+Timeout is always kept within [IDLE_ADAPT_MIN]...[IDLE_ADAPT_MAX] bounds.
+When capstan was already stopped the real gap is unknown (MCU sleeps), such gap is counted as just longer than the timeout,
+so frequent spin-ups move the timeout up one step at a time. Histogram is halved from time to time to follow usage changes.
+History is kept in RAM only and starts from [IDLE_ADAPT_MAX] after power-up.
+
+**************************************************************************************************************************************************************/
+
+#ifndef IDLE_POLICY_H_
+#define IDLE_POLICY_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "config.h"
+
+#ifdef EN_IDLE_ADAPT
+
+#if IDLE_ADAPT_MIN>IDLE_ADAPT_MAX
+	#error Minimum idle timeout is greater than maximum! (IDLE_ADAPT_MIN)
+#endif
+#if IDLE_ADAPT_MAX>IDLE_CAP_MAX
+	#error Maximum idle timeout does not fit idle timer! (IDLE_ADAPT_MAX)
+#endif
+
+#define IDL_BIN_CNT			9			// Number of gap histogram bins (the last one is for gaps longer than [IDLE_CAP_MAX])
+#define IDL_HIST_AGE		32			// Histogram is halved when any bin reaches this count
+#define IDL_MIN_GAPS		4			// Number of gaps to collect before the timeout is adapted
+#define IDL_GAP_MIN			250			// Gaps shorter than this are ignored (2 ms ticks, 0.5 s, e.g. end of capstan start-up delay)
+
+// Capstan shutdown timeout with tape loaded.
+#define IDLE_CAP_TAPE_TIMEOUT		IDL_get_timeout()
+
+void IDL_log_gap(uint16_t in_idle, uint8_t in_capstan);	// Account idle time in STOP before user command
+uint16_t IDL_get_timeout(void);							// Get capstan shutdown timeout with tape loaded (2 ms ticks)
+uint16_t IDL_get_avoided(void);							// Get number of spin-ups avoided by keeping capstan running longer than [IDLE_ADAPT_MIN]
+uint16_t IDL_get_spinups(void);							// Get number of spin-ups after idle timeout
+
+#else
+
+// Capstan shutdown timeout with tape loaded.
+#define IDLE_CAP_TAPE_TIMEOUT		IDLE_CAP_TAPE_IN
+
+#endif /* EN_IDLE_ADAPT */
+
+#endif /* IDLE_POLICY_H_ */
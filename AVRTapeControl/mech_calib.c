@@ -0,0 +1,285 @@
+﻿#include "mech_calib.h"
+
+static uint16_t u16a_cal_plan[CAL_STEP_MAX*CAL_PLAN_SIZE];	// Calibration plan
+static uint8_t u8_cal_steps=0;							// Number of steps in the plan
+static uint8_t u8_cal_state=CAL_ST_OFF;					// Calibration state
+static uint8_t u8_cal_error=CAL_ERR_NONE;				// Calibration error
+static uint8_t u8_cal_step=0;							// Current step of the plan
+static uint8_t u8_cal_cycle=0;							// Number of measured cycles
+static uint8_t u8_cal_tacho_old=0;						// Tacho sensor state on previous tick
+static uint16_t u16_cal_time=0;							// Time from the start of current state or step (ms)
+static uint16_t u16_cal_cycle_time=0;					// Time from the first pulse of the cycle (ms)
+static uint16_t u16_cal_leave=0;						// Time to STOP sensor release in current cycle (ms, 0 - not yet)
+static uint16_t u16_cal_first_tacho=0;					// Time to the first tacho edge in current cycle (ms, 0 - not yet)
+static uint16_t u16_cal_leave_sum=0;					// Sum of times to STOP sensor release
+static uint16_t u16_cal_tacho_sum=0;					// Sum of times to the first tacho edge
+static uint8_t u8_cal_tacho_cnt=0;						// Number of cycles with tacho edges
+static uint16_t u16_cal_home_min=0;						// The shortest time to STOP
+static uint16_t u16_cal_home_max=0;						// The longest time to STOP
+
+//-------------------------------------- Start calibration with the plan.
+// [in_plan] - [in_steps] pairs of [CAL_PLAN_xxx] values (ms).
+void CAL_start(const uint16_t *in_plan, uint8_t in_steps)
+{
+	uint8_t u8_idx;
+	if((in_steps==0)||(in_steps>CAL_STEP_MAX))
+	{
+		CAL_fail(CAL_ERR_NO_PLAN);
+		return;
+	}
+	for(u8_idx=0;u8_idx<(in_steps*CAL_PLAN_SIZE);u8_idx++)
+	{
+		u16a_cal_plan[u8_idx] = in_plan[u8_idx];
+	}
+	u8_cal_steps = in_steps;
+	u8_cal_cycle = 0;
+	u8_cal_tacho_cnt = 0;
+	u16_cal_leave_sum = 0;
+	u16_cal_tacho_sum = 0;
+	u16_cal_home_min = 0xFFFF;
+	u16_cal_home_max = 0;
+	u16_cal_time = 0;
+	u8_cal_error = CAL_ERR_NONE;
+	u8_cal_state = CAL_ST_SPINUP;
+	// Spin-up capstan, mechanism should stay in STOP.
+	SOLENOID_OFF;
+	CAPSTAN_ON;
+}
+
+//-------------------------------------- Stop calibration with an error.
+void CAL_fail(uint8_t in_err)
+{
+	SOLENOID_OFF;
+	CAPSTAN_OFF;
+	u8_cal_error = in_err;
+	u8_cal_state = CAL_ST_FAIL;
+}
+
+//-------------------------------------- Start a new measured cycle.
+static void CAL_start_cycle(void)
+{
+	u8_cal_step = 0;
+	u16_cal_time = 0;
+	u16_cal_cycle_time = 0;
+	u16_cal_leave = 0;
+	u16_cal_first_tacho = 0;
+	u8_cal_state = CAL_ST_STEP;
+}
+
+//-------------------------------------- Account finished cycle.
+static void CAL_end_cycle(uint16_t in_home)
+{
+	u16_cal_leave_sum += u16_cal_leave;
+	if(u16_cal_first_tacho!=0)
+	{
+		u16_cal_tacho_sum += u16_cal_first_tacho;
+		u8_cal_tacho_cnt++;
+	}
+	if(in_home<u16_cal_home_min)
+	{
+		u16_cal_home_min = in_home;
+	}
+	if(in_home>u16_cal_home_max)
+	{
+		u16_cal_home_max = in_home;
+	}
+	u8_cal_cycle++;
+	u16_cal_time = 0;
+	u8_cal_state = CAL_ST_SETTLE;
+}
+
+//-------------------------------------- Perform one step of calibration.
+// Must be called at 1 kHz (system tick), it drives capstan and solenoid.
+// [in_stop] - STOP sensor state (0 - mechanism is not in STOP);
+// [in_tacho] - tachometer sensor state;
+// Returns calibration state ([CAL_ST_xxx]).
+uint8_t CAL_tick(uint8_t in_stop, uint8_t in_tacho)
+{
+	uint16_t u16_pulse, u16_step;
+	if((u8_cal_state==CAL_ST_OFF)||(u8_cal_state>=CAL_ST_DONE))
+	{
+		return u8_cal_state;
+	}
+	if(u16_cal_time<0xFFFF)
+	{
+		u16_cal_time++;
+	}
+	if(u8_cal_state==CAL_ST_SPINUP)
+	{
+		if(u16_cal_time>=CAL_SPINUP_MS)
+		{
+			if(in_stop==0)
+			{
+				// Mechanism must start from STOP.
+				CAL_fail(CAL_ERR_NOT_STOP);
+			}
+			else
+			{
+				u8_cal_tacho_old = in_tacho;
+				CAL_start_cycle();
+			}
+		}
+	}
+	else if(u8_cal_state==CAL_ST_STEP)
+	{
+		if(u16_cal_cycle_time<0xFFFF)
+		{
+			u16_cal_cycle_time++;
+		}
+		// Register the first tacho edge of the cycle.
+		if((in_tacho!=u8_cal_tacho_old)&&(u16_cal_first_tacho==0))
+		{
+			u16_cal_first_tacho = u16_cal_cycle_time;
+		}
+		u8_cal_tacho_old = in_tacho;
+		u16_pulse = u16a_cal_plan[u8_cal_step*CAL_PLAN_SIZE+CAL_PLAN_PULSE];
+		u16_step = u16a_cal_plan[u8_cal_step*CAL_PLAN_SIZE+CAL_PLAN_STEP];
+		// Time solenoid pulse.
+		if(u16_cal_time<=u16_pulse)
+		{
+			SOLENOID_ON;
+		}
+		else
+		{
+			SOLENOID_OFF;
+		}
+		// Register STOP sensor release after the first pulse.
+		if((in_stop==0)&&(u16_cal_leave==0))
+		{
+			u16_cal_leave = u16_cal_cycle_time;
+		}
+		if((u8_cal_step+1)<u8_cal_steps)
+		{
+			// Intermediate step.
+			if(u16_cal_time>=u16_step)
+			{
+				if(u16_cal_leave==0)
+				{
+					// Mechanism did not leave STOP.
+					CAL_fail(CAL_ERR_NO_LEAVE);
+				}
+				else
+				{
+					u8_cal_step++;
+					u16_cal_time = 0;
+				}
+			}
+		}
+		else if(in_stop!=0)
+		{
+			// The last step: mechanism is back in STOP.
+			SOLENOID_OFF;
+			CAL_end_cycle(u16_cal_time);
+		}
+		else if(u16_cal_time>=(u16_step*2))
+		{
+			// Mechanism did not return to STOP.
+			CAL_fail(CAL_ERR_NO_HOME);
+		}
+	}
+	else if(u8_cal_state==CAL_ST_SETTLE)
+	{
+		if(u16_cal_time>=CAL_SETTLE_MS)
+		{
+			if(u8_cal_cycle<CAL_CYCLES)
+			{
+				CAL_start_cycle();
+			}
+			else if((u16_cal_home_max-u16_cal_home_min)>(u16_cal_home_max>>CAL_SPREAD_MAX))
+			{
+				// Mechanism timing is not repeatable.
+				CAL_fail(CAL_ERR_UNSTABLE);
+			}
+			else
+			{
+				CAPSTAN_OFF;
+				u8_cal_state = CAL_ST_DONE;
+			}
+		}
+	}
+	return u8_cal_state;
+}
+
+//-------------------------------------- Get calibration state ([CAL_ST_xxx]).
+uint8_t CAL_get_state(void)
+{
+	return u8_cal_state;
+}
+
+//-------------------------------------- Check if calibration drives the transport.
+uint8_t CAL_is_running(void)
+{
+	if((u8_cal_state!=CAL_ST_OFF)&&(u8_cal_state<CAL_ST_DONE))
+	{
+		return 1;
+	}
+	return 0;
+}
+
+//-------------------------------------- Get calibration error ([CAL_ERR_xxx]).
+uint8_t CAL_get_error(void)
+{
+	return u8_cal_error;
+}
+
+//-------------------------------------- Get average time from the first pulse to STOP sensor release (ms).
+uint16_t CAL_get_leave(void)
+{
+	if(u8_cal_cycle==0)
+	{
+		return 0;
+	}
+	return u16_cal_leave_sum/u8_cal_cycle;
+}
+
+//-------------------------------------- Get the longest time from the last pulse to STOP sensor activation (ms).
+uint16_t CAL_get_home(void)
+{
+	return u16_cal_home_max;
+}
+
+//-------------------------------------- Get spread of time to STOP between cycles (ms).
+uint16_t CAL_get_spread(void)
+{
+	if(u8_cal_cycle==0)
+	{
+		return 0;
+	}
+	return u16_cal_home_max-u16_cal_home_min;
+}
+
+//-------------------------------------- Get average time from the first pulse to the first tacho edge (ms, 0 - no edges).
+uint16_t CAL_get_tacho(void)
+{
+	if(u8_cal_tacho_cnt==0)
+	{
+		return 0;
+	}
+	return u16_cal_tacho_sum/u8_cal_tacho_cnt;
+}
+
+//-------------------------------------- Scale timing mark.
+// Returns [in_value]*[in_num]/[in_den] rounded up, or 0 if result does not fit into timer.
+uint8_t CAL_scale(uint8_t in_value, uint16_t in_num, uint16_t in_den)
+{
+	uint32_t u32_res;
+	u32_res = ((uint32_t)in_value*in_num+in_den-1)/in_den;
+	if((u32_res==0)||(u32_res>0xFF))
+	{
+		return 0;
+	}
+	return (uint8_t)u32_res;
+}
+
+//-------------------------------------- Check that selection mark is not too far from its default.
+// Returns 0 if [in_value] is within [CAL_MARK_DEV_MAX] of [in_default].
+uint8_t CAL_check_mark(uint8_t in_value, uint8_t in_default)
+{
+	uint8_t u8_dev;
+	u8_dev = (in_default>>CAL_MARK_DEV_MAX);
+	if((in_value<(in_default-u8_dev))||((uint16_t)in_value>((uint16_t)in_default+u8_dev)))
+	{
+		return 1;
+	}
+	return 0;
+}
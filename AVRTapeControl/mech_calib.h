@@ -0,0 +1,89 @@
+﻿/**************************************************************************************************************************************************************
+mech_calib.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-08-12
+
+Part of the [AVRTapeControl] project.
+Timing auto-calibration of single-solenoid tape transports for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+
+Calibration drives capstan and solenoid directly, mechanism state machine must not run at the same time.
+Mechanism provides a plan: a list of steps from STOP back to STOP, each step is a solenoid pulse and time until the next step (in ms).
+Plan is repeated [CAL_CYCLES] times, STOP sensor and tachometer are sampled each 1 ms (by [CAL_tick()]),
+for each cycle time from the first pulse to STOP sensor release and time from the last pulse to STOP sensor activation are taken.
+Mechanism derives selection marks of its timing profile from the time to STOP sensor release (gear speed, without margin)
+and timeouts from the longest time to STOP (with margin), see [mech_xxx_calib_profile()].
+
+**************************************************************************************************************************************************************/
+
+#ifndef MECH_CALIB_H_
+#define MECH_CALIB_H_
+
+#include <stdint.h>
+#include "drv_io.h"
+
+#define CAL_STEP_MAX		4			// Maximum number of steps in calibration plan
+#define CAL_CYCLES			8			// Number of measured cycles
+#define CAL_SPINUP_MS		700			// Capstan spin-up before the first cycle (ms)
+#define CAL_SETTLE_MS		200			// Pause in STOP between cycles (ms)
+#define CAL_SPREAD_MAX		3			// Maximum spread of time to STOP (as right shift of the time, 3 = 1/8 = 12.5%)
+#define CAL_MARK_DEV_MAX	2			// Maximum deviation of selection mark from its default (as right shift of the default, 2 = 1/4 = 25%)
+
+// Calibration plan layout (pair of values for each step).
+enum
+{
+	CAL_PLAN_PULSE,					// Solenoid pulse length (ms)
+	CAL_PLAN_STEP,					// Time from the start of the pulse to the next step (ms), last step waits for STOP up to twice as long
+	CAL_PLAN_SIZE
+};
+
+// Calibration states for [CAL_get_state()].
+enum
+{
+	CAL_ST_OFF,						// Calibration is not running
+	CAL_ST_SPINUP,					// Capstan spin-up
+	CAL_ST_STEP,					// Stepping through the plan
+	CAL_ST_SETTLE,					// Pause in STOP between cycles
+	CAL_ST_DONE,					// All cycles are measured
+	CAL_ST_FAIL						// Calibration failed (see [CAL_get_error()])
+};
+
+// Calibration errors for [CAL_get_error()].
+enum
+{
+	CAL_ERR_NONE,					// No error
+	CAL_ERR_NO_PLAN,				// Mechanism does not support calibration
+	CAL_ERR_NOT_STOP,				// Mechanism is not in STOP after spin-up
+	CAL_ERR_NO_LEAVE,				// STOP sensor was not released after the first step
+	CAL_ERR_NO_HOME,				// STOP sensor was not activated after the last step
+	CAL_ERR_UNSTABLE,				// Time to STOP varies too much between cycles
+	CAL_ERR_PROFILE					// Derived profile failed sanity check
+};
+
+void CAL_start(const uint16_t *in_plan, uint8_t in_steps);	// Start calibration with the plan ([in_steps] pairs of [CAL_PLAN_xxx] values)
+void CAL_fail(uint8_t in_err);								// Stop calibration with an error
+uint8_t CAL_tick(uint8_t in_stop, uint8_t in_tacho);		// Perform one step of calibration (must be called at 1 kHz), returns [CAL_ST_xxx]
+uint8_t CAL_get_state(void);								// Get calibration state ([CAL_ST_xxx])
+uint8_t CAL_is_running(void);								// Check if calibration drives the transport
+uint8_t CAL_get_error(void);								// Get calibration error ([CAL_ERR_xxx])
+uint16_t CAL_get_leave(void);								// Get average time from the first pulse to STOP sensor release (ms)
+uint16_t CAL_get_home(void);								// Get the longest time from the last pulse to STOP sensor activation (ms)
+uint16_t CAL_get_spread(void);								// Get spread of time to STOP between cycles (ms)
+uint16_t CAL_get_tacho(void);								// Get average time from the first pulse to the first tacho edge (ms, 0 - no edges)
+uint8_t CAL_scale(uint8_t in_value, uint16_t in_num, uint16_t in_den);	// Scale timing mark by [in_num]/[in_den] (rounded up, 0 if it does not fit)
+uint8_t CAL_check_mark(uint8_t in_value, uint8_t in_default);			// Check that selection mark is not too far from its default
+
+#endif /* MECH_CALIB_H_ */
@@ -6,21 +6,39 @@ uint8_t u8_crp42602y_error=TTR_ERR_NONE;				// Last transport error
 uint8_t u8_crp42602y_trans_timer=0;						// Solenoid holding timer
 uint16_t u16_crp42602y_idle_time=0;						// Timer for disabling capstan motor
 uint8_t u8_crp42602y_retries=0;							// Number of retries before transport halts
+uint8_t u8_crp42602y_chain_mode=TTR_42602_MODE_STOP;	// Active mode to start right after STOP is reached (fast auto-reverse, STOP - none)
+uint8_t u8_crp42602y_chain_settle=0;					// Timer for STOP sensor settling in fast auto-reverse
+uint8_t u8_crp42602y_spin_ticks=0;						// Time from the last tacho pulse during capstan spin-up (2 ms ticks)
+uint8_t u8_crp42602y_spin_period=0;						// Last tacho period during capstan spin-up (0 - no full period yet)
+uint8_t u8_crp42602y_spin_tacho=0;						// Last seen value of tacho timer (drops to 0 on each pulse)
+uint8_t u8_crp42602y_spin_stable=0;						// Number of consecutive matching tacho periods
+uint8_t u8_crp42602y_anchor=0;							// STOP sensor release is not yet seen in transition to active mode
 uint32_t u32_tach_cnt=0;
-
-#ifdef UART_TERM
-char u8a_crp42602y_buf[32];								// Buffer for UART debug messages
-#endif /* UART_TERM */
+uint8_t u8a_crp42602y_profile[PRF_42602_MAX] =			// Timing profile (defaults, see [PRF_42602_xxx])
+{
+	TIM_42602_DLY_STOP, TIM_42602_DLY_WAIT_HEAD, TIM_42602_DLY_HEAD_DIR, TIM_42602_DLY_WAIT_PINCH, TIM_42602_DLY_PINCH_EN,
+	TIM_42602_DLY_WAIT_TAKEUP, TIM_42602_DLY_TAKEUP_DIR, TIM_42602_DLY_WAIT_MODE, TIM_42602_DLY_ACTIVE, TIM_42602_DLY_WAIT_STOP,
+	TACHO_42602_STOP_DLY_MAX, TACHO_42602_PLAY_DLY_MAX, TACHO_42602_FWIND_DLY_MAX
+};
 
 #ifdef SUPP_CRP42602Y_MECH
 volatile const uint8_t ucaf_crp42602y_mech[] PROGMEM = "CRP42602Y mechanism (M02753900D)";
 #endif /* SUPP_CRP42602Y_MECH */
 
+// Default selection marks of the cyclogram [PRF_42602_DLY_STOP...PRF_42602_DLY_ACTIVE],
+// profile from EEPROM or calibration may not move them further than [CAL_MARK_DEV_MAX].
+const uint8_t ucaf_crp42602y_marks[] PROGMEM =
+{
+	TIM_42602_DLY_STOP, TIM_42602_DLY_WAIT_HEAD, TIM_42602_DLY_HEAD_DIR, TIM_42602_DLY_WAIT_PINCH, TIM_42602_DLY_PINCH_EN,
+	TIM_42602_DLY_WAIT_TAKEUP, TIM_42602_DLY_TAKEUP_DIR, TIM_42602_DLY_WAIT_MODE, TIM_42602_DLY_ACTIVE
+};
+
 //-------------------------------------- Freeze transport due to error.
 void mech_crp42602y_set_error(uint8_t in_err)
 {
 	u8_crp42602y_target_mode = TTR_42602_MODE_HALT;
 	u8_crp42602y_mode = TTR_42602_MODE_HALT;
+	u8_crp42602y_chain_mode = TTR_42602_MODE_STOP;
 	u8_crp42602y_error += in_err;
 }
 
@@ -86,12 +104,15 @@ void mech_crp42602y_static_halt(uint8_t in_sws, uint8_t *usr_mode)
 	{
 		// Transport is not in STOP mode.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		}
 #endif /* UART_TERM */
 		// Start capstan motor.
 		CAPSTAN_ON;
 		// Force STOP if transport is not in STOP.
-		u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+		u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 		u8_crp42602y_mode = TTR_42602_SUBMODE_TO_HALT;
 	}
 	else
@@ -103,12 +124,158 @@ void mech_crp42602y_static_halt(uint8_t in_sws, uint8_t *usr_mode)
 	}
 }
 
+//-------------------------------------- Start auto-reverse: transition to STOP with chained transition to reverse mode.
+// Capstan is known to be running in PLAYBACK/RECORD, so transition starts right away without [mech_crp42602y_target2mode()] checks
+// and reverse cyclogram starts as soon as STOP sensor settles instead of waiting for full [PRF_42602_DLY_WAIT_STOP] time.
+// [in_mode] - next active mode (user mode should be set to the same mode by the caller).
+void mech_crp42602y_fast_reverse(uint8_t in_mode)
+{
+#ifdef EN_FAST_AREV
+	u8_crp42602y_chain_mode = in_mode;
+	u8_crp42602y_chain_settle = 0;
+	u8_crp42602y_target_mode = TTR_42602_MODE_STOP;
+	u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
+	u8_crp42602y_mode = TTR_42602_SUBMODE_TO_STOP;
+#else
+	(void)in_mode;
+#endif /* EN_FAST_AREV */
+}
+
+//-------------------------------------- Re-anchor cyclogram timer at STOP sensor release.
+// Command gear releases STOP sensor at fixed point of its turn, but gear engagement after start pulse
+// and motor speed vary, so selection marks timed from the start pulse drift off the cam ranges.
+// On the first release in transition to active mode the timer is set to the point where release is expected,
+// so the rest of the selection marks follow the actual gear phase.
+// Release after the last selection mark or too far off from expected point (sensor bounce) is ignored.
+void mech_crp42602y_stop_anchor(uint8_t in_sws)
+{
+	uint8_t u8_elapsed, u8_expected, u8_shift;
+	if((u8_crp42602y_anchor==0)||((in_sws&TTR_SW_STOP)!=0))
+	{
+		return;
+	}
+	u8_crp42602y_anchor = 0;
+	if((u8_crp42602y_mode<TTR_42602_SUBMODE_ACT)||(u8_crp42602y_mode>=TTR_42602_SUBMODE_WAIT_RUN))
+	{
+		// No selection marks left to correct.
+		return;
+	}
+	u8_elapsed = u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8_crp42602y_trans_timer;
+	u8_expected = (uint8_t)(((uint16_t)TIM_42602_DLY_STOP_CLEAR*u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE])/TIM_42602_DLY_ACTIVE);
+	if(u8_elapsed>u8_expected)
+	{
+		u8_shift = u8_elapsed-u8_expected;
+	}
+	else
+	{
+		u8_shift = u8_expected-u8_elapsed;
+	}
+	if(u8_shift>TIM_42602_ANCHOR_MAX)
+	{
+		return;
+	}
+#ifdef UART_TERM
+	if((u8_shift!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_begin_line();
+		UART_add_flash_string((uint8_t *)cch_stop_anchor);
+		if(u8_elapsed>u8_expected)
+		{
+			UART_add_char('+');
+		}
+		else
+		{
+			UART_add_char('-');
+		}
+		UART_add_dec16(((uint16_t)u8_shift*2), 1); UART_add_flash_string((uint8_t *)cch_endl);
+		UART_end_line();
+	}
+#endif /* UART_TERM */
+	u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8_expected;
+}
+
+//-------------------------------------- Check if capstan has reached stable speed by takeup tacho period in STOP.
+// Should be called on each run of transition during start-up delay, timer of tacho signal [tacho] is reset by each tacho pulse.
+// Returns 1 when last [SPIN_42602_STABLE_CNT] periods match and are short enough for STOP, otherwise 0.
+uint8_t mech_crp42602y_spinup_done(uint8_t *tacho)
+{
+	uint8_t u8_diff;
+	if(u8_crp42602y_spin_ticks<0xFF)
+	{
+		u8_crp42602y_spin_ticks++;
+	}
+	if((*tacho)<u8_crp42602y_spin_tacho)
+	{
+		// Tacho timer was reset by a pulse.
+		if(u8_crp42602y_spin_period!=0)
+		{
+			// Compare with the previous period.
+			if(u8_crp42602y_spin_ticks>u8_crp42602y_spin_period)
+			{
+				u8_diff = u8_crp42602y_spin_ticks-u8_crp42602y_spin_period;
+			}
+			else
+			{
+				u8_diff = u8_crp42602y_spin_period-u8_crp42602y_spin_ticks;
+			}
+			// Period limit for STOP is in tacho timer units (20 ms = 10 ticks).
+			if((u8_diff<=((u8_crp42602y_spin_period>>SPIN_42602_TOLERANCE)+1))&&
+				((uint16_t)u8_crp42602y_spin_ticks<=((uint16_t)u8a_crp42602y_profile[PRF_42602_TACHO_STOP]*10)))
+			{
+				if(u8_crp42602y_spin_stable<0xFF)
+				{
+					u8_crp42602y_spin_stable++;
+				}
+			}
+			else
+			{
+				// Capstan is still accelerating.
+				u8_crp42602y_spin_stable = 0;
+			}
+		}
+		// First pulse only starts period measurement.
+		u8_crp42602y_spin_period = u8_crp42602y_spin_ticks;
+		if(u8_crp42602y_spin_period==0)
+		{
+			u8_crp42602y_spin_period = 1;
+		}
+		u8_crp42602y_spin_ticks = 0;
+	}
+	u8_crp42602y_spin_tacho = (*tacho);
+	if(u8_crp42602y_spin_stable>=SPIN_42602_STABLE_CNT)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+//-------------------------------------- Spin up capstan ahead of the first user command (cassette was just inserted).
+void mech_crp42602y_prespin(void)
+{
+	// Only from idle STOP with stopped capstan.
+	if((u8_crp42602y_trans_timer==0)&&(u8_crp42602y_mode==TTR_42602_MODE_STOP)&&
+		(u8_crp42602y_target_mode==TTR_42602_MODE_STOP)&&(CAPSTAN_STATE==0))
+	{
+#ifdef UART_TERM
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_prespin);
+		}
+#endif /* UART_TERM */
+		// Perform start-up delay and STOP check now, idle timeout will stop capstan if no command follows.
+		u8_crp42602y_target_mode = TTR_42602_MODE_TO_INIT;
+	}
+}
+
 //-------------------------------------- Start transition from current mode to target mode.
 void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_target2current1); mech_crp42602y_UART_dump_mode(u8_crp42602y_mode);
-	UART_add_flash_string((uint8_t *)cch_target2current2); mech_crp42602y_UART_dump_mode(u8_crp42602y_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_target2current1); mech_crp42602y_UART_dump_mode(u8_crp42602y_mode);
+		UART_add_flash_string((uint8_t *)cch_target2current2); mech_crp42602y_UART_dump_mode(u8_crp42602y_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	// Before any transition...
 	// Turn on mute.
@@ -121,7 +288,10 @@ void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mod
 	{
 		// Capstan is stopped.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_capst_start);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_capst_start);
+		}
 #endif /* UART_TERM */
 		// Override target mode to perform capstan spinup wait.
 		u8_crp42602y_target_mode = TTR_42602_MODE_TO_INIT;
@@ -134,19 +304,28 @@ void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mod
 	{
 		// Target mode: start-up delay.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_startup_delay);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_startup_delay);
+		}
 #endif /* UART_TERM */
-		// Set time for waiting for mechanism to stabilize.
-		u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+		// Set time for waiting for mechanism to stabilize
+		// (upper bound, it can be cut short by tacho, see [mech_crp42602y_spinup_done()]).
+		u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 		// Put transport in init waiting mode.
 		u8_crp42602y_mode = TTR_42602_SUBMODE_INIT;
 		// Move target to STOP mode.
 		u8_crp42602y_target_mode = TTR_42602_MODE_STOP;
+		// Restart spin-up detection.
+		u8_crp42602y_spin_ticks = 0;
+		u8_crp42602y_spin_period = 0;
+		u8_crp42602y_spin_tacho = 0;
+		u8_crp42602y_spin_stable = 0;
 	}
 	else if(u8_crp42602y_target_mode==TTR_42602_MODE_STOP)
 	{
 		// Target mode: full stop.
-		u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+		u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 		u8_crp42602y_mode = TTR_42602_SUBMODE_TO_STOP;
 	}
 	else if(u8_crp42602y_target_mode==TTR_42602_MODE_HALT)
@@ -166,7 +345,10 @@ void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mod
 				{
 					// Record in forward direction is inhibited.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_record);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_record);
+					}
 #endif /* UART_TERM */
 					// Convert RECORD to PLAYBACK.
 					u8_crp42602y_target_mode = TTR_42602_MODE_PB_FWD;
@@ -178,21 +360,27 @@ void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mod
 				{
 					// Record in forward direction is inhibited.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_record);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_record);
+					}
 #endif /* UART_TERM */
 					// Convert RECORD to PLAYBACK.
 					u8_crp42602y_target_mode = TTR_42602_MODE_PB_REV;
 				}
 			}
 			// Start transition to active mode.
-			u8_crp42602y_trans_timer = TIM_42602_DLY_ACTIVE;
+			u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE];
 			u8_crp42602y_mode = TTR_42602_SUBMODE_TO_ACTIVE;
 		}
 		else
 		{
 			// Unknown mode, reset to STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			}
 #endif /* UART_TERM */
 			u8_crp42602y_target_mode = TTR_42602_MODE_STOP;
 			(*usr_mode) = USR_MODE_STOP;
@@ -206,8 +394,11 @@ void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mod
 void mech_crp42602y_user2target(uint8_t *usr_mode, uint8_t *play_dir)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_user2target1); mech_crp42602y_UART_dump_mode(u8_crp42602y_target_mode);
-	UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_user2target1); mech_crp42602y_UART_dump_mode(u8_crp42602y_target_mode);
+		UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	if(u8_crp42602y_target_mode!=TTR_42602_MODE_STOP)
 	{
@@ -243,21 +434,24 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 		{
 			// Transport is not in STOP mode.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			}
 #endif /* UART_TERM */
 			// Increase number of retries before failing.
 			u8_crp42602y_retries++;
 			if(u8_crp42602y_retries>=MODE_REP_MAX)
 			{
 				// Maximum retries, to go HALT.
-				u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+				u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 				u8_crp42602y_mode = TTR_42602_SUBMODE_INIT;
 				u8_crp42602y_target_mode = TTR_42602_MODE_HALT;
 			}
 			else
 			{
 				// Force STOP if transport is not in STOP.
-				u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+				u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 				u8_crp42602y_mode = TTR_42602_SUBMODE_TO_STOP;
 			}
 		}
@@ -271,12 +465,15 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 				if(CAPSTAN_STATE!=0)
 				{
 					// Checking tacho in STOP enabled.
-					if((*tacho)>TACHO_42602_STOP_DLY_MAX)
+					if((*tacho)>u8a_crp42602y_profile[PRF_42602_TACHO_STOP])
 					{
 						// No signal from takeup tachometer for too long.
 #ifdef UART_TERM
-						UART_add_flash_string((uint8_t *)cch_stop_tacho); UART_add_flash_string((uint8_t *)cch_endl);
-						UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop1);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+						{
+							UART_add_flash_string((uint8_t *)cch_stop_tacho); UART_add_flash_string((uint8_t *)cch_endl);
+							UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop1);
+						}
 #endif /* UART_TERM */
 						// No motor drive or bad belts, register an error.
 						mech_crp42602y_set_error(TTR_ERR_BAD_DRIVE);
@@ -299,7 +496,7 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 		// Reset idle timer.
 		u16_crp42602y_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_42602_PLAY_DLY_MAX)
+		if((*tacho)>u8a_crp42602y_profile[PRF_42602_TACHO_PLAY])
 		{
 			// No signal from takeup tachometer for too long.
 			// Turn mute on.
@@ -325,10 +522,14 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 						// Currently: playback in forward.
 						// Next: playback in reverse.
 #ifdef UART_TERM
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+						}
 #endif /* UART_TERM */
 						// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 						(*usr_mode) = USR_MODE_PLAY_REV;
+						mech_crp42602y_fast_reverse(TTR_42602_MODE_PB_REV);
 					}
 					else if(u8_crp42602y_mode==TTR_42602_MODE_PB_REV)
 					{
@@ -338,10 +539,14 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: playback in reverse, infinite loop auto-reverse is enabled.
 							// Next: playback in forward.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+							}
 #endif /* UART_TERM */
 							// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 							(*usr_mode) = USR_MODE_PLAY_FWD;
+							mech_crp42602y_fast_reverse(TTR_42602_MODE_PB_FWD);
 						}
 					}
 					else if(u8_crp42602y_mode==TTR_42602_MODE_RC_FWD)
@@ -352,10 +557,14 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: recording in forward, recording in reverse is allowed.
 							// Next: recording in reverse.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+							}
 #endif /* UART_TERM */
 							// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 							(*usr_mode) = USR_MODE_REC_REV;
+							mech_crp42602y_fast_reverse(TTR_42602_MODE_RC_REV);
 						}
 						else if((in_srv_features&SRV_FEA_PBF2REW)!=0)
 						{
@@ -363,7 +572,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: recording in forward, recording in reverse is inhibited, auto-rewind is enabled.
 							// Next: rewind.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							}
 #endif /* UART_TERM */
 							// Queue rewind.
 							(*usr_mode) = USR_MODE_FWIND_REV;
@@ -374,7 +586,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: recording in forward, recording in reverse is inhibited, auto-rewind is disabled.
 							// Next: stop.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							}
 #endif /* UART_TERM */
 							// Make next playback direction in reverse direction after auto-stop.
 							(*play_dir) = PB_DIR_REV;
@@ -387,17 +602,24 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 						// Currently: recording in reverse, infinite loop auto-reverse is enabled, recording in forward is allowed.
 						// Next: recording in forward.
 #ifdef UART_TERM
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+						}
 #endif /* UART_TERM */
 						// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 						(*usr_mode) = USR_MODE_REC_FWD;
+						mech_crp42602y_fast_reverse(TTR_42602_MODE_RC_FWD);
 					}
 #ifdef UART_TERM
 					else
 					{
 						// Reverse ops: enabled, auto-reverse enabled.
 						// All other combinations, next mode: stop.
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						}
 						// Stop mode already queued.
 					}
 #endif /* UART_TERM */
@@ -415,7 +637,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: playback or recording in forward, auto-rewind is enabled.
 							// Next: rewind.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							}
 #endif /* UART_TERM */
 							// Queue rewind.
 							(*usr_mode) = USR_MODE_FWIND_REV;
@@ -426,7 +651,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 							// Currently: playback or recording in forward, auto-rewind is disabled.
 							// Next: stop.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							}
 #endif /* UART_TERM */
 							// Make next playback direction in reverse direction after auto-stop.
 							(*play_dir) = PB_DIR_REV;
@@ -439,7 +667,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 						// Reverse ops: enabled, auto-reverse disabled.
 						// Currently: playback or recording in reverse.
 						// Next: stop.
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						}
 						// STOP mode already queued.
 					}
 #endif /* UART_TERM */
@@ -451,7 +682,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 				// Currently: playback or recording in forward, auto-rewind is enabled.
 				// Next: rewind.
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				}
 #endif /* UART_TERM */
 				// Queue rewind.
 				(*usr_mode) = USR_MODE_FWIND_REV;
@@ -462,7 +696,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 				// Reverse ops: disabled.
 				// Currently: playback or recording in forward, auto-rewind is disabled.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				}
 				// STOP mode already queued.
 			}
 #endif /* UART_TERM */
@@ -483,12 +720,15 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic state to correspond with reality.
 			u8_crp42602y_mode = TTR_42602_MODE_STOP;
 			u8_crp42602y_target_mode = TTR_42602_MODE_STOP;
-			u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+			u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -506,7 +746,7 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 		// Reset idle timer.
 		u16_crp42602y_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_42602_FWIND_DLY_MAX)
+		if((*tacho)>u8a_crp42602y_profile[PRF_42602_TACHO_FWIND])
 		{
 			// No signal from takeup tachometer for too long.
 			// Perform auto-stop.
@@ -524,7 +764,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 					// Currently: fast wind in forward direction, auto-rewind is enabled.
 					// Next: rewind.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					}
 #endif /* UART_TERM */
 					// Set mode to rewind.
 					(*usr_mode) = USR_MODE_FWIND_REV;
@@ -534,7 +777,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 					// Currently: fast wind in forward direction, auto-rewind is disabled.
 					// Next: stop.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					}
 #endif /* UART_TERM */
 					// Check if reverse functions are enabled.
 					if((in_ttr_features&TTR_FEA_REV_ENABLE)!=0)
@@ -550,7 +796,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 			{
 				// Currently: fast wind in reverse direction.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				}
 				// STOP mode already queued.
 			}
 #endif /* UART_TERM */
@@ -560,12 +809,15 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic mode.
 			u8_crp42602y_mode = TTR_42602_MODE_STOP;
 			u8_crp42602y_target_mode = TTR_42602_MODE_STOP;
-			u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+			u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -575,6 +827,10 @@ void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features
 //-------------------------------------- Transition through modes, timing solenoid.
 void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 {
+#ifdef EN_STOP_ANCHOR
+	// Correct selection marks by actual phase of the command gear.
+	mech_crp42602y_stop_anchor(in_sws);
+#endif /* EN_STOP_ANCHOR */
 	if(u8_crp42602y_mode==TTR_42602_SUBMODE_INIT)
 	{
 		// Desired mode: spin-up capstan, wait for TTR to stabilize.
@@ -600,7 +856,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 		CAPSTAN_ON;
 		// Activate solenoid in to initiate mode change to STOP.
 		SOLENOID_ON;
-		if(u8_crp42602y_trans_timer<=(TIM_42602_DLY_WAIT_STOP-TIM_42602_DLY_STOP))
+		if(u8_crp42602y_trans_timer<=(u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP]-u8a_crp42602y_profile[PRF_42602_DLY_STOP]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Deactivate solenoid.
@@ -614,26 +870,63 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 		// Transitioning to STOP mode.
 		// Deactivate solenoid.
 		SOLENOID_OFF;
-		if(u8_crp42602y_trans_timer==0)
+		if((u8_crp42602y_chain_mode!=TTR_42602_MODE_STOP)&&(u8_crp42602y_trans_timer!=0))
+		{
+			// Fast auto-reverse is pending, no need to wait for full transition time.
+			if((in_sws&TTR_SW_STOP)!=0)
+			{
+				u8_crp42602y_chain_settle++;
+				if(u8_crp42602y_chain_settle>=TIM_42602_DLY_AREV_SETTLE)
+				{
+					// Mechanism reached STOP, start transition to reverse mode right away.
+#ifdef UART_TERM
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_fast_reverse); mech_crp42602y_UART_dump_mode(u8_crp42602y_chain_mode); UART_add_flash_string((uint8_t *)cch_endl);
+					}
+#endif /* UART_TERM */
+					u8_crp42602y_retries = 0;
+					u8_crp42602y_target_mode = u8_crp42602y_chain_mode;
+					u8_crp42602y_chain_mode = TTR_42602_MODE_STOP;
+					u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE];
+					u8_crp42602y_mode = TTR_42602_SUBMODE_TO_ACTIVE;
+				}
+			}
+			else
+			{
+				// Sensor bounce or not there yet.
+				u8_crp42602y_chain_settle = 0;
+			}
+		}
+		else if(u8_crp42602y_trans_timer==0)
 		{
 			// Transition is done.
+			// STOP sensor was not caught in time for fast auto-reverse, next mode will be selected in regular way.
+			u8_crp42602y_chain_mode = TTR_42602_MODE_STOP;
 			// Save new transport state.
 			u8_crp42602y_mode = TTR_42602_MODE_STOP;
 			// Check if mechanical STOP state wasn't reached.
 			if((in_sws&TTR_SW_STOP)==0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_mode_failed);
-				sprintf(u8a_crp42602y_buf, " %01u\n\r", u8_crp42602y_retries);
-				UART_add_string(u8a_crp42602y_buf);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+				{
+					UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_begin_line();
+					UART_add_flash_string((uint8_t *)cch_mode_failed);
+					UART_add_char(' '); UART_add_dec8(u8_crp42602y_retries, 1); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_end_line();
+				}
 #endif /* UART_TERM */
 				// Increase number of retries before failing.
 				u8_crp42602y_retries++;
 				if(u8_crp42602y_retries>=MODE_REP_MAX)
 				{
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+					{
+						UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					}
 #endif /* UART_TERM */
 					// Mechanically mode didn't change from active, register an error.
 					mech_crp42602y_set_error(TTR_ERR_NO_CTRL);
@@ -641,7 +934,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 				else
 				{
 					// Repeat transition to STOP.
-					u8_crp42602y_trans_timer = TIM_42602_DLY_WAIT_STOP;
+					u8_crp42602y_trans_timer = u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP];
 					u8_crp42602y_mode = TTR_42602_SUBMODE_TO_STOP;
 				}
 			}
@@ -670,13 +963,15 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			// Direction: reverse.
 			(*play_dir) = PB_DIR_REV;
 		}
+		// Wait for the command gear to release STOP sensor.
+		u8_crp42602y_anchor = 1;
 		u8_crp42602y_mode = TTR_42602_SUBMODE_ACT;
 	}
 	else if(u8_crp42602y_mode==TTR_42602_SUBMODE_ACT)
 	{
 		// Transitioning to active mode.
 		// Waiting for first "gray zone" before pinch/head direction selection.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_WAIT_HEAD))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_WAIT_HEAD]))
 		{
 			// Go to the next stage.
 			u8_crp42602y_mode = TTR_42602_SUBMODE_WAIT_DIR;
@@ -710,7 +1005,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for first decision point: pinch/head direction.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_HEAD_DIR))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_HEAD_DIR]))
 		{
 			// Decision point reached.
 			// Pinch/head direction range.
@@ -734,7 +1029,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for second "gray zone" before pinch engage selection.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_WAIT_PINCH))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_WAIT_PINCH]))
 		{
 			// Pinch direction selection finished, wait for pinch range.
 			u8_crp42602y_mode = TTR_42602_SUBMODE_WAIT_PINCH;
@@ -746,7 +1041,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for second decision point: pinch engage.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_PINCH_EN))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_PINCH_EN]))
 		{
 			// Decision point reached.
 			// Pinch engage range.
@@ -770,7 +1065,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for third "gray zone" before takeup direction selection.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_WAIT_TAKEUP))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_WAIT_TAKEUP]))
 		{
 			// Pinch roller activation range done, wait for takeup direction range.
 			u8_crp42602y_mode = TTR_42602_SUBMODE_WAIT_TAKEUP;
@@ -796,7 +1091,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for third decision point: takeup direction.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_TAKEUP_DIR))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_TAKEUP_DIR]))
 		{
 			// Decision point reached.
 			// Takeup direction range.
@@ -820,7 +1115,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	{
 		// Transitioning to active mode.
 		// Waiting for deactivating point.
-		if(u8_crp42602y_trans_timer<(TIM_42602_DLY_ACTIVE-TIM_42602_DLY_WAIT_MODE))
+		if(u8_crp42602y_trans_timer<(u8a_crp42602y_profile[PRF_42602_DLY_ACTIVE]-u8a_crp42602y_profile[PRF_42602_DLY_WAIT_MODE]))
 		{
 			// Every decision was make, now just waiting for cycle to finish.
 			u8_crp42602y_mode = TTR_42602_SUBMODE_WAIT_RUN;
@@ -843,8 +1138,11 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			if((in_sws&TTR_SW_STOP)!=0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+				{
+					UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				}
 #endif /* UART_TERM */
 				// Mechanically mode didn't change from STOP, register an error.
 				mech_crp42602y_set_error(TTR_ERR_NO_CTRL);
@@ -880,7 +1178,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	else if(u8_crp42602y_mode==TTR_42602_MODE_HALT)
 	{
 		// Desired mode: recovery STOP in HALT mode.
-		if(u8_crp42602y_trans_timer<=(TIM_42602_DLY_WAIT_STOP-TIM_42602_DLY_STOP))
+		if(u8_crp42602y_trans_timer<=(u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP]-u8a_crp42602y_profile[PRF_42602_DLY_STOP]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Deactivate solenoid while waiting for transport to transition to STOP.
@@ -889,7 +1187,7 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	}
 	
 #ifdef UART_TERM
-	if((u8_crp42602y_trans_timer==0)&&(u8_crp42602y_mode!=TTR_42602_MODE_HALT))
+	if((u8_crp42602y_trans_timer==0)&&(u8_crp42602y_mode!=TTR_42602_MODE_HALT)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 	{
 		UART_add_flash_string((uint8_t *)cch_mode_done); UART_add_flash_string((uint8_t *)cch_arrow);
 		mech_crp42602y_UART_dump_mode(u8_crp42602y_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
@@ -905,7 +1203,10 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 	{
 		// Register logic error.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		}
 #endif /* UART_TERM */
 		mech_crp42602y_set_error(TTR_ERR_LOGIC_FAULT);
 	}
@@ -917,7 +1218,7 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 		(*play_dir) = PB_DIR_FWD;
 #ifdef UART_TERM
 		// Check if transport was in active mode last time.
-		if((*usr_mode)!=USR_MODE_STOP)
+		if(((*usr_mode)!=USR_MODE_STOP)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 		{
 			// Tape was moving, dump a message about lost tape.
 			UART_add_flash_string((uint8_t *)cch_no_tape);
@@ -949,6 +1250,13 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 		else if(u8_crp42602y_target_mode!=u8_crp42602y_mode)
 		{
 			// Target transport mode is not the same as current transport mode (need to start transition to another mode).
+#ifdef EN_IDLE_ADAPT
+			if((u8_crp42602y_mode==TTR_42602_MODE_STOP)&&(u8_crp42602y_target_mode!=TTR_42602_MODE_TO_INIT)&&((in_sws&TTR_SW_TAPE_IN)!=0))
+			{
+				// Transport leaves idle STOP, let capstan shutdown policy learn the gap.
+				IDL_log_gap(u16_crp42602y_idle_time, (CAPSTAN_STATE!=0));
+			}
+#endif /* EN_IDLE_ADAPT */
 			mech_crp42602y_target2mode(in_sws, tacho, usr_mode);
 		}
 		// Transport is not in error and is in stable state (target mode reached),
@@ -971,7 +1279,7 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 			if(u16_crp42602y_idle_time>=IDLE_CAP_NO_TAPE)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
@@ -983,10 +1291,10 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 		else
 		{
 			// Tape is loaded.
-			if(u16_crp42602y_idle_time>=IDLE_CAP_TAPE_IN)
+			if(u16_crp42602y_idle_time>=IDLE_CAP_TAPE_TIMEOUT)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
@@ -999,10 +1307,33 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 	else
 	{
 		// Transport is performing mode transition.
+		// Check if start-up delay can be cut short (takeup tacho pulses in STOP on some mechanisms).
+		if((u8_crp42602y_mode==TTR_42602_SUBMODE_INIT)&&(u8_crp42602y_target_mode==TTR_42602_MODE_STOP)&&
+			((in_ttr_features&TTR_FEA_STOP_TACHO)!=0)&&((in_sws&TTR_SW_STOP)!=0)&&(mech_crp42602y_spinup_done(tacho)!=0))
+		{
+#ifdef UART_TERM
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+			{
+				UART_begin_line();
+				UART_add_flash_string((uint8_t *)cch_spinup_done);
+				UART_add_dec16(((uint16_t)(u8a_crp42602y_profile[PRF_42602_DLY_WAIT_STOP]-u8_crp42602y_trans_timer+1)*2), 1);
+				UART_add_flash_string((uint8_t *)cch_wake_unit);
+				UART_end_line();
+			}
+#endif /* UART_TERM */
+			// Capstan is up to speed, finish start-up delay on this run.
+			u8_crp42602y_trans_timer = 1;
+		}
 		// Count down mode transition timer.
 		u8_crp42602y_trans_timer--;
 		// Reset idle timer.
 		u16_crp42602y_idle_time = 0;
+		// Check if user changed mind during fast auto-reverse.
+		if((u8_crp42602y_chain_mode!=TTR_42602_MODE_STOP)&&(mech_crp42602y_user_to_transport((*usr_mode), play_dir)!=u8_crp42602y_chain_mode))
+		{
+			// Finish transition to STOP in regular way, user mode will be applied after that.
+			u8_crp42602y_chain_mode = TTR_42602_MODE_STOP;
+		}
 		// Mode transition cyclogram.
 		mech_crp42602y_cyclogram(in_sws, play_dir);
 		// Check if transition just finished.
@@ -1021,11 +1352,9 @@ void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_featur
 		DBG_MODE_ACT_ON;
 	}
 #ifdef UART_TERM
-	if((u8_crp42602y_trans_timer==1)||(u8_crp42602y_target_mode!=u8_crp42602y_mode))
+	if(((u8_crp42602y_trans_timer==1)||(u8_crp42602y_target_mode!=u8_crp42602y_mode))&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
 	{
-		sprintf(u8a_crp42602y_buf, "MODE|>t%03u<|u%01u}%01u>%01u|0x%02x\n\r",
-				u8_crp42602y_trans_timer, (*usr_mode), u8_crp42602y_mode, u8_crp42602y_target_mode, in_sws);
-		UART_add_string(u8a_crp42602y_buf);
+		UART_dump_mech_state(u8_crp42602y_trans_timer, (*usr_mode), u8_crp42602y_mode, u8_crp42602y_target_mode, in_sws);
 	}
 #endif /* UART_TERM */
 }
@@ -1066,12 +1395,124 @@ uint8_t mech_crp42602y_get_transition()
 	return u8_crp42602y_trans_timer;
 }
 
+//-------------------------------------- Get current internal transport mode.
+uint8_t mech_crp42602y_get_state()
+{
+	return u8_crp42602y_mode;
+}
+
+//-------------------------------------- Get target internal transport mode.
+uint8_t mech_crp42602y_get_target()
+{
+	return u8_crp42602y_target_mode;
+}
+
 //-------------------------------------- Get transport error.
 uint8_t mech_crp42602y_get_error()
 {
 	return u8_crp42602y_error;
 }
 
+//-------------------------------------- Get number of mode transition retries.
+uint8_t mech_crp42602y_get_retries()
+{
+	return u8_crp42602y_retries;
+}
+
+//-------------------------------------- Replace timing profile (if it passes sanity check).
+// Returns 0 if profile is applied, otherwise current profile is kept.
+uint8_t mech_crp42602y_set_profile(const uint8_t *in_profile)
+{
+	uint8_t u8_idx;
+	// Selection ranges of the cyclogram must follow in order before the end of transition.
+	for(u8_idx=PRF_42602_DLY_WAIT_HEAD;u8_idx<PRF_42602_DLY_ACTIVE;u8_idx++)
+	{
+		if(in_profile[u8_idx]>=in_profile[u8_idx+1])
+		{
+			return 1;
+		}
+	}
+	// Starting pulse must end before transition to STOP is over.
+	if(in_profile[PRF_42602_DLY_STOP]>=in_profile[PRF_42602_DLY_WAIT_STOP])
+	{
+		return 1;
+	}
+	// Selection marks must stay near the cam positions they are made for.
+	for(u8_idx=PRF_42602_DLY_STOP;u8_idx<=PRF_42602_DLY_ACTIVE;u8_idx++)
+	{
+		if(CAL_check_mark(in_profile[u8_idx], pgm_read_byte(&ucaf_crp42602y_marks[u8_idx]))!=0)
+		{
+			return 1;
+		}
+	}
+	// Zero tacho timeout will halt the transport right away.
+	for(u8_idx=PRF_42602_TACHO_STOP;u8_idx<PRF_42602_MAX;u8_idx++)
+	{
+		if(in_profile[u8_idx]==0)
+		{
+			return 1;
+		}
+	}
+	for(u8_idx=0;u8_idx<PRF_42602_MAX;u8_idx++)
+	{
+		u8a_crp42602y_profile[u8_idx] = in_profile[u8_idx];
+	}
+	return 0;
+}
+
+//-------------------------------------- Get current timing profile.
+const uint8_t *mech_crp42602y_get_profile()
+{
+	return u8a_crp42602y_profile;
+}
+
+//-------------------------------------- Fill calibration plan for [CAL_start()].
+// One cycle: start pulse from STOP into active mode, then pulse back to STOP.
+// Returns number of steps in the plan.
+uint8_t mech_crp42602y_calib_plan(uint16_t *out_plan)
+{
+	out_plan[CAL_PLAN_PULSE] = (uint16_t)TIM_42602_DLY_WAIT_HEAD*2;
+	out_plan[CAL_PLAN_STEP] = (uint16_t)TIM_42602_DLY_ACTIVE*2;
+	out_plan[CAL_PLAN_SIZE+CAL_PLAN_PULSE] = (uint16_t)TIM_42602_DLY_STOP*2;
+	out_plan[CAL_PLAN_SIZE+CAL_PLAN_STEP] = (uint16_t)TIM_42602_DLY_WAIT_STOP*2;
+	return 2;
+}
+
+//-------------------------------------- Derive timing profile from measured times.
+// [in_leave] - average time from the start pulse to STOP sensor release (ms);
+// [in_home] - the longest time from the start of STOP pulse to STOP sensor activation (ms).
+// Cam gear turns at fixed speed set by the capstan, so cyclogram marks [PRF_42602_DLY_STOP...PRF_42602_DLY_ACTIVE]
+// are scaled from the defaults by measured gear speed (STOP sensor release vs. [TIM_42602_DLY_STOP_CLEAR]) without margin,
+// only [PRF_42602_DLY_WAIT_STOP] timeout gets 25% margin over measured time to STOP.
+// Tacho timeouts are kept from current profile.
+// Returns 0 if profile fits into the timer.
+uint8_t mech_crp42602y_calib_profile(uint16_t in_leave, uint16_t in_home, uint8_t *out_profile)
+{
+	uint8_t u8_idx;
+	uint16_t u16_wait_stop;
+	// Scale selection marks by gear speed.
+	for(u8_idx=PRF_42602_DLY_STOP;u8_idx<=PRF_42602_DLY_ACTIVE;u8_idx++)
+	{
+		out_profile[u8_idx] = CAL_scale(pgm_read_byte(&ucaf_crp42602y_marks[u8_idx]), in_leave, (uint16_t)TIM_42602_DLY_STOP_CLEAR*2);
+		if(out_profile[u8_idx]==0)
+		{
+			return 1;
+		}
+	}
+	// Convert to 2 ms ticks with margin.
+	u16_wait_stop = (in_home+in_home/4)/2;
+	if((u16_wait_stop==0)||(u16_wait_stop>0xFF))
+	{
+		return 1;
+	}
+	out_profile[PRF_42602_DLY_WAIT_STOP] = (uint8_t)u16_wait_stop;
+	for(u8_idx=PRF_42602_TACHO_STOP;u8_idx<PRF_42602_MAX;u8_idx++)
+	{
+		out_profile[u8_idx] = u8a_crp42602y_profile[u8_idx];
+	}
+	return 0;
+}
+
 //-------------------------------------- Print transport mode alias.
 void mech_crp42602y_UART_dump_mode(uint8_t in_mode)
 {
@@ -1167,5 +1608,7 @@ void mech_crp42602y_UART_dump_mode(uint8_t in_mode)
 			UART_add_flash_string((uint8_t *)cch_mode_unknown);
 		}
 	}
+#else
+	(void)in_mode;
 #endif /* UART_TERM */
 }
@@ -27,6 +27,8 @@ Also this mechanism has takeup tachometer sensor on drive pulley and it pulses i
 
 #include "drv_io.h"
 #include "strings.h"
+#include "idle_policy.h"
+#include "mech_calib.h"
 
 // Timer marks for various modes for CRP42602Y mechanism, contained in [u8_crp42602y_trans_timer].
 // Each tick = 2 ms real time.
@@ -40,6 +42,9 @@ Also this mechanism has takeup tachometer sensor on drive pulley and it pulses i
 #define TIM_42602_DLY_WAIT_MODE		184		// 368 ms (end of takeup direction selection range, waiting for transition to active mode)
 #define TIM_42602_DLY_ACTIVE		210		// 420 ms (time for full transition STOP -> ACTIVE)
 #define TIM_42602_DLY_WAIT_STOP		160		// 320 ms (time for full transition ACTIVE -> STOP)
+#define TIM_42602_DLY_AREV_SETTLE	5		// 10 ms  (STOP sensor settle time before starting reverse cyclogram in fast auto-reverse)
+#define TIM_42602_DLY_STOP_CLEAR	30		// 60 ms  (command gear releases STOP sensor after start pulse, scaled with [PRF_42602_DLY_ACTIVE])
+#define TIM_42602_ANCHOR_MAX		25		// 50 ms  (maximum cyclogram timer correction by STOP sensor release, larger shift is ignored)
 
 // Maximum wait for next tacho tick for various modes, contained in [u8_tacho_timer].
 // Each tick = 20 ms real time.
@@ -47,6 +52,30 @@ Also this mechanism has takeup tachometer sensor on drive pulley and it pulses i
 #define TACHO_42602_PLAY_DLY_MAX	50		// 1000 ms (1.1...2.6 Hz)
 #define TACHO_42602_FWIND_DLY_MAX	10		// 120 ms (19.5...21 Hz)
 
+// Capstan spin-up detection by takeup tachometer in STOP (with [TTR_FEA_STOP_TACHO]).
+#define SPIN_42602_STABLE_CNT		2		// Number of consecutive tacho periods that must match to consider capstan speed stable
+#define SPIN_42602_TOLERANCE		3		// Allowed period difference (as right shift of the period, 3 = 1/8 = 12.5%)
+
+// Timing profile for CRP42602Y mechanism in [u8a_crp42602y_profile] (values above are defaults).
+// Profile can be replaced from EEPROM settings with [mech_crp42602y_set_profile()].
+enum
+{
+	PRF_42602_DLY_STOP,
+	PRF_42602_DLY_WAIT_HEAD,
+	PRF_42602_DLY_HEAD_DIR,
+	PRF_42602_DLY_WAIT_PINCH,
+	PRF_42602_DLY_PINCH_EN,
+	PRF_42602_DLY_WAIT_TAKEUP,
+	PRF_42602_DLY_TAKEUP_DIR,
+	PRF_42602_DLY_WAIT_MODE,
+	PRF_42602_DLY_ACTIVE,
+	PRF_42602_DLY_WAIT_STOP,
+	PRF_42602_TACHO_STOP,
+	PRF_42602_TACHO_PLAY,
+	PRF_42602_TACHO_FWIND,
+	PRF_42602_MAX					// Profile size
+};
+
 // States of CRP42602Y mechanism for [u8_crp42602y_target_mode] and [u8_crp42602y_mode] (including "SUBMODES").
 enum
 {
@@ -82,6 +111,10 @@ extern volatile const uint8_t ucaf_crp42602y_mech[];
 void mech_crp42602y_set_error(uint8_t in_err);							// Freeze transport due to error
 uint8_t mech_crp42602y_user_to_transport(uint8_t in_mode, uint8_t *play_dir);		// Convert user mode to transport mode
 void mech_crp42602y_static_halt(uint8_t in_sws, uint8_t *usr_mode);		// Transport operations are halted, keep mechanism in this state
+void mech_crp42602y_fast_reverse(uint8_t in_mode);						// Start auto-reverse: transition to STOP with chained transition to reverse mode
+uint8_t mech_crp42602y_spinup_done(uint8_t *tacho);						// Check if capstan has reached stable speed by takeup tacho period in STOP
+void mech_crp42602y_prespin(void);										// Spin up capstan ahead of the first user command
+void mech_crp42602y_stop_anchor(uint8_t in_sws);						// Re-anchor cyclogram timer at STOP sensor release
 void mech_crp42602y_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode);	// Start transition from current mode to target mode
 void mech_crp42602y_user2target(uint8_t *usr_mode, uint8_t *play_dir);	// Take in user desired mode and set new target mode
 void mech_crp42602y_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode, uint8_t *play_dir);	// Control mechanism in static mode (not transitioning between modes)
@@ -89,5 +122,12 @@ void mech_crp42602y_cyclogram(uint8_t in_sws, uint8_t *play_dir);		// Transition
 void mech_crp42602y_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode, uint8_t *play_dir);	// Perform tape transport state machine
 uint8_t mech_crp42602y_get_mode();										// Get user-level mode of the transport
 uint8_t mech_crp42602y_get_transition();								// Get transition timer count
+uint8_t mech_crp42602y_get_state();										// Get current internal mode of the transport (including submodes)
+uint8_t mech_crp42602y_get_target();									// Get target internal mode of the transport
 uint8_t mech_crp42602y_get_error();										// Get transport error
+uint8_t mech_crp42602y_get_retries();									// Get number of mode transition retries
+uint8_t mech_crp42602y_set_profile(const uint8_t *in_profile);			// Replace timing profile (if it passes sanity check)
+const uint8_t *mech_crp42602y_get_profile();							// Get current timing profile
+uint8_t mech_crp42602y_calib_plan(uint16_t *out_plan);					// Fill calibration plan for [CAL_start()], returns number of steps
+uint8_t mech_crp42602y_calib_profile(uint16_t in_leave, uint16_t in_home, uint8_t *out_profile);	// Derive timing profile from measured times to STOP release and to STOP
 void mech_crp42602y_UART_dump_mode(uint8_t in_mode);					// Print transport mode alias
@@ -6,10 +6,11 @@ uint8_t u8_knwd_error=TTR_ERR_NONE;					// Last transport error
 uint8_t u8_knwd_trans_timer=0;						// Solenoid holding timer
 uint16_t u16_knwd_idle_time=0;						// Timer for disabling capstan motor
 uint8_t u8_knwd_retries=0;							// Number of retries before transport halts
-
-#ifdef UART_TERM
-char u8a_knwd_buf[32];								// Buffer for UART debug messages
-#endif /* UART_TERM */
+uint8_t u8a_knwd_profile[PRF_KNWD_MAX] =			// Timing profile (defaults, see [PRF_KNWD_xxx])
+{
+	TIM_KNWD_DLY_SW_ACT, TIM_KNWD_DLY_STOP, TIM_KNWD_DLY_PB_WAIT, TIM_KNWD_DLY_FWIND_WAIT, TIM_KNWD_DLY_ACTIVE, TIM_KNWD_DLY_WAIT_STOP,
+	TACHO_KNWD_STOP_DLY_MAX, TACHO_KNWD_PLAY_DLY_MAX, TACHO_KNWD_FWIND_DLY_MAX
+};
 
 #ifdef SUPP_KENWOOD_MECH
 volatile const uint8_t ucaf_knwd_mech[] PROGMEM = "Kenwood mechanism";
@@ -85,12 +86,15 @@ void mech_knwd_static_halt(uint8_t in_sws, uint8_t *usr_mode)
 	{
 		// Transport is not in STOP mode.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		}
 #endif /* UART_TERM */
 		// Start capstan motor.
 		CAPSTAN_ON;
 		// Force STOP if transport is not in STOP.
-		u8_knwd_trans_timer = TIM_KNWD_DLY_WAIT_STOP;
+		u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_WAIT_STOP];
 		u8_knwd_mode = TTR_KNWD_SUBMODE_TO_HALT;
 	}
 	else
@@ -102,12 +106,33 @@ void mech_knwd_static_halt(uint8_t in_sws, uint8_t *usr_mode)
 	}
 }
 
+//-------------------------------------- Spin up capstan ahead of the first user command (cassette was just inserted).
+void mech_knwd_prespin(void)
+{
+	// Only from idle STOP with stopped capstan.
+	if((u8_knwd_trans_timer==0)&&(u8_knwd_mode==TTR_KNWD_MODE_STOP)&&
+		(u8_knwd_target_mode==TTR_KNWD_MODE_STOP)&&(CAPSTAN_STATE==0))
+	{
+#ifdef UART_TERM
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_prespin);
+		}
+#endif /* UART_TERM */
+		// Perform start-up delay and STOP check now, idle timeout will stop capstan if no command follows.
+		u8_knwd_target_mode = TTR_KNWD_MODE_TO_INIT;
+	}
+}
+
 //-------------------------------------- Start transition from current mode to target mode.
 void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_target2current1); mech_knwd_UART_dump_mode(u8_knwd_mode);
-	UART_add_flash_string((uint8_t *)cch_target2current2); mech_knwd_UART_dump_mode(u8_knwd_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_target2current1); mech_knwd_UART_dump_mode(u8_knwd_mode);
+		UART_add_flash_string((uint8_t *)cch_target2current2); mech_knwd_UART_dump_mode(u8_knwd_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	// Before any transition...
 	// Turn on mute.
@@ -120,7 +145,10 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 	{
 		// Capstan is stopped.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_capst_start);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_capst_start);
+		}
 #endif /* UART_TERM */
 		// Override target mode to perform capstan spinup wait.
 		u8_knwd_target_mode = TTR_KNWD_MODE_TO_INIT;
@@ -133,10 +161,13 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 	{
 		// Target mode: start-up delay.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_startup_delay);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_startup_delay);
+		}
 #endif /* UART_TERM */
 		// Set time for waiting for mechanism to stabilize.
-		u8_knwd_trans_timer = TIM_KNWD_DLY_ACTIVE;
+		u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_ACTIVE];
 		// Put transport in init waiting mode.
 		u8_knwd_mode = TTR_KNWD_SUBMODE_INIT;
 		// Move target to STOP mode.
@@ -151,7 +182,7 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 			(u8_knwd_mode==TTR_KNWD_MODE_RC_REV))
 		{
 			// From playback/record there only way is to fast wind, need to get through that.
-			u8_knwd_trans_timer = TIM_KNWD_DLY_FWIND_WAIT;
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_FWIND_WAIT];
 			u8_knwd_mode = TTR_KNWD_SUBMODE_TO_FWIND;
 		}
 		else if((u8_knwd_mode==TTR_KNWD_MODE_FW_FWD)||
@@ -160,7 +191,7 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 				(u8_knwd_mode==TTR_KNWD_MODE_FW_REV_HD_REV))
 		{
 			// Next from fast wind is STOP.
-			u8_knwd_trans_timer = TIM_KNWD_DLY_STOP;
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_STOP];
 			u8_knwd_mode = TTR_KNWD_SUBMODE_TO_STOP;
 		}
 		else
@@ -187,7 +218,7 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 			if(u8_knwd_mode==TTR_KNWD_MODE_STOP)
 			{
 				// Playback/record can be selected only from STOP.
-				u8_knwd_trans_timer = TIM_KNWD_DLY_PB_WAIT;
+				u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_PB_WAIT];
 				u8_knwd_mode = TTR_KNWD_SUBMODE_TO_PLAY;
 			}
 			else if((u8_knwd_mode==TTR_KNWD_MODE_FW_FWD)||
@@ -196,7 +227,7 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 					(u8_knwd_mode==TTR_KNWD_MODE_FW_REV_HD_REV))
 			{
 				// From fast wind the mode has to become STOP at first.
-				u8_knwd_trans_timer = TIM_KNWD_DLY_STOP;
+				u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_STOP];
 				u8_knwd_mode = TTR_KNWD_SUBMODE_TO_STOP;
 			}
 			else
@@ -221,7 +252,10 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 				{
 					// Record in forward direction is inhibited.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_record);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_record);
+					}
 #endif /* UART_TERM */
 					// Convert RECORD to PLAYBACK.
 					u8_knwd_target_mode = TTR_KNWD_MODE_PB_FWD;
@@ -233,21 +267,27 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 				{
 					// Record in forward direction is inhibited.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_record);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_record);
+					}
 #endif /* UART_TERM */
 					// Convert RECORD to PLAYBACK.
 					u8_knwd_target_mode = TTR_KNWD_MODE_PB_REV;
 				}
 			}
 			// Start transition to active mode.
-			u8_knwd_trans_timer = TIM_KNWD_DLY_ACTIVE;
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_ACTIVE];
 			//u8_knwd_mode = TTR_KNWD_SUBMODE_TO_ACTIVE;
 		}
 		else
 		{
 			// Unknown mode, reset to STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			}
 #endif /* UART_TERM */
 			u8_knwd_target_mode = TTR_KNWD_MODE_STOP;
 			(*usr_mode) = USR_MODE_STOP;
@@ -261,8 +301,11 @@ void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode)
 void mech_knwd_user2target(uint8_t *usr_mode, uint8_t *play_dir)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_user2target1); mech_knwd_UART_dump_mode(u8_knwd_target_mode);
-	UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_user2target1); mech_knwd_UART_dump_mode(u8_knwd_target_mode);
+		UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	// New target mode will apply in the next run of the [mech_knwd_state_machine()].
 	u8_knwd_target_mode = mech_knwd_user_to_transport((*usr_mode), play_dir);
@@ -288,10 +331,13 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 		{
 			// Transport is not in STOP mode.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			}
 #endif /* UART_TERM */
 			// Force STOP if transport is not in STOP.
-			u8_knwd_trans_timer = TIM_KNWD_DLY_WAIT_STOP;		// Load maximum delay to allow mechanism to revert to STOP (before retrying)
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_WAIT_STOP];		// Load maximum delay to allow mechanism to revert to STOP (before retrying)
 			u8_knwd_mode = TTR_KNWD_SUBMODE_TO_STOP;			// Set mode to trigger solenoid
 			u8_knwd_target_mode = TTR_KNWD_MODE_STOP;			// Set target to be STOP
 		}
@@ -305,7 +351,7 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 		// Reset idle timer.
 		u16_knwd_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_KNWD_PLAY_DLY_MAX)
+		if((*tacho)>u8a_knwd_profile[PRF_KNWD_TACHO_PLAY])
 		{
 			// No signal from takeup tachometer for too long.
 			// Perform auto-stop.
@@ -327,7 +373,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 						// Currently: playback in forward.
 						// Next: playback in reverse.
 #ifdef UART_TERM
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+						}
 #endif /* UART_TERM */
 						// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 						(*usr_mode) = USR_MODE_PLAY_REV;
@@ -340,7 +389,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: playback in reverse, infinite loop auto-reverse is enabled.
 							// Next: playback in forward.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+							}
 #endif /* UART_TERM */
 							// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 							(*usr_mode) = USR_MODE_PLAY_FWD;
@@ -354,7 +406,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: recording in forward, recording in reverse is allowed.
 							// Next: recording in reverse.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_fwd_rev);
+							}
 #endif /* UART_TERM */
 							// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 							(*usr_mode) = USR_MODE_REC_REV;
@@ -365,7 +420,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: recording in forward, recording in reverse is inhibited, auto-rewind is enabled.
 							// Next: rewind.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							}
 #endif /* UART_TERM */
 							// Queue rewind.
 							(*usr_mode) = USR_MODE_FWIND_REV;
@@ -376,7 +434,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: recording in forward, recording in reverse is inhibited, auto-rewind is disabled.
 							// Next: stop.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							}
 #endif /* UART_TERM */
 							// Make next playback direction in reverse direction after auto-stop.
 							(*play_dir) = PB_DIR_REV;
@@ -389,7 +450,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 						// Currently: recording in reverse, infinite loop auto-reverse is enabled, recording in forward is allowed.
 						// Next: recording in forward.
 #ifdef UART_TERM
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_reverse); UART_add_flash_string((uint8_t *)cch_reverse_rev_fwd);
+						}
 #endif /* UART_TERM */
 						// Queue auto-reverse (set user mode to next mode that will be applied after STOP).
 						(*usr_mode) = USR_MODE_REC_FWD;
@@ -399,7 +463,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 					{
 						// Reverse ops: enabled, auto-reverse enabled.
 						// All other combinations, next mode: stop.
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						}
 						// Stop mode already queued.
 					}
 #endif /* UART_TERM */
@@ -417,7 +484,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: playback or recording in forward, auto-rewind is enabled.
 							// Next: rewind.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+							}
 #endif /* UART_TERM */
 							// Queue rewind.
 							(*usr_mode) = USR_MODE_FWIND_REV;
@@ -428,7 +498,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 							// Currently: playback or recording in forward, auto-rewind is disabled.
 							// Next: stop.
 #ifdef UART_TERM
-							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+							{
+								UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+							}
 #endif /* UART_TERM */
 							// Make next playback direction in reverse direction after auto-stop.
 							(*play_dir) = PB_DIR_REV;
@@ -441,7 +514,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 						// Reverse ops: enabled, auto-reverse disabled.
 						// Currently: playback or recording in reverse.
 						// Next: stop.
-						UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+						{
+							UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+						}
 						// STOP mode already queued.
 					}
 #endif /* UART_TERM */
@@ -453,7 +529,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 				// Currently: playback or recording in forward, auto-rewind is enabled.
 				// Next: rewind.
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				}
 #endif /* UART_TERM */
 				// Queue rewind.
 				(*usr_mode) = USR_MODE_FWIND_REV;
@@ -464,7 +543,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 				// Reverse ops: disabled.
 				// Currently: playback or recording in forward, auto-rewind is disabled.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				}
 				// STOP mode already queued.
 			}
 #endif /* UART_TERM */
@@ -485,12 +567,15 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic state to correspond with reality.
 			u8_knwd_mode = TTR_KNWD_MODE_STOP;
 			u8_knwd_target_mode = TTR_KNWD_MODE_STOP;
-			u8_knwd_trans_timer = TIM_KNWD_DLY_WAIT_STOP;
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_WAIT_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -508,7 +593,7 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 		// Reset idle timer.
 		u16_knwd_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_KNWD_FWIND_DLY_MAX)
+		if((*tacho)>u8a_knwd_profile[PRF_KNWD_TACHO_FWIND])
 		{
 			// No signal from takeup tachometer for too long.
 			// Perform auto-stop.
@@ -526,7 +611,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 					// Currently: fast wind in forward direction, auto-rewind is enabled.
 					// Next: rewind.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					}
 #endif /* UART_TERM */
 					// Set mode to rewind.
 					(*usr_mode) = USR_MODE_FWIND_REV;
@@ -536,7 +624,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 					// Currently: fast wind in forward direction, auto-rewind is disabled.
 					// Next: stop.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					}
 #endif /* UART_TERM */
 					// Check if reverse functions are enabled.
 					if((in_ttr_features&TTR_FEA_REV_ENABLE)!=0)
@@ -552,7 +643,10 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 			{
 				// Currently: fast wind in reverse direction.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				}
 				// STOP mode already queued.
 			}
 #endif /* UART_TERM */
@@ -562,12 +656,15 @@ void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uin
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic mode.
 			u8_knwd_mode = TTR_KNWD_MODE_STOP;
 			u8_knwd_target_mode = TTR_KNWD_MODE_STOP;
-			u8_knwd_trans_timer = TIM_KNWD_DLY_WAIT_STOP;
+			u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_WAIT_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -602,7 +699,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 		CAPSTAN_ON;
 		// Pull solenoid in to initiate mode change to STOP.
 		SOLENOID_ON;
-		if(u8_knwd_trans_timer<=(TIM_KNWD_DLY_WAIT_STOP-TIM_KNWD_DLY_STOP))
+		if(u8_knwd_trans_timer<=(u8a_knwd_profile[PRF_KNWD_DLY_WAIT_STOP]-u8a_knwd_profile[PRF_KNWD_DLY_STOP]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Deactivate solenoid.
@@ -625,17 +722,24 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			if((in_sws&TTR_SW_STOP)==0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_mode_failed);
-				sprintf(u8a_knwd_buf, " %01u\n\r", u8_knwd_retries);
-				UART_add_string(u8a_knwd_buf);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+				{
+					UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_begin_line();
+					UART_add_flash_string((uint8_t *)cch_mode_failed);
+					UART_add_char(' '); UART_add_dec8(u8_knwd_retries, 1); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_end_line();
+				}
 #endif /* UART_TERM */
 				// Increase number of retries before failing.
 				u8_knwd_retries++;
 				if(u8_knwd_retries>=MODE_REP_MAX)
 				{
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+					{
+						UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					}
 #endif /* UART_TERM */
 					// Mechanically mode didn't change from active, register an error.
 					mech_knwd_set_error(TTR_ERR_NO_CTRL);
@@ -643,7 +747,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 				else
 				{
 					// Repeat transition to STOP.
-					u8_knwd_trans_timer = TIM_KNWD_DLY_STOP;
+					u8_knwd_trans_timer = u8a_knwd_profile[PRF_KNWD_DLY_STOP];
 					u8_knwd_mode = TTR_KNWD_SUBMODE_TO_STOP;
 				}
 			}
@@ -682,8 +786,11 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			if((in_sws&TTR_SW_STOP)!=0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+				{
+					UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				}
 #endif /* UART_TERM */
 				// Mechanically mode didn't change from STOP, register an error.
 				mech_knwd_set_error(TTR_ERR_NO_CTRL);
@@ -695,7 +802,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			}
 		}
 		// TODO: PLAY cyclogram
-		else if(u8_knwd_trans_timer<(TIM_KNWD_DLY_PB_WAIT-TIM_KNWD_DLY_SW_ACT))
+		else if(u8_knwd_trans_timer<(u8a_knwd_profile[PRF_KNWD_DLY_PB_WAIT]-u8a_knwd_profile[PRF_KNWD_DLY_SW_ACT]))
 		{
 			// Deactivate solenoid and wait for transition to happen.
 			SOLENOID_OFF;
@@ -724,20 +831,23 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 			if((in_sws&TTR_SW_STOP)!=0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+				{
+					UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				}
 #endif /* UART_TERM */
 				// Mechanically mode slipped to STOP, register an error.
 				mech_knwd_set_error(TTR_ERR_NO_CTRL);
 			}
 		}
 		// TODO: FAST WIND cyclogram
-		/*else if(u8_knwd_trans_timer<(TIM_KNWD_DLY_FWIND_WAIT-TIM_KNWD_DLY_FWIND_ACT))
+		/*else if(u8_knwd_trans_timer<(u8a_knwd_profile[PRF_KNWD_DLY_FWIND_WAIT]-u8a_knwd_profile[PRF_KNWD_DLY_FWIND_ACT]))
 		{
 			// Deactivate solenoid and wait for transition to happen.
 			SOLENOID_OFF;
 		}
-		else if(u8_knwd_trans_timer<(TIM_KNWD_DLY_FWIND_WAIT-TIM_KNWD_DLY_WAIT_REW_ACT))
+		else if(u8_knwd_trans_timer<(u8a_knwd_profile[PRF_KNWD_DLY_FWIND_WAIT]-u8a_knwd_profile[PRF_KNWD_DLY_WAIT_REW_ACT]))
 		{
 			// Check takeup direction for FAST WIND.
 			if(u8_knwd_target_mode==TTR_KNWD_MODE_FW_REV)
@@ -746,7 +856,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 				SOLENOID_ON;
 			}
 		}*/
-		else if(u8_knwd_trans_timer<(TIM_KNWD_DLY_FWIND_WAIT-TIM_KNWD_DLY_SW_ACT))
+		else if(u8_knwd_trans_timer<(u8a_knwd_profile[PRF_KNWD_DLY_FWIND_WAIT]-u8a_knwd_profile[PRF_KNWD_DLY_SW_ACT]))
 		{
 			// Deactivate solenoid and wait for takeup selection range.
 			SOLENOID_OFF;
@@ -764,7 +874,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	else if(u8_knwd_mode==TTR_KNWD_MODE_HALT)
 	{
 		// Desired mode: recovery STOP in HALT mode.
-		if(u8_knwd_trans_timer<(TIM_KNWD_DLY_ACTIVE-TIM_KNWD_DLY_SW_ACT))
+		if(u8_knwd_trans_timer<(u8a_knwd_profile[PRF_KNWD_DLY_ACTIVE]-u8a_knwd_profile[PRF_KNWD_DLY_SW_ACT]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Release solenoid while waiting for transport to transition to STOP.
@@ -773,7 +883,7 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir)
 	}
 	
 #ifdef UART_TERM
-	if((u8_knwd_trans_timer==0)&&(u8_knwd_mode!=TTR_KNWD_MODE_HALT))
+	if((u8_knwd_trans_timer==0)&&(u8_knwd_mode!=TTR_KNWD_MODE_HALT)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 	{
 		UART_add_flash_string((uint8_t *)cch_mode_done); UART_add_flash_string((uint8_t *)cch_arrow);
 		mech_knwd_UART_dump_mode(u8_knwd_mode); UART_add_flash_string((uint8_t *)cch_endl);
@@ -789,7 +899,10 @@ void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, u
 	{
 		// Register logic error.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		}
 #endif /* UART_TERM */
 		mech_knwd_set_error(TTR_ERR_LOGIC_FAULT);
 	}
@@ -801,7 +914,7 @@ void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, u
 		(*play_dir) = PB_DIR_FWD;
 #ifdef UART_TERM
 		// Check if transport was in active mode last time.
-		if((*usr_mode)!=USR_MODE_STOP)
+		if(((*usr_mode)!=USR_MODE_STOP)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 		{
 			// Tape was moving, dump a message about lost tape.
 			UART_add_flash_string((uint8_t *)cch_no_tape);
@@ -833,6 +946,13 @@ void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, u
 		else if(u8_knwd_target_mode!=u8_knwd_mode)
 		{
 			// Target transport mode is not the same as current transport mode (need to start transition to another mode).
+#ifdef EN_IDLE_ADAPT
+			if((u8_knwd_mode==TTR_KNWD_MODE_STOP)&&(u8_knwd_target_mode!=TTR_KNWD_MODE_TO_INIT)&&((in_sws&TTR_SW_TAPE_IN)!=0))
+			{
+				// Transport leaves idle STOP, let capstan shutdown policy learn the gap.
+				IDL_log_gap(u16_knwd_idle_time, (CAPSTAN_STATE!=0));
+			}
+#endif /* EN_IDLE_ADAPT */
 			mech_knwd_target2mode(in_sws, tacho, usr_mode);
 		}
 		// Transport is not in error and is in stable state (target mode reached),
@@ -855,7 +975,7 @@ void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, u
 			if(u16_knwd_idle_time>=IDLE_CAP_NO_TAPE)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
@@ -867,10 +987,10 @@ void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, u
 		else
 		{
 			// Tape is loaded.
-			if(u16_knwd_idle_time>=IDLE_CAP_TAPE_IN)
+			if(u16_knwd_idle_time>=IDLE_CAP_TAPE_TIMEOUT)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
@@ -942,12 +1062,65 @@ uint8_t mech_knwd_get_transition()
 	return u8_knwd_trans_timer;
 }
 
+//-------------------------------------- Get current internal transport mode.
+uint8_t mech_knwd_get_state()
+{
+	return u8_knwd_mode;
+}
+
+//-------------------------------------- Get target internal transport mode.
+uint8_t mech_knwd_get_target()
+{
+	return u8_knwd_target_mode;
+}
+
 //-------------------------------------- Get transport error.
 uint8_t mech_knwd_get_error()
 {
 	return u8_knwd_error;
 }
 
+//-------------------------------------- Get number of mode transition retries.
+uint8_t mech_knwd_get_retries()
+{
+	return u8_knwd_retries;
+}
+
+//-------------------------------------- Replace timing profile (if it passes sanity check).
+// Returns 0 if profile is applied, otherwise current profile is kept.
+uint8_t mech_knwd_set_profile(const uint8_t *in_profile)
+{
+	uint8_t u8_idx;
+	// Each transition must be longer than its solenoid pulse.
+	if((in_profile[PRF_KNWD_DLY_SW_ACT]>=in_profile[PRF_KNWD_DLY_STOP])||
+		(in_profile[PRF_KNWD_DLY_STOP]>=in_profile[PRF_KNWD_DLY_WAIT_STOP])||
+		(in_profile[PRF_KNWD_DLY_SW_ACT]>=in_profile[PRF_KNWD_DLY_PB_WAIT])||
+		(in_profile[PRF_KNWD_DLY_SW_ACT]>=in_profile[PRF_KNWD_DLY_FWIND_WAIT])||
+		(in_profile[PRF_KNWD_DLY_SW_ACT]>=in_profile[PRF_KNWD_DLY_ACTIVE]))
+	{
+		return 1;
+	}
+	// Zero tacho timeout will halt the transport right away.
+	for(u8_idx=PRF_KNWD_TACHO_STOP;u8_idx<PRF_KNWD_MAX;u8_idx++)
+	{
+		if(in_profile[u8_idx]==0)
+		{
+			return 1;
+		}
+	}
+	for(u8_idx=0;u8_idx<PRF_KNWD_MAX;u8_idx++)
+	{
+		u8a_knwd_profile[u8_idx] = in_profile[u8_idx];
+	}
+	return 0;
+}
+
+//-------------------------------------- Get current timing profile.
+const uint8_t *mech_knwd_get_profile()
+{
+	return u8a_knwd_profile;
+}
+
 //-------------------------------------- Print transport mode alias.
 void mech_knwd_UART_dump_mode(uint8_t in_mode)
 {
@@ -26,6 +26,7 @@ This mechanism has two capstans and supports reverse operations.
 
 #include "drv_io.h"
 #include "strings.h"
+#include "idle_policy.h"
 
 // Timer marks for various modes for Kenwood mechanism, contained in [u8_knwd_trans_timer].
 // Each tick = 2 ms real time.
@@ -43,6 +44,22 @@ This mechanism has two capstans and supports reverse operations.
 #define TACHO_KNWD_PLAY_DLY_MAX		240		// TODO
 #define TACHO_KNWD_FWIND_DLY_MAX	240		// TODO
 
+// Timing profile for Kenwood mechanism in [u8a_knwd_profile] (values above are defaults).
+// Profile can be replaced from EEPROM settings with [mech_knwd_set_profile()].
+enum
+{
+	PRF_KNWD_DLY_SW_ACT,
+	PRF_KNWD_DLY_STOP,
+	PRF_KNWD_DLY_PB_WAIT,
+	PRF_KNWD_DLY_FWIND_WAIT,
+	PRF_KNWD_DLY_ACTIVE,
+	PRF_KNWD_DLY_WAIT_STOP,
+	PRF_KNWD_TACHO_STOP,
+	PRF_KNWD_TACHO_PLAY,
+	PRF_KNWD_TACHO_FWIND,
+	PRF_KNWD_MAX					// Profile size
+};
+
 // States of Kenwood mechanism for [u8_knwd_target_mode] and [u8_knwd_mode] (including "SUBMODES").
 enum
 {
@@ -73,6 +90,7 @@ extern volatile const uint8_t ucaf_knwd_mech[];
 void mech_knwd_set_error(uint8_t in_err);								// Freeze transport due to error
 uint8_t mech_knwd_user_to_transport(uint8_t in_mode, uint8_t *play_dir);// Convert user mode to transport mode
 void mech_knwd_static_halt(uint8_t in_sws, uint8_t *usr_mode);			// Transport operations are halted, keep mechanism in this state
+void mech_knwd_prespin(void);											// Spin up capstan ahead of the first user command
 void mech_knwd_target2mode(uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode);	// Start transition from current mode to target mode
 void mech_knwd_user2target(uint8_t *usr_mode, uint8_t *play_dir);		// Take in user desired mode and set new target mode
 void mech_knwd_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode, uint8_t *play_dir);		// Control mechanism in static mode (not transitioning between modes)
@@ -80,5 +98,10 @@ void mech_knwd_cyclogram(uint8_t in_sws, uint8_t *play_dir);			// Transition thr
 void mech_knwd_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode, uint8_t *play_dir);	// Perform tape transport state machine
 uint8_t mech_knwd_get_mode();											// Get user-level mode of the transport
 uint8_t mech_knwd_get_transition();										// Get transition timer count
+uint8_t mech_knwd_get_state();											// Get current internal mode of the transport (including submodes)
+uint8_t mech_knwd_get_target();											// Get target internal mode of the transport
 uint8_t mech_knwd_get_error();											// Get transport error
+uint8_t mech_knwd_get_retries();										// Get number of mode transition retries
+uint8_t mech_knwd_set_profile(const uint8_t *in_profile);				// Replace timing profile (if it passes sanity check)
+const uint8_t *mech_knwd_get_profile();									// Get current timing profile
 void mech_knwd_UART_dump_mode(uint8_t in_mode);							// Print transport mode alias
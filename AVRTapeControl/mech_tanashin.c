@@ -6,15 +6,24 @@ uint8_t u8_tanashin_error=TTR_ERR_NONE;					// Last transport error
 uint8_t u8_tanashin_trans_timer=0;						// Solenoid holding timer
 uint16_t u16_tanashin_idle_time=0;						// Timer for disabling capstan motor
 uint8_t u8_tanashin_retries=0;							// Number of retries before transport halts
-
-#ifdef UART_TERM
-char u8a_tanashin_buf[36];								// Buffer for UART debug messages
-#endif /* UART_TERM */
+uint8_t u8a_tanashin_profile[PRF_TANA_MAX] =			// Timing profile (defaults, see [PRF_TANA_xxx])
+{
+	TIM_TANA_DLY_SW_ACT, TIM_TANA_DLY_WAIT_REW_ACT, TIM_TANA_DLY_FWIND_ACT, TIM_TANA_DLY_FWIND_SKIP, TIM_TANA_DLY_SKIP_END,
+	TIM_TANA_DLY_PB_WAIT, TIM_TANA_DLY_FWIND_WAIT, TIM_TANA_DLY_STOP, TIM_TANA_DLY_PB2STOP, TIM_TANA_DLY_ACTIVE,
+	TACHO_TANA_PLAY_DLY_MAX, TACHO_TANA_FWIND_DLY_MAX
+};
 
 #ifdef SUPP_TANASHIN_MECH
 volatile const uint8_t ucaf_tanashin_mech[] PROGMEM = "Tanashin TN-21ZLG clone mechanism (M60207052)";
 #endif /* SUPP_TANASHIN_MECH */
 
+// Default solenoid marks of the cyclograms [PRF_TANA_DLY_SW_ACT...PRF_TANA_DLY_SKIP_END],
+// profile from EEPROM or calibration may not move them further than [CAL_MARK_DEV_MAX].
+const uint8_t ucaf_tanashin_marks[] PROGMEM =
+{
+	TIM_TANA_DLY_SW_ACT, TIM_TANA_DLY_WAIT_REW_ACT, TIM_TANA_DLY_FWIND_ACT, TIM_TANA_DLY_FWIND_SKIP, TIM_TANA_DLY_SKIP_END
+};
+
 //-------------------------------------- Freeze transport due to error.
 void mech_tanashin_set_error(uint8_t in_err)
 {
@@ -63,31 +72,53 @@ void mech_tanashin_static_halt(uint8_t in_sws, uint8_t *usr_mode)
 	{
 		// Transport is not in STOP mode.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+		}
 #endif /* UART_TERM */
 		// Start capstan motor.
 		CAPSTAN_ON;
 		// Force STOP if transport is not in STOP.
-		u8_tanashin_trans_timer = TIM_TANA_DLY_ACTIVE;				// Load maximum delay to allow mechanism to revert to STOP (before retrying)
+		u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_ACTIVE];				// Load maximum delay to allow mechanism to revert to STOP (before retrying)
 		u8_tanashin_mode = TTR_TANA_SUBMODE_TO_HALT;				// Set mode to trigger solenoid
 	}
 	else
 	{
 		// Keep solenoid inactive.
 		SOLENOID_OFF;
-		// Disable power for tacho sensor.
-		TANA_TACHO_PWR_DIS;
 		// Shut down capstan motor.
 		CAPSTAN_OFF;
 	}
 }
 
+//-------------------------------------- Spin up capstan ahead of the first user command (cassette was just inserted).
+void mech_tanashin_prespin(void)
+{
+	// Only from idle STOP with stopped capstan.
+	if((u8_tanashin_trans_timer==0)&&(u8_tanashin_mode==TTR_TANA_MODE_STOP)&&
+		(u8_tanashin_target_mode==TTR_TANA_MODE_STOP)&&(CAPSTAN_STATE==0))
+	{
+#ifdef UART_TERM
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_prespin);
+		}
+#endif /* UART_TERM */
+		// Perform start-up delay and STOP check now, idle timeout will stop capstan if no command follows.
+		u8_tanashin_target_mode = TTR_TANA_MODE_TO_INIT;
+	}
+}
+
 //-------------------------------------- Start transition from current mode to target mode.
 void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_target2current1); mech_tanashin_UART_dump_mode(u8_tanashin_mode);
-	UART_add_flash_string((uint8_t *)cch_target2current2); mech_tanashin_UART_dump_mode(u8_tanashin_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_target2current1); mech_tanashin_UART_dump_mode(u8_tanashin_mode);
+		UART_add_flash_string((uint8_t *)cch_target2current2); mech_tanashin_UART_dump_mode(u8_tanashin_target_mode); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	// Before any transition...
 	// Turn on mute.
@@ -100,7 +131,10 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 	{
 		// Capstan is stopped.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_capst_start);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_capst_start);
+		}
 #endif /* UART_TERM */
 		// Override target mode to perform capstan spinup wait.
 		u8_tanashin_target_mode = TTR_TANA_MODE_TO_INIT;
@@ -113,10 +147,13 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 	{
 		// Target mode: start-up delay.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_startup_delay);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+		{
+			UART_add_flash_string((uint8_t *)cch_startup_delay);
+		}
 #endif /* UART_TERM */
 		// Set time for waiting for mechanism to stabilize.
-		u8_tanashin_trans_timer = TIM_TANA_DLY_ACTIVE;
+		u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_ACTIVE];
 		// Put transport in init waiting mode.
 		u8_tanashin_mode = TTR_TANA_SUBMODE_INIT;
 		// Move target to STOP mode.
@@ -128,13 +165,13 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 		if((u8_tanashin_mode==TTR_TANA_MODE_PB_FWD)||(u8_tanashin_mode==TTR_TANA_MODE_RC_FWD))
 		{
 			// From playback/record there only way is to fast wind, need to get through that.
-			u8_tanashin_trans_timer = TIM_TANA_DLY_PB2STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB2STOP];
 			u8_tanashin_mode = TTR_TANA_SUBMODE_TO_SKIP_FW;
 		}
 		else if((u8_tanashin_mode==TTR_TANA_MODE_FW_FWD)||(u8_tanashin_mode==TTR_TANA_MODE_FW_REV))
 		{
 			// Next from fast wind is STOP.
-			u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 			u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 		}
 		else
@@ -157,13 +194,13 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 			if(u8_tanashin_mode==TTR_TANA_MODE_STOP)
 			{
 				// Playback/record can be selected only from STOP.
-				u8_tanashin_trans_timer = TIM_TANA_DLY_PB_WAIT;
+				u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT];
 				u8_tanashin_mode = TTR_TANA_SUBMODE_TO_PLAY;
 			}
 			else if((u8_tanashin_mode==TTR_TANA_MODE_FW_FWD)||(u8_tanashin_mode==TTR_TANA_MODE_FW_REV))
 			{
 				// From fast wind the mode has to become STOP at first.
-				u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+				u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 				u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 			}
 			else if(u8_tanashin_mode==TTR_TANA_MODE_PB_FWD)
@@ -183,19 +220,19 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 			if(u8_tanashin_mode==TTR_TANA_MODE_STOP)
 			{
 				// Fast wind can be selected only through PLAY.
-				u8_tanashin_trans_timer = TIM_TANA_DLY_PB_WAIT;
+				u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT];
 				u8_tanashin_mode = TTR_TANA_SUBMODE_TO_PLAY;
 			}
 			else if((u8_tanashin_mode==TTR_TANA_MODE_PB_FWD)||(u8_tanashin_mode==TTR_TANA_MODE_RC_FWD))
 			{
 				// Direct select FAST WIND from PLAY/RECORD.
-				u8_tanashin_trans_timer = TIM_TANA_DLY_FWIND_WAIT;
+				u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_FWIND_WAIT];
 				u8_tanashin_mode = TTR_TANA_SUBMODE_TO_FWIND;
 			}
 			else if((u8_tanashin_mode==TTR_TANA_MODE_FW_FWD)||(u8_tanashin_mode==TTR_TANA_MODE_FW_REV))
 			{
 				// Re-select FAST WIND through STOP.
-				u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+				u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 				u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 			}
 			else
@@ -208,7 +245,10 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 		{
 			// Unknown mode, reset to STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_unknown_mode);
+			}
 #endif /* UART_TERM */
 			u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 			(*usr_mode) = USR_MODE_STOP;
@@ -222,8 +262,11 @@ void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode)
 void mech_tanashin_user2target(uint8_t *usr_mode)
 {
 #ifdef UART_TERM
-	UART_add_flash_string((uint8_t *)cch_user2target1); mech_tanashin_UART_dump_mode(u8_tanashin_target_mode);
-	UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
+	{
+		UART_add_flash_string((uint8_t *)cch_user2target1); mech_tanashin_UART_dump_mode(u8_tanashin_target_mode);
+		UART_add_flash_string((uint8_t *)cch_user2target2); UART_dump_user_mode((*usr_mode)); UART_add_flash_string((uint8_t *)cch_endl);
+	}
 #endif /* UART_TERM */
 	// New target mode will apply in the next run of the [mech_tanashin_state_machine()].
 	u8_tanashin_target_mode = mech_tanashin_user_to_transport((*usr_mode));
@@ -249,10 +292,13 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 		{
 			// Transport is not in STOP mode.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_force_stop);
+			}
 #endif /* UART_TERM */
 			// Force STOP if transport is not in STOP.
-			u8_tanashin_trans_timer = TIM_TANA_DLY_PB_WAIT;			// Load maximum delay to allow mechanism to revert to STOP (before retrying)
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT];			// Load maximum delay to allow mechanism to revert to STOP (before retrying)
 			u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;			// Set mode to trigger solenoid
 			u8_tanashin_target_mode = TTR_TANA_MODE_STOP;			// Set target to be STOP
 		}
@@ -263,7 +309,7 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 		// Reset idle timer.
 		u16_tanashin_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_TANA_PLAY_DLY_MAX)
+		if((*tacho)>u8a_tanashin_profile[PRF_TANA_TACHO_PLAY])
 		{
 			// No signal from takeup tachometer for too long.
 			// Turn mute on.
@@ -277,7 +323,10 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 				// Currently: playback in forward, auto-rewind is enabled.
 				// Next: rewind.
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+				}
 #endif /* UART_TERM */
 				// Queue rewind.
 				(*usr_mode) = USR_MODE_FWIND_REV;
@@ -287,11 +336,14 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 			{
 				// Currently: playback or recording in forward, auto-rewind is disabled.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_pb); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+				}
 				// STOP mode already queued.
 			}
 			// Perform auto-stop.
-			u8_tanashin_trans_timer = TIM_TANA_DLY_PB2STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB2STOP];
 			u8_tanashin_mode = TTR_TANA_SUBMODE_TO_SKIP_FW;
 			u8_tanashin_target_mode = TTR_TANA_MODE_STOP;
 #endif /* UART_TERM */
@@ -312,12 +364,15 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic mode.
 			u8_tanashin_mode = TTR_TANA_MODE_STOP;
 			u8_tanashin_target_mode = TTR_TANA_MODE_STOP;
-			u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -332,11 +387,11 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 		// Reset idle timer.
 		u16_tanashin_idle_time = 0;
 		// Check tachometer timer.
-		if((*tacho)>TACHO_TANA_FWIND_DLY_MAX)
+		if((*tacho)>u8a_tanashin_profile[PRF_TANA_TACHO_FWIND])
 		{
 			// No signal from takeup tachometer for too long.
 			// Perform auto-stop.
-			u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 			u8_tanashin_target_mode = TTR_TANA_MODE_STOP;
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
@@ -349,7 +404,10 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 					// Currently: fast wind in forward direction, auto-rewind is enabled.
 					// Next: rewind.
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_rewind);
+					}
 #endif /* UART_TERM */
 					// Queue rewind.
 					(*usr_mode) = USR_MODE_FWIND_REV;
@@ -359,7 +417,10 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 				{
 					// Currently: fast wind in forward direction, auto-rewind is disabled.
 					// Next: stop.
-					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+					{
+						UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					}
 					// STOP mode already queued.
 				}
 #endif /* UART_TERM */
@@ -369,7 +430,10 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 			{
 				// Currently: fast wind in reverse direction.
 				// Next: stop.
-				UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
+				{
+					UART_add_flash_string((uint8_t *)cch_no_tacho_fw); UART_add_flash_string((uint8_t *)cch_auto_stop); UART_add_flash_string((uint8_t *)cch_tape_end);
+				}
 				// STOP mode already queued.
 			}
 #endif /* UART_TERM */
@@ -380,12 +444,15 @@ void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features,
 		{
 			// Mechanism unexpectedly slipped into STOP.
 #ifdef UART_TERM
-			UART_add_flash_string((uint8_t *)cch_stop_corr);
+			if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+			{
+				UART_add_flash_string((uint8_t *)cch_stop_corr);
+			}
 #endif /* UART_TERM */
 			// Correct logic mode.
 			u8_tanashin_mode = TTR_TANA_MODE_STOP;
 			u8_tanashin_target_mode = TTR_TANA_MODE_STOP;
-			u8_tanashin_trans_timer = TIM_TANA_DLY_STOP;
+			u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_STOP];
 			// Clear user mode.
 			(*usr_mode) = USR_MODE_STOP;
 		}
@@ -400,8 +467,6 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 		// Desired mode: spin-up capstan, wait for TTR to stabilize.
 		// Turn on capstan motor.
 		CAPSTAN_ON;
-		// Enable power for tacho sensor.
-		TANA_TACHO_PWR_EN;
 		// Turn off solenoid, let mechanism stabilize.
 		SOLENOID_OFF;
 		// Turn on mute.
@@ -420,11 +485,9 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 		// Starting transition to STOP mode.
 		// Turn on capstan motor.
 		CAPSTAN_ON;
-		// Enable power for tacho sensor.
-		TANA_TACHO_PWR_EN;
 		// Activate solenoid to start transition to STOP.
 		SOLENOID_ON;
-		if(u8_tanashin_trans_timer<(TIM_TANA_DLY_STOP-TIM_TANA_DLY_SW_ACT))
+		if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_STOP]-u8a_tanashin_profile[PRF_TANA_DLY_SW_ACT]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Deactivate solenoid.
@@ -447,17 +510,24 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 			if((in_sws&TTR_SW_STOP)==0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_mode_failed);
-				sprintf(u8a_tanashin_buf, " %01u\n\r", u8_tanashin_retries);
-				UART_add_string(u8a_tanashin_buf);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+				{
+					UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_begin_line();
+					UART_add_flash_string((uint8_t *)cch_mode_failed);
+					UART_add_char(' '); UART_add_dec8(u8_tanashin_retries, 1); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_end_line();
+				}
 #endif /* UART_TERM */
 				// Increase number of retries before failing.
 				u8_tanashin_retries++;
 				if(u8_tanashin_retries>=MODE_REP_MAX)
 				{
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+					{
+						UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					}
 #endif /* UART_TERM */
 					// Mechanically mode didn't change from active, register an error.
 					mech_tanashin_set_error(TTR_ERR_NO_CTRL);
@@ -465,7 +535,7 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 				else
 				{
 					// Repeat transition to STOP.
-					u8_tanashin_trans_timer = TIM_TANA_DLY_PB_WAIT;
+					u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT];
 					u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 				}
 			}
@@ -481,8 +551,6 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 		// Starting transition to PLAY/RECORD mode.
 		// Turn on capstan motor.
 		CAPSTAN_ON;
-		// Enable power for tacho sensor.
-		TANA_TACHO_PWR_EN;
 		// Activate solenoid to start transition to PLAY/RECORD.
 		SOLENOID_ON;
 		if(u8_tanashin_target_mode==TTR_TANA_MODE_RC_FWD)
@@ -514,8 +582,11 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 			if((in_sws&TTR_SW_STOP)!=0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+				{
+					UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				}
 #endif /* UART_TERM */
 				// Mechanically mode didn't change from STOP, register an error.
 				mech_tanashin_set_error(TTR_ERR_NO_CTRL);
@@ -526,7 +597,7 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 				MUTE_EN_OFF;
 			}
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_PB_WAIT-TIM_TANA_DLY_SW_ACT))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT]-u8a_tanashin_profile[PRF_TANA_DLY_SW_ACT]))
 		{
 			// Deactivate solenoid and wait for transition to happen.
 			SOLENOID_OFF;
@@ -537,8 +608,6 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 		// Starting transition to FAST WIND mode.
 		// Turn on capstan motor.
 		CAPSTAN_ON;
-		// Enable power for tacho sensor.
-		TANA_TACHO_PWR_EN;
 		// Activate solenoid to start transition to FAST WIND.
 		SOLENOID_ON;
 		u8_tanashin_mode = TTR_TANA_SUBMODE_WAIT_FWIND;
@@ -566,19 +635,22 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 			if((in_sws&TTR_SW_STOP)!=0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+				{
+					UART_add_flash_string((uint8_t *)cch_active_stop); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+				}
 #endif /* UART_TERM */
 				// Mechanically mode slipped to STOP, register an error.
 				mech_tanashin_set_error(TTR_ERR_NO_CTRL);
 			}
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_FWIND_WAIT-TIM_TANA_DLY_FWIND_ACT))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_FWIND_WAIT]-u8a_tanashin_profile[PRF_TANA_DLY_FWIND_ACT]))
 		{
 			// Deactivate solenoid and wait for transition to happen.
 			SOLENOID_OFF;
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_FWIND_WAIT-TIM_TANA_DLY_WAIT_REW_ACT))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_FWIND_WAIT]-u8a_tanashin_profile[PRF_TANA_DLY_WAIT_REW_ACT]))
 		{
 			// Check takeup direction for FAST WIND.
 			if(u8_tanashin_target_mode==TTR_TANA_MODE_FW_REV)
@@ -587,7 +659,7 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 				SOLENOID_ON;
 			}
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_FWIND_WAIT-TIM_TANA_DLY_SW_ACT))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_FWIND_WAIT]-u8a_tanashin_profile[PRF_TANA_DLY_SW_ACT]))
 		{
 			// Deactivate solenoid and wait for takeup selection range.
 			SOLENOID_OFF;
@@ -598,8 +670,6 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 		// Starting transition to STOP mode skipping FAST WIND mode.
 		// Turn on capstan motor.
 		CAPSTAN_ON;
-		// Enable power for tacho sensor.
-		TANA_TACHO_PWR_EN;
 		// Activate solenoid to start transition to STOP through FAST WIND.
 		SOLENOID_ON;
 		u8_tanashin_mode = TTR_TANA_SUBMODE_WAIT_SKIP;
@@ -618,17 +688,24 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 			if((in_sws&TTR_SW_STOP)==0)
 			{
 #ifdef UART_TERM
-				UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
-				UART_add_flash_string((uint8_t *)cch_mode_failed);
-				sprintf(u8a_tanashin_buf, " %01u\n\r", u8_tanashin_retries);
-				UART_add_string(u8a_tanashin_buf);
+				if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_WARN))
+				{
+					UART_add_flash_string((uint8_t *)cch_stop_active); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_begin_line();
+					UART_add_flash_string((uint8_t *)cch_mode_failed);
+					UART_add_char(' '); UART_add_dec8(u8_tanashin_retries, 1); UART_add_flash_string((uint8_t *)cch_endl);
+					UART_end_line();
+				}
 #endif /* UART_TERM */
 				// Increase number of retries before failing.
 				u8_tanashin_retries++;
 				if(u8_tanashin_retries>=MODE_REP_MAX)
 				{
 #ifdef UART_TERM
-					UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+					{
+						UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_halt_stop2);
+					}
 #endif /* UART_TERM */
 					// Mechanically mode didn't change from active, register an error.
 					mech_tanashin_set_error(TTR_ERR_NO_CTRL);
@@ -636,22 +713,22 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 				else
 				{
 					// Repeat transition to STOP.
-					u8_tanashin_trans_timer = TIM_TANA_DLY_PB_WAIT;
+					u8_tanashin_trans_timer = u8a_tanashin_profile[PRF_TANA_DLY_PB_WAIT];
 					u8_tanashin_mode = TTR_TANA_SUBMODE_TO_STOP;
 				}
 			}
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_PB2STOP-TIM_TANA_DLY_SKIP_END))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_PB2STOP]-u8a_tanashin_profile[PRF_TANA_DLY_SKIP_END]))
 		{
 			// Deactivate solenoid and wait for transition to STOP.
 			SOLENOID_OFF;
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_PB2STOP-TIM_TANA_DLY_FWIND_SKIP))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_PB2STOP]-u8a_tanashin_profile[PRF_TANA_DLY_FWIND_SKIP]))
 		{
 			// Activate solenoid and wait for skipping FAST WIND.
 			SOLENOID_ON;
 		}
-		else if(u8_tanashin_trans_timer<(TIM_TANA_DLY_PB2STOP-TIM_TANA_DLY_SW_ACT))
+		else if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_PB2STOP]-u8a_tanashin_profile[PRF_TANA_DLY_SW_ACT]))
 		{
 			// Deactivate solenoid and wait for takeup selection range.
 			SOLENOID_OFF;
@@ -669,7 +746,7 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 	else if(u8_tanashin_mode==TTR_TANA_MODE_HALT)
 	{
 		// Desired mode: recovery STOP in HALT mode.
-		if(u8_tanashin_trans_timer<(TIM_TANA_DLY_ACTIVE-TIM_TANA_DLY_SW_ACT))
+		if(u8_tanashin_trans_timer<(u8a_tanashin_profile[PRF_TANA_DLY_ACTIVE]-u8a_tanashin_profile[PRF_TANA_DLY_SW_ACT]))
 		{
 			// Initial time for activating mode transition to STOP has passed.
 			// Release solenoid while waiting for transport to transition to STOP.
@@ -678,7 +755,7 @@ void mech_tanashin_cyclogram(uint8_t in_sws)
 	}
 	
 #ifdef UART_TERM
-	if((u8_tanashin_trans_timer==0)&&(u8_tanashin_mode!=TTR_TANA_MODE_HALT))
+	if((u8_tanashin_trans_timer==0)&&(u8_tanashin_mode!=TTR_TANA_MODE_HALT)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 	{
 		UART_add_flash_string((uint8_t *)cch_mode_done); UART_add_flash_string((uint8_t *)cch_arrow);
 		mech_tanashin_UART_dump_mode(u8_tanashin_mode); UART_add_flash_string((uint8_t *)cch_endl);
@@ -694,7 +771,10 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 	{
 		// Register logic error.
 #ifdef UART_TERM
-		UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		if(UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_ERROR))
+		{
+			UART_add_flash_string((uint8_t *)cch_halt_stop3); UART_add_flash_string((uint8_t *)cch_ttr_halt); UART_add_flash_string((uint8_t *)cch_endl);
+		}
 #endif /* UART_TERM */
 		mech_tanashin_set_error(TTR_ERR_LOGIC_FAULT);
 	}
@@ -706,7 +786,7 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 		// Tape is not found.
 #ifdef UART_TERM
 		// Check if transport was in active mode last time.
-		if((*usr_mode)!=USR_MODE_STOP)
+		if(((*usr_mode)!=USR_MODE_STOP)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 		{
 			// Tape was moving, dump a message about lost tape.
 			UART_add_flash_string((uint8_t *)cch_no_tape);
@@ -738,6 +818,13 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 		else if(u8_tanashin_target_mode!=u8_tanashin_mode)
 		{
 			// Target transport mode is not the same as current transport mode (need to start transition to another mode).
+#ifdef EN_IDLE_ADAPT
+			if((u8_tanashin_mode==TTR_TANA_MODE_STOP)&&(u8_tanashin_target_mode!=TTR_TANA_MODE_TO_INIT)&&((in_sws&TTR_SW_TAPE_IN)!=0))
+			{
+				// Transport leaves idle STOP, let capstan shutdown policy learn the gap.
+				IDL_log_gap(u16_tanashin_idle_time, (CAPSTAN_STATE!=0));
+			}
+#endif /* EN_IDLE_ADAPT */
 			mech_tanashin_target2mode(tacho, usr_mode);
 		}
 		// Transport is not in error and is in stable state (target mode reached),
@@ -760,13 +847,11 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 			if(u16_tanashin_idle_time>=IDLE_CAP_NO_TAPE)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
 #endif /* UART_TERM */
-				// Disable power for tacho sensor.
-				TANA_TACHO_PWR_DIS;
 				// Shutdown capstan motor.
 				CAPSTAN_OFF;
 			}
@@ -774,16 +859,14 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 		else
 		{
 			// Tape is loaded.
-			if(u16_tanashin_idle_time>=IDLE_CAP_TAPE_IN)
+			if(u16_tanashin_idle_time>=IDLE_CAP_TAPE_TIMEOUT)
 			{
 #ifdef UART_TERM
-				if(CAPSTAN_STATE!=0)
+				if((CAPSTAN_STATE!=0)&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_INFO))
 				{
 					UART_add_flash_string((uint8_t *)cch_capst_stop);
 				}
 #endif /* UART_TERM */
-				// Disable power for tacho sensor.
-				TANA_TACHO_PWR_DIS;
 				// Shutdown capstan motor.
 				CAPSTAN_OFF;
 			}
@@ -814,11 +897,9 @@ void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_feature
 		DBG_MODE_ACT_ON;
 	}
 #ifdef UART_TERM
-	if((u8_tanashin_trans_timer==1)||(mech_tanashin_user_to_transport((*usr_mode))!=u8_tanashin_target_mode)||(u8_tanashin_target_mode!=u8_tanashin_mode))
+	if(((u8_tanashin_trans_timer==1)||(mech_tanashin_user_to_transport((*usr_mode))!=u8_tanashin_target_mode)||(u8_tanashin_target_mode!=u8_tanashin_mode))&&UART_LOG_ON(LOG_SUB_MECH, LOG_LVL_DEBUG))
 	{
-		sprintf(u8a_tanashin_buf, "MODE|>t%03u<|u%01u}%01u>%01u|0x%02x\n\r",
-				u8_tanashin_trans_timer, (*usr_mode), u8_tanashin_mode, u8_tanashin_target_mode, in_sws);
-		UART_add_string(u8a_tanashin_buf);
+		UART_dump_mech_state(u8_tanashin_trans_timer, (*usr_mode), u8_tanashin_mode, u8_tanashin_target_mode, in_sws);
 	}
 #endif /* UART_TERM */
 }
@@ -851,12 +932,141 @@ uint8_t mech_tanashin_get_transition()
 	return u8_tanashin_trans_timer;
 }
 
+//-------------------------------------- Get current internal transport mode.
+uint8_t mech_tanashin_get_state()
+{
+	return u8_tanashin_mode;
+}
+
+//-------------------------------------- Get target internal transport mode.
+uint8_t mech_tanashin_get_target()
+{
+	return u8_tanashin_target_mode;
+}
+
 //-------------------------------------- Get transport error.
 uint8_t mech_tanashin_get_error()
 {
 	return u8_tanashin_error;
 }
 
+//-------------------------------------- Get number of mode transition retries.
+uint8_t mech_tanashin_get_retries()
+{
+	return u8_tanashin_retries;
+}
+
+//-------------------------------------- Replace timing profile (if it passes sanity check).
+// Returns 0 if profile is applied, otherwise current profile is kept.
+uint8_t mech_tanashin_set_profile(const uint8_t *in_profile)
+{
+	uint8_t u8_idx;
+	// Solenoid pulses for rewind and FWIND skip must follow in order.
+	for(u8_idx=PRF_TANA_DLY_SW_ACT;u8_idx<PRF_TANA_DLY_SKIP_END;u8_idx++)
+	{
+		if(in_profile[u8_idx]>=in_profile[u8_idx+1])
+		{
+			return 1;
+		}
+	}
+	// Each transition must be longer than its solenoid pulses and not longer than maximum mode change.
+	if((in_profile[PRF_TANA_DLY_SW_ACT]>=in_profile[PRF_TANA_DLY_PB_WAIT])||
+		(in_profile[PRF_TANA_DLY_SW_ACT]>=in_profile[PRF_TANA_DLY_STOP])||
+		(in_profile[PRF_TANA_DLY_FWIND_ACT]>=in_profile[PRF_TANA_DLY_FWIND_WAIT])||
+		(in_profile[PRF_TANA_DLY_SKIP_END]>=in_profile[PRF_TANA_DLY_PB2STOP]))
+	{
+		return 1;
+	}
+	for(u8_idx=PRF_TANA_DLY_PB_WAIT;u8_idx<PRF_TANA_DLY_ACTIVE;u8_idx++)
+	{
+		if(in_profile[u8_idx]>in_profile[PRF_TANA_DLY_ACTIVE])
+		{
+			return 1;
+		}
+	}
+	// Solenoid marks must stay near the cam positions they are made for.
+	for(u8_idx=PRF_TANA_DLY_SW_ACT;u8_idx<=PRF_TANA_DLY_SKIP_END;u8_idx++)
+	{
+		if(CAL_check_mark(in_profile[u8_idx], pgm_read_byte(&ucaf_tanashin_marks[u8_idx]))!=0)
+		{
+			return 1;
+		}
+	}
+	// Zero tacho timeout will halt the transport right away.
+	for(u8_idx=PRF_TANA_TACHO_PLAY;u8_idx<PRF_TANA_MAX;u8_idx++)
+	{
+		if(in_profile[u8_idx]==0)
+		{
+			return 1;
+		}
+	}
+	for(u8_idx=0;u8_idx<PRF_TANA_MAX;u8_idx++)
+	{
+		u8a_tanashin_profile[u8_idx] = in_profile[u8_idx];
+	}
+	return 0;
+}
+
+//-------------------------------------- Get current timing profile.
+const uint8_t *mech_tanashin_get_profile()
+{
+	return u8a_tanashin_profile;
+}
+
+//-------------------------------------- Fill calibration plan for [CAL_start()].
+// One cycle: STOP -> PLAY -> FWIND -> STOP, each by a single solenoid pulse.
+// Returns number of steps in the plan.
+uint8_t mech_tanashin_calib_plan(uint16_t *out_plan)
+{
+	out_plan[CAL_PLAN_PULSE] = (uint16_t)TIM_TANA_DLY_SW_ACT*2;
+	out_plan[CAL_PLAN_STEP] = (uint16_t)TIM_TANA_DLY_PB_WAIT*2;
+	out_plan[CAL_PLAN_SIZE+CAL_PLAN_PULSE] = (uint16_t)TIM_TANA_DLY_SW_ACT*2;
+	out_plan[CAL_PLAN_SIZE+CAL_PLAN_STEP] = (uint16_t)TIM_TANA_DLY_FWIND_WAIT*2;
+	out_plan[CAL_PLAN_SIZE*2+CAL_PLAN_PULSE] = (uint16_t)TIM_TANA_DLY_SW_ACT*2;
+	out_plan[CAL_PLAN_SIZE*2+CAL_PLAN_STEP] = (uint16_t)TIM_TANA_DLY_STOP*2;
+	return 3;
+}
+
+//-------------------------------------- Derive timing profile from measured times.
+// [in_leave] - average time from the first pulse (in STOP) to STOP sensor release (ms);
+// [in_home] - the longest time from the start of the last pulse (in FWIND) to STOP sensor activation (ms).
+// Command gear turns at fixed speed set by the capstan, so all delays are scaled from the defaults
+// by measured gear speed (STOP sensor release vs. [TIM_TANA_DLY_STOP_CLEAR]) without margin,
+// only [PRF_TANA_DLY_STOP] timeout gets 25% margin over measured time to STOP.
+// Tacho timeouts are kept from current profile.
+// Returns 0 if profile fits into the timer.
+uint8_t mech_tanashin_calib_profile(uint16_t in_leave, uint16_t in_home, uint8_t *out_profile)
+{
+	uint8_t u8_idx;
+	uint16_t u16_stop;
+	const uint8_t u8a_defaults[PRF_TANA_DLY_ACTIVE+1] =
+	{
+		TIM_TANA_DLY_SW_ACT, TIM_TANA_DLY_WAIT_REW_ACT, TIM_TANA_DLY_FWIND_ACT, TIM_TANA_DLY_FWIND_SKIP, TIM_TANA_DLY_SKIP_END,
+		TIM_TANA_DLY_PB_WAIT, TIM_TANA_DLY_FWIND_WAIT, TIM_TANA_DLY_STOP, TIM_TANA_DLY_PB2STOP, TIM_TANA_DLY_ACTIVE
+	};
+	// Scale by gear speed.
+	for(u8_idx=0;u8_idx<=PRF_TANA_DLY_ACTIVE;u8_idx++)
+	{
+		out_profile[u8_idx] = CAL_scale(u8a_defaults[u8_idx], in_leave, (uint16_t)TIM_TANA_DLY_STOP_CLEAR*2);
+		if(out_profile[u8_idx]==0)
+		{
+			return 1;
+		}
+	}
+	// Convert to 2 ms ticks with margin.
+	u16_stop = (in_home+in_home/4)/2;
+	if((u16_stop==0)||(u16_stop>0xFF))
+	{
+		return 1;
+	}
+	out_profile[PRF_TANA_DLY_STOP] = (uint8_t)u16_stop;
+	for(u8_idx=PRF_TANA_TACHO_PLAY;u8_idx<PRF_TANA_MAX;u8_idx++)
+	{
+		out_profile[u8_idx] = u8a_tanashin_profile[u8_idx];
+	}
+	return 0;
+}
+
 //-------------------------------------- Print transport mode alias.
 void mech_tanashin_UART_dump_mode(uint8_t in_mode)
 {
@@ -905,5 +1115,7 @@ void mech_tanashin_UART_dump_mode(uint8_t in_mode)
 	{
 		UART_add_flash_string((uint8_t *)cch_mode_unknown);
 	}
+#else
+	(void)in_mode;
 #endif /* UART_TERM */
 }
@@ -26,6 +26,8 @@ This mechanism does not support reverse operations.
 
 #include "drv_io.h"
 #include "strings.h"
+#include "idle_policy.h"
+#include "mech_calib.h"
 
 // Timer marks for various modes for Tanashin mechanism, contained in [u8_tanashin_trans_timer].
 // Each tick = 2 ms real time.
@@ -39,16 +41,31 @@ This mechanism does not support reverse operations.
 #define TIM_TANA_DLY_STOP			80		// 160 ms (time from the first solenoid activation in FWIND until STOP is fully selected)
 #define TIM_TANA_DLY_PB2STOP		215		// 430 ms (time from the first solenoid activation in PLAY until STOP is fully selected)
 #define TIM_TANA_DLY_ACTIVE			240		// 480 ms (time for initial stabilization/maximum mode change)
+#define TIM_TANA_DLY_STOP_CLEAR		20		// 40 ms  (command gear releases STOP sensor after the first pulse in STOP, reference for gear speed in calibration)
 
 // Maximum wait for next tacho tick for various modes, contained in [u8_tacho_timer].
 // Each tick = 20 ms real time.
 #define TACHO_TANA_PLAY_DLY_MAX		65		// 1300 ms (1...3 Hz)
 #define TACHO_TANA_FWIND_DLY_MAX	10		// 200 ms (13...56 Hz)
 
-// Power for tachometer through absent reverse record inhibit switch pin.
-#define TANA_TACHO_PWR_SETUP		(SW_DIR|=SW_NOREC_REV)
-#define TANA_TACHO_PWR_EN			(SW_PORT|=SW_NOREC_REV)
-#define TANA_TACHO_PWR_DIS			(SW_PORT&=~SW_NOREC_REV)
+// Timing profile for Tanashin mechanism in [u8a_tanashin_profile] (values above are defaults).
+// Profile can be replaced from EEPROM settings with [mech_tanashin_set_profile()].
+enum
+{
+	PRF_TANA_DLY_SW_ACT,
+	PRF_TANA_DLY_WAIT_REW_ACT,
+	PRF_TANA_DLY_FWIND_ACT,
+	PRF_TANA_DLY_FWIND_SKIP,
+	PRF_TANA_DLY_SKIP_END,
+	PRF_TANA_DLY_PB_WAIT,
+	PRF_TANA_DLY_FWIND_WAIT,
+	PRF_TANA_DLY_STOP,
+	PRF_TANA_DLY_PB2STOP,
+	PRF_TANA_DLY_ACTIVE,
+	PRF_TANA_TACHO_PLAY,
+	PRF_TANA_TACHO_FWIND,
+	PRF_TANA_MAX					// Profile size
+};
 
 // States of Tanashin mechanism for [u8_tanashin_target_mode] and [u8_tanashin_mode] (including "SUBMODES").
 enum
@@ -78,6 +95,7 @@ extern volatile const uint8_t ucaf_tanashin_mech[];
 void mech_tanashin_set_error(uint8_t in_err);							// Freeze transport due to error
 uint8_t mech_tanashin_user_to_transport(uint8_t in_mode);				// Convert user mode to transport mode
 void mech_tanashin_static_halt(uint8_t in_sws, uint8_t *usr_mode);		// Transport operations are halted, keep mechanism in this state
+void mech_tanashin_prespin(void);										// Spin up capstan ahead of the first user command
 void mech_tanashin_target2mode(uint8_t *tacho, uint8_t *usr_mode);		// Start transition from current mode to target mode
 void mech_tanashin_user2target(uint8_t *usr_mode);						// Take in user desired mode and set new target mode
 void mech_tanashin_static_mode(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode);						// Control mechanism in static mode (not transitioning between modes)
@@ -85,5 +103,12 @@ void mech_tanashin_cyclogram(uint8_t in_sws);							// Transition through modes,
 void mech_tanashin_state_machine(uint8_t in_ttr_features, uint8_t in_srv_features, uint8_t in_sws, uint8_t *tacho, uint8_t *usr_mode, uint8_t *play_dir);	// Perform tape transport state machine
 uint8_t mech_tanashin_get_mode();										// Get user-level mode of the transport
 uint8_t mech_tanashin_get_transition();									// Get transition timer count
+uint8_t mech_tanashin_get_state();										// Get current internal mode of the transport (including submodes)
+uint8_t mech_tanashin_get_target();										// Get target internal mode of the transport
 uint8_t mech_tanashin_get_error();										// Get transport error
+uint8_t mech_tanashin_get_retries();									// Get number of mode transition retries
+uint8_t mech_tanashin_set_profile(const uint8_t *in_profile);			// Replace timing profile (if it passes sanity check)
+const uint8_t *mech_tanashin_get_profile();								// Get current timing profile
+uint8_t mech_tanashin_calib_plan(uint16_t *out_plan);					// Fill calibration plan for [CAL_start()], returns number of steps
+uint8_t mech_tanashin_calib_profile(uint16_t in_leave, uint16_t in_home, uint8_t *out_profile);	// Derive timing profile from measured times to STOP release and to STOP
 void mech_tanashin_UART_dump_mode(uint8_t in_mode);						// Print transport mode alias
@@ -0,0 +1,201 @@
+﻿#include "power_dom.h"
+
+// Domains required by each power profile.
+static const uint8_t u8a_pdm_modes[PDM_MODE_MAX] PROGMEM =
+{
+	0,								// PDM_MODE_IDLE
+	(PDM_CAPSTAN|PDM_TACHO),		// PDM_MODE_STOP
+	(PDM_CAPSTAN|PDM_TACHO),		// PDM_MODE_PLAY
+	(PDM_CAPSTAN|PDM_TACHO),		// PDM_MODE_REC
+	(PDM_CAPSTAN|PDM_TACHO),		// PDM_MODE_WIND
+};
+
+static uint8_t u8_pdm_mode=PDM_MODE_IDLE;		// Current power profile
+static uint8_t u8_pdm_tacho_sw=0;				// Tachometer supply is controlled
+static uint8_t u8_pdm_clk_slow=0;				// Core clock is slowed down
+
+//-------------------------------------- Power down on-demand domains, take control of tachometer supply.
+// [in_tacho_sw] - tachometer sensor is powered from [TACHO_PWR_xxx] pin (Tanashin).
+void PDM_init(uint8_t in_tacho_sw)
+{
+	u8_pdm_tacho_sw = in_tacho_sw;
+	if(u8_pdm_tacho_sw!=0)
+	{
+		TACHO_PWR_SETUP;
+		TACHO_PWR_DIS;
+	}
+	u8_pdm_mode = PDM_MODE_IDLE;
+	PDM_release(PDM_ON_DEMAND);
+}
+
+//-------------------------------------- Switch domains for transport mode (must be called after transport state machine).
+// [in_mode] - current transport mode ([USR_MODE_xxx]);
+// [in_capstan] - capstan motor state (0 = stopped);
+// Returns 1 if power profile changed.
+uint8_t PDM_update(uint8_t in_mode, uint8_t in_capstan)
+{
+	uint8_t u8_mode, u8_need;
+	if((in_mode==USR_MODE_PLAY_FWD)||(in_mode==USR_MODE_PLAY_REV))
+	{
+		u8_mode = PDM_MODE_PLAY;
+	}
+	else if((in_mode==USR_MODE_REC_FWD)||(in_mode==USR_MODE_REC_REV))
+	{
+		u8_mode = PDM_MODE_REC;
+	}
+	else if((in_mode==USR_MODE_FWIND_FWD)||(in_mode==USR_MODE_FWIND_REV))
+	{
+		u8_mode = PDM_MODE_WIND;
+	}
+	else if(in_capstan!=0)
+	{
+		u8_mode = PDM_MODE_STOP;
+	}
+	else
+	{
+		u8_mode = PDM_MODE_IDLE;
+	}
+	u8_need = pgm_read_byte_near(u8a_pdm_modes+u8_mode);
+	if(u8_pdm_tacho_sw!=0)
+	{
+		if((u8_need&PDM_TACHO)!=0)
+		{
+			TACHO_PWR_EN;
+		}
+		else
+		{
+			TACHO_PWR_DIS;
+		}
+	}
+	if(u8_mode==u8_pdm_mode)
+	{
+		return 0;
+	}
+	u8_pdm_mode = u8_mode;
+	return 1;
+}
+
+//-------------------------------------- Power up on-demand domains.
+// Module registers keep their settings while powered down.
+void PDM_request(uint8_t in_domains)
+{
+	if((in_domains&PDM_SPI)!=0) PWR_SPI_ON;
+	if((in_domains&PDM_UART)!=0) PWR_UART_ON;
+	if((in_domains&PDM_T1)!=0) PWR_T1_ON;
+}
+
+//-------------------------------------- Power down on-demand domains.
+// Caller must make sure that module is not busy.
+void PDM_release(uint8_t in_domains)
+{
+	if((in_domains&PDM_SPI)!=0) PWR_SPI_OFF;
+	if((in_domains&PDM_UART)!=0) PWR_UART_OFF;
+	if((in_domains&PDM_T1)!=0) PWR_T1_OFF;
+}
+
+//-------------------------------------- Get powered domains.
+uint8_t PDM_get_state(void)
+{
+	uint8_t u8_state;
+	u8_state = pgm_read_byte_near(u8a_pdm_modes+u8_pdm_mode);
+	if(u8_pdm_tacho_sw==0)
+	{
+		u8_state &= ~PDM_TACHO;
+	}
+	if((PRR&(1<<PRSPI))==0) u8_state |= PDM_SPI;
+	if((PRR&(1<<PRUSART0))==0) u8_state |= PDM_UART;
+	if((PRR&(1<<PRTIM1))==0) u8_state |= PDM_T1;
+	return u8_state;
+}
+
+//-------------------------------------- Get current power profile.
+uint8_t PDM_get_mode(void)
+{
+	return u8_pdm_mode;
+}
+
+//-------------------------------------- Get estimated current for power profile.
+// On-demand domains are not included (powered for short bursts only).
+// [in_mode] - power profile ([PDM_MODE_xxx]);
+// Returns current in 10 uA units.
+uint16_t PDM_get_budget(uint8_t in_mode)
+{
+	uint8_t u8_need;
+	uint16_t u16_budget;
+	if(in_mode>=PDM_MODE_MAX)
+	{
+		return 0;
+	}
+	u8_need = pgm_read_byte_near(u8a_pdm_modes+in_mode);
+#ifdef EN_CLK_SCALE
+	// Transport is stable most of the time in any mode, core and timer run at slow clock.
+	u16_budget = PDM_CUR_CORE_SLOW+(PDM_CUR_T2/8);
+#else
+	u16_budget = PDM_CUR_CORE+PDM_CUR_T2;
+#endif /* EN_CLK_SCALE */
+	if(((u8_need&PDM_TACHO)!=0)||(u8_pdm_tacho_sw==0))
+	{
+		// Sensor without supply control is always powered.
+		u16_budget += PDM_CUR_TACHO_EXT;
+	}
+	if((u8_need&PDM_CAPSTAN)!=0)
+	{
+		u16_budget += PDM_CUR_CAPSTAN_EXT;
+	}
+	return u16_budget;
+}
+
+//-------------------------------------- Get estimated average current for sleep with periodic wake ups.
+// [in_period] - wake up period in ms (0 = no periodic wake ups);
+// Returns current in uA.
+uint16_t PDM_get_standby(uint16_t in_period)
+{
+	uint32_t u32_wake;
+	if(in_period==0)
+	{
+		return PDM_CUR_SLEEP;
+	}
+	// Charge per wake up spread over the period.
+	u32_wake = (uint32_t)PDM_CUR_WAKE*PDM_WAKE_TIME;
+	u32_wake = (u32_wake+(uint32_t)in_period*500)/((uint32_t)in_period*1000);
+	return (PDM_CUR_SLEEP+(uint16_t)u32_wake);
+}
+
+//-------------------------------------- Switch core clock between full and slow speed.
+// System timer prescaler is switched together with core clock to keep 1 ms tick.
+// USART must be powered down before slowing down (baudrate is not reachable at slow clock).
+// Must be called with interrupts enabled.
+// [in_slow] - 0 = full speed (8 MHz), otherwise slow (1 MHz);
+void PDM_set_clock(uint8_t in_slow)
+{
+	if(in_slow!=0)
+	{
+		in_slow = 1;
+	}
+	if(in_slow==u8_pdm_clk_slow)
+	{
+		return;
+	}
+	u8_pdm_clk_slow = in_slow;
+	cli();
+	if(in_slow!=0)
+	{
+		SYST_CLK_SLOW;
+		CLK_PREP;
+		CLK_SET_SLOW;
+	}
+	else
+	{
+		CLK_PREP;
+		CLK_SET_FULL;
+		SYST_CLK_FULL;
+	}
+	sei();
+}
+
+//-------------------------------------- Get core clock state.
+// Returns 1 if core clock is slowed down.
+uint8_t PDM_get_clock(void)
+{
+	return u8_pdm_clk_slow;
+}
@@ -0,0 +1,83 @@
+﻿/**************************************************************************************************************************************************************
+power_dom.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-07-28
+
+Part of the [AVRTapeControl] project.
+Power domain manager for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+
+Keeps track of resources that can be powered down: MCU modules through PRR (SPI, USART, Timer1)
+and external loads (tachometer sensor supply, capstan motor).
+Each transport mode has a set of required domains ([u8a_pdm_modes]), switched domains follow mode changes,
+on-demand domains (SPI, USART, Timer1) are powered only for the time they are used.
+Estimated current budget (in 10 uA units) is calculated from typical module currents and external loads set in [config.h].
+Core clock can be slowed down 8 times ([PDM_set_clock()]), system timer prescaler follows it to keep 1 ms tick.
+
+**************************************************************************************************************************************************************/
+
+#ifndef POWER_DOM_H_
+#define POWER_DOM_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "config.h"
+#include "common_log.h"
+#include "drv_io.h"
+
+// Power domains.
+#define PDM_SPI				(1<<0)		// SPI bus to indicators extender (on demand)
+#define PDM_UART			(1<<1)		// USART for log and telemetry output (on demand)
+#define PDM_T1				(1<<2)		// Timer1 for cycle counter or tachometer capture (on demand)
+#define PDM_TACHO			(1<<3)		// Tachometer sensor supply (switched only if enabled by [PDM_init()])
+#define PDM_CAPSTAN			(1<<4)		// Capstan motor (switched by transport state machine, only accounted here)
+#define PDM_ON_DEMAND		(PDM_SPI|PDM_UART|PDM_T1)
+
+// Power profiles of transport modes.
+enum
+{
+	PDM_MODE_IDLE,					// STOP, capstan is stopped
+	PDM_MODE_STOP,					// STOP, capstan is running (waiting for idle timeout or transition)
+	PDM_MODE_PLAY,					// PLAY in any direction
+	PDM_MODE_REC,					// RECORD in any direction
+	PDM_MODE_WIND,					// FAST WIND in any direction
+	PDM_MODE_MAX
+};
+
+// Typical additional current of MCU modules at 8 MHz, 5 V (10 uA units).
+#define PDM_CUR_CORE		400			// Active CPU core with all PRR modules off
+#define PDM_CUR_CORE_SLOW	55			// Active CPU core at slow clock (1 MHz)
+#define PDM_CUR_T2			18			// Timer2 (system tick, always on)
+#define PDM_CUR_SPI			16
+#define PDM_CUR_UART		10
+#define PDM_CUR_T1			16
+// Typical MCU current while sleeping (uA).
+#define PDM_CUR_SLEEP		25			// Power-down with watchdog and BOD running
+#define PDM_CUR_WAKE		600			// Average during wake up from power-down ([PDM_WAKE_TIME])
+
+void PDM_init(uint8_t in_tacho_sw);						// Power down all on-demand domains, enable control of tachometer supply
+uint8_t PDM_update(uint8_t in_mode, uint8_t in_capstan);	// Switch domains for transport mode, returns 1 if power profile changed
+void PDM_request(uint8_t in_domains);					// Power up on-demand domains
+void PDM_release(uint8_t in_domains);					// Power down on-demand domains
+uint8_t PDM_get_state(void);							// Get powered domains ([PDM_xxx] flags)
+uint8_t PDM_get_mode(void);								// Get current power profile ([PDM_MODE_xxx])
+uint16_t PDM_get_budget(uint8_t in_mode);				// Get estimated current for power profile (10 uA units)
+uint16_t PDM_get_standby(uint16_t in_period);			// Get estimated average sleep current with periodic wake ups (uA)
+void PDM_set_clock(uint8_t in_slow);					// Switch core clock between full and slow speed
+uint8_t PDM_get_clock(void);							// Get core clock state (1 = slow)
+
+#endif /* POWER_DOM_H_ */
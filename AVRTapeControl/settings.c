@@ -0,0 +1,87 @@
+﻿#include "settings.h"
+
+// Place of each block in RAM image: offset [EPS_xxx] and length, indexed by [SET_TAG_xxx].
+static const uint8_t u8a_set_blocks[SET_TAG_MAX][2] PROGMEM =
+{
+	{0, 0},
+	{EPS_TTR_TYPE, SET_BASE_LEN},
+	{EPS_TIM_TYPE, SET_TIMING_LEN}
+};
+
+//-------------------------------------- Decode record from EEPROM into RAM image.
+// Only bytes of known blocks are changed in [out_settings], everything else keeps current (default) values.
+uint8_t SET_decode(const uint8_t *in_record, uint8_t *out_settings)
+{
+	uint8_t u8_pos, u8_tag, u8_len, u8_copy, u8_offset, u8_idx;
+	if((in_record[SET_IDX_VERSION]&SET_VER_TLV)==0)
+	{
+		// Record from older firmware with fixed layout (transport type and features only).
+		for(u8_idx=EPS_TTR_TYPE;u8_idx<SET_OLD_LEN;u8_idx++)
+		{
+			out_settings[u8_idx] = in_record[u8_idx];
+		}
+		return SET_LEGACY;
+	}
+	u8_pos = SET_IDX_DATA;
+	while(u8_pos<SET_RECORD_SIZE)
+	{
+		u8_tag = in_record[u8_pos];
+		if(u8_tag==SET_TAG_END)
+		{
+			break;
+		}
+		// Check that block fits into the record.
+		if((u8_pos+2)>SET_RECORD_SIZE)
+		{
+			return SET_ERR_FORMAT;
+		}
+		u8_len = in_record[u8_pos+1];
+		u8_pos += 2;
+		if((u8_pos+u8_len)>SET_RECORD_SIZE)
+		{
+			return SET_ERR_FORMAT;
+		}
+		if(u8_tag<SET_TAG_MAX)
+		{
+			u8_offset = pgm_read_byte(&u8a_set_blocks[u8_tag][0]);
+			u8_copy = pgm_read_byte(&u8a_set_blocks[u8_tag][1]);
+			// Shorter block (older firmware) keeps defaults for the rest, longer block (newer firmware) is cut.
+			if(u8_copy>u8_len)
+			{
+				u8_copy = u8_len;
+			}
+			for(u8_idx=0;u8_idx<u8_copy;u8_idx++)
+			{
+				out_settings[u8_offset+u8_idx] = in_record[u8_pos+u8_idx];
+			}
+		}
+		u8_pos += u8_len;
+	}
+	return SET_OK;
+}
+
+//-------------------------------------- Encode RAM image into record for EEPROM.
+// [out_record] must be at least [SET_RECORD_SIZE] bytes long.
+void SET_encode(const uint8_t *in_settings, uint8_t *out_record)
+{
+	uint8_t u8_pos, u8_tag, u8_len, u8_offset, u8_idx;
+	out_record[SET_IDX_MARKER] = EEPROM_START_MARKER;
+	out_record[SET_IDX_VERSION] = SET_VERSION;
+	u8_pos = SET_IDX_DATA;
+	for(u8_tag=(SET_TAG_END+1);u8_tag<SET_TAG_MAX;u8_tag++)
+	{
+		u8_offset = pgm_read_byte(&u8a_set_blocks[u8_tag][0]);
+		u8_len = pgm_read_byte(&u8a_set_blocks[u8_tag][1]);
+		out_record[u8_pos++] = u8_tag;
+		out_record[u8_pos++] = u8_len;
+		for(u8_idx=0;u8_idx<u8_len;u8_idx++)
+		{
+			out_record[u8_pos++] = in_settings[u8_offset+u8_idx];
+		}
+	}
+	// Terminate container and clear unused space.
+	while(u8_pos<SET_RECORD_SIZE)
+	{
+		out_record[u8_pos++] = SET_TAG_END;
+	}
+}
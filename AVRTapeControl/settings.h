@@ -0,0 +1,96 @@
+﻿/**************************************************************************************************************************************************************
+settings.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-07-27
+
+Part of the [AVRTapeControl] project.
+Settings container for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+Settings are used from fixed-layout RAM image (indexed by [EPS_xxx]), so reading a setting is a simple array access.
+In EEPROM settings are stored as a tag-length-value container inside [SET_RECORD_SIZE]-byte record:
+	[marker][version][tag][length][value...][tag][length][value...]...[SET_TAG_END]
+Each tag is a block of settings with fixed place in RAM image, described by [SET_TAG_xxx] and [u8a_set_blocks].
+Container is decoded into RAM image once at start-up: unknown tags (from newer firmware) are skipped,
+missing tags and missing bytes at the end of shorter blocks (from older firmware) keep defaults,
+so new blocks can be added without breaking saved settings. Records of older firmware with fixed layout
+(version byte without [SET_VER_TLV] flag, [SET_OLD_LEN] bytes in [SET_OLD_SEGMENT]-byte segment) are converted:
+transport type and features are taken, everything else keeps defaults.
+
+**************************************************************************************************************************************************************/
+
+#ifndef SETTINGS_H_
+#define SETTINGS_H_
+
+#include <avr/pgmspace.h>
+#include "config.h"
+#include "drv_eeprom.h"
+
+// Settings offsets in RAM image.
+enum
+{
+	EPS_MARKER,						// Start marker position
+	EPS_TTR_TYPE,					// Transport type (if several types are enabled on compile time)
+	EPS_TTR_FTRS,					// Transport features (tacho in stop, reverse enable, etc.)
+	EPS_SRV_FTRS,					// Service features (auto-reverse, auto-rewind, etc.)
+	EPS_LOG_CFG,					// UART log configuration (muted subsystems and minimum level, see [UART_log_setup()])
+	EPS_TIM_TYPE,					// Transport type the timing profile is made for ([TIM_PROFILE_NONE] to use defaults)
+	EPS_TIM_DATA,					// Start of timing profile ([TIM_PROFILE_SIZE] bytes, layout is set by [PRF_xxx] enum of the transport)
+};
+
+#define TIM_PROFILE_NONE	0xFF	// No timing profile in settings
+
+// Settings blocks (tags of the container).
+// NOTE: tag numbers can not be changed or reused, new blocks must get new tags.
+enum
+{
+	SET_TAG_END,					// End of container
+	SET_TAG_BASE,					// Transport type, features and log configuration ([EPS_TTR_TYPE]...[EPS_LOG_CFG])
+	SET_TAG_TIMING,					// Timing profile ([EPS_TIM_TYPE] and profile data)
+	SET_TAG_MAX
+};
+
+#define SET_BASE_LEN		4							// Length of [SET_TAG_BASE] block
+#define SET_TIMING_LEN		(1+TIM_PROFILE_SIZE)		// Length of [SET_TAG_TIMING] block
+
+// Record layout.
+#define SET_IDX_MARKER		0		// Start marker ([EEPROM_START_MARKER])
+#define SET_IDX_VERSION		1		// Container version
+#define SET_IDX_DATA		2		// Start of the first block
+#define SET_VER_TLV			0x80	// Flag of container format in version byte (fixed layout has transport type in that byte)
+#define SET_VERSION			(SET_VER_TLV|1)
+
+// Record of firmware before the container (v0.14 and older): fixed layout in 16-byte EEPROM segments.
+#define SET_OLD_SEGMENT		16				// Segment size of old records
+#define SET_OLD_LEN			(EPS_SRV_FTRS+1)	// Bytes of old record in use ([EPS_MARKER]...[EPS_SRV_FTRS])
+
+#define SET_RECORD_USED		(SET_IDX_DATA+2+SET_BASE_LEN+2+SET_TIMING_LEN)	// Bytes used by all known blocks
+
+#if SET_RECORD_USED>SET_RECORD_SIZE
+	#error Settings do not fit into EEPROM record! (SET_RECORD_SIZE)
+#endif
+
+// Results of [SET_decode()].
+enum
+{
+	SET_OK,							// Container is decoded
+	SET_LEGACY,						// Fixed layout record of older firmware is converted
+	SET_ERR_FORMAT,					// Broken container (blocks before the error are decoded)
+};
+
+uint8_t SET_decode(const uint8_t *in_record, uint8_t *out_settings);		// Decode record from EEPROM into RAM image
+void SET_encode(const uint8_t *in_settings, uint8_t *out_record);		// Encode RAM image into record for EEPROM
+
+#endif /* SETTINGS_H_ */
@@ -8,6 +8,10 @@ const uint8_t cch_eeprom_err[] PROGMEM = "defaults ";
 const uint8_t cch_eeprom_load[] PROGMEM = "loaded.";
 const uint8_t cch_eeprom_save[] PROGMEM = "saved.";
 const uint8_t cch_eeprom_fail[] PROGMEM = "EEPROM: dead!";
+const uint8_t cch_set_legacy[] PROGMEM = "converted, ";
+const uint8_t cch_set_broken[] PROGMEM = "partially ";
+const uint8_t cch_tim_profile[] PROGMEM = "Timing profile: ";
+const uint8_t cch_tim_rejected[] PROGMEM = "rejected, ";
 const uint8_t cch_endl[] PROGMEM = "\n\r";
 const uint8_t cch_arrow[] PROGMEM = "->";
 const uint8_t cch_neq[] PROGMEM = "!=";
@@ -50,6 +54,7 @@ const uint8_t cch_set_auto_reverse_ab[] PROGMEM = "Auto-reverse (A-B-stop): ";
 const uint8_t cch_set_auto_reverse_loop[] PROGMEM = "Auto-reverse (loop): ";
 const uint8_t cch_set_pb_auto_rewind[] PROGMEM = "Auto-rewind after PLAY: ";
 const uint8_t cch_set_fw_auto_rewind[] PROGMEM = "Auto-rewind after FF: ";
+const uint8_t cch_set_prespin[] PROGMEM = "Capstan spin-up on cassette insertion: ";
 const uint8_t cch_set_tacho_stop[] PROGMEM = "Tacho monitor in STOP: ";
 const uint8_t cch_set_pb_btns[] PROGMEM = "Playback buttons/LEDs: ";
 const uint8_t cch_set_rec_start[] PROGMEM = "Record starting: ";
@@ -87,5 +92,66 @@ const uint8_t cch_capst_stop[] PROGMEM = "Capstan stopped in idle\n\r";
 const uint8_t cch_capst_start[] PROGMEM = "Capstan started\n\r";
 const uint8_t cch_sleep_in[] PROGMEM = "Going to sleep...\n\r";
 const uint8_t cch_sleep_out[] PROGMEM = "Waking up!\n\r";
+const uint8_t cch_sws_tape[] PROGMEM = "SWS|TAPE:";
+const uint8_t cch_sws_f_rec[] PROGMEM = "|F_REC:";
+const uint8_t cch_sws_r_rec[] PROGMEM = "|R_REC:";
+const uint8_t cch_kbd_state[] PROGMEM = "KBD";
+const uint8_t cch_kbd_up[] PROGMEM = "KBD-UP";
+const uint8_t cch_kbd_down[] PROGMEM = "KBD-DN";
+const uint8_t cch_kbd_time[] PROGMEM = "|T:";
+const uint8_t cch_kbd_rewind[] PROGMEM = "|REWN:";
+const uint8_t cch_kbd_stop[] PROGMEM = "|STOP:";
+const uint8_t cch_kbd_ffwd[] PROGMEM = "|FFWD:";
+const uint8_t cch_kbd_pb_fwd[] PROGMEM = "|PB_F:";
+const uint8_t cch_kbd_pb_rev[] PROGMEM = "|PB_R:";
+const uint8_t cch_kbd_rec[] PROGMEM = "|REC:";
+const uint8_t cch_mech_timer[] PROGMEM = "MODE|>t";
+const uint8_t cch_mech_user[] PROGMEM = "<|u";
+const uint8_t cch_mech_sws[] PROGMEM = "|0x";
+const uint8_t cch_sleep_state[] PROGMEM = "SLEEP|";
+const uint8_t cch_log_cfg[] PROGMEM = "LOG|CFG:0x";
+const uint8_t cch_log_filtered[] PROGMEM = "|FLT:";
+const uint8_t cch_log_lost[] PROGMEM = "|LOST:";
+const uint8_t cch_stat_play[] PROGMEM = "STAT|PB:0x";
+const uint8_t cch_stat_record[] PROGMEM = "|RC:0x";
+const uint8_t cch_stat_fwind[] PROGMEM = "|FW:0x";
+const uint8_t cch_stat_capstan[] PROGMEM = "|CAP:0x";
+const uint8_t cch_stat_solenoid[] PROGMEM = "|SOL:0x";
+const uint8_t cch_stat_retries[] PROGMEM = "|RTR:0x";
+const uint8_t cch_stat_halts[] PROGMEM = "|HLT:0x";
+const uint8_t cch_crc_engine[] PROGMEM = "CRC|ENG:";
+const uint8_t cch_crc_cycles[] PROGMEM = "|CPB:";
+const uint8_t cch_crc_table[] PROGMEM = "|TBL:";
+const uint8_t cch_crc_mismatch[] PROGMEM = "|MISMATCH";
+const uint8_t cch_pwr_idle[] PROGMEM = "PWR|IDLE:";
+const uint8_t cch_pwr_stop[] PROGMEM = "|STOP:";
+const uint8_t cch_pwr_play[] PROGMEM = "|PLAY:";
+const uint8_t cch_pwr_rec[] PROGMEM = "|REC:";
+const uint8_t cch_pwr_wind[] PROGMEM = "|WIND:";
+const uint8_t cch_pwr_unit[] PROGMEM = " mA";
+const uint8_t cch_pwr_mode[] PROGMEM = "PWR|MODE:";
+const uint8_t cch_pwr_domains[] PROGMEM = "|DOM:0x";
+const uint8_t cch_pwr_budget[] PROGMEM = "|EST:";
+const uint8_t cch_pwr_sleep[] PROGMEM = "PWR|SLEEP:";
+const uint8_t cch_pwr_unit_ua[] PROGMEM = " uA";
+const uint8_t cch_sleep_polls[] PROGMEM = "POLLS:";
+const uint8_t cch_wake_cmd[] PROGMEM = "WAKE|CMD:";
+const uint8_t cch_wake_mode[] PROGMEM = "|MODE:";
+const uint8_t cch_wake_unit[] PROGMEM = " ms\n\r";
+const uint8_t cch_cmd_next[] PROGMEM = "Next queued mode: ";
+const uint8_t cch_fast_reverse[] PROGMEM = "STOP reached, fast auto-reverse to ";
+const uint8_t cch_stop_anchor[] PROGMEM = "STOP released, cyclogram shifted by ms: ";
+const uint8_t cch_spinup_done[] PROGMEM = "Capstan speed is stable by tacho after ";
+const uint8_t cch_idle_timeout[] PROGMEM = "IDLE|TO:";
+const uint8_t cch_idle_avoided[] PROGMEM = " s|AVD:";
+const uint8_t cch_idle_spinups[] PROGMEM = "|SPN:";
+const uint8_t cch_prespin[] PROGMEM = "Cassette inserted, spinning up capstan\n\r";
+const uint8_t cch_cal_start[] PROGMEM = "Timing calibration started...\n\r";
+const uint8_t cch_cal_leave[] PROGMEM = "CAL|LEAVE:";
+const uint8_t cch_cal_home[] PROGMEM = "|HOME:";
+const uint8_t cch_cal_spread[] PROGMEM = "|SPREAD:";
+const uint8_t cch_cal_tacho[] PROGMEM = "|TACHO:";
+const uint8_t cch_cal_ms[] PROGMEM = " ms\n\r";
+const uint8_t cch_cal_fail[] PROGMEM = "Calibration failed, error: ";
 
 #endif /* UART_TERM */
@@ -37,6 +37,10 @@ extern const uint8_t cch_eeprom_err[];
 extern const uint8_t cch_eeprom_load[];
 extern const uint8_t cch_eeprom_save[];
 extern const uint8_t cch_eeprom_fail[];
+extern const uint8_t cch_set_legacy[];
+extern const uint8_t cch_set_broken[];
+extern const uint8_t cch_tim_profile[];
+extern const uint8_t cch_tim_rejected[];
 extern const uint8_t cch_endl[];
 extern const uint8_t cch_arrow[];
 extern const uint8_t cch_neq[];
@@ -79,6 +83,7 @@ extern const uint8_t cch_set_auto_reverse_ab[];
 extern const uint8_t cch_set_auto_reverse_loop[];
 extern const uint8_t cch_set_pb_auto_rewind[];
 extern const uint8_t cch_set_fw_auto_rewind[];
+extern const uint8_t cch_set_prespin[];
 extern const uint8_t cch_set_tacho_stop[];
 extern const uint8_t cch_set_pb_btns[];
 extern const uint8_t cch_set_rec_start[];
@@ -116,6 +121,67 @@ extern const uint8_t cch_capst_stop[];
 extern const uint8_t cch_capst_start[];
 extern const uint8_t cch_sleep_in[];
 extern const uint8_t cch_sleep_out[];
+extern const uint8_t cch_sws_tape[];
+extern const uint8_t cch_sws_f_rec[];
+extern const uint8_t cch_sws_r_rec[];
+extern const uint8_t cch_kbd_state[];
+extern const uint8_t cch_kbd_up[];
+extern const uint8_t cch_kbd_down[];
+extern const uint8_t cch_kbd_time[];
+extern const uint8_t cch_kbd_rewind[];
+extern const uint8_t cch_kbd_stop[];
+extern const uint8_t cch_kbd_ffwd[];
+extern const uint8_t cch_kbd_pb_fwd[];
+extern const uint8_t cch_kbd_pb_rev[];
+extern const uint8_t cch_kbd_rec[];
+extern const uint8_t cch_mech_timer[];
+extern const uint8_t cch_mech_user[];
+extern const uint8_t cch_mech_sws[];
+extern const uint8_t cch_sleep_state[];
+extern const uint8_t cch_log_cfg[];
+extern const uint8_t cch_log_filtered[];
+extern const uint8_t cch_log_lost[];
+extern const uint8_t cch_stat_play[];
+extern const uint8_t cch_stat_record[];
+extern const uint8_t cch_stat_fwind[];
+extern const uint8_t cch_stat_capstan[];
+extern const uint8_t cch_stat_solenoid[];
+extern const uint8_t cch_stat_retries[];
+extern const uint8_t cch_stat_halts[];
+extern const uint8_t cch_crc_engine[];
+extern const uint8_t cch_crc_cycles[];
+extern const uint8_t cch_crc_table[];
+extern const uint8_t cch_crc_mismatch[];
+extern const uint8_t cch_pwr_idle[];
+extern const uint8_t cch_pwr_stop[];
+extern const uint8_t cch_pwr_play[];
+extern const uint8_t cch_pwr_rec[];
+extern const uint8_t cch_pwr_wind[];
+extern const uint8_t cch_pwr_unit[];
+extern const uint8_t cch_pwr_mode[];
+extern const uint8_t cch_pwr_domains[];
+extern const uint8_t cch_pwr_budget[];
+extern const uint8_t cch_pwr_sleep[];
+extern const uint8_t cch_pwr_unit_ua[];
+extern const uint8_t cch_sleep_polls[];
+extern const uint8_t cch_wake_cmd[];
+extern const uint8_t cch_wake_mode[];
+extern const uint8_t cch_wake_unit[];
+extern const uint8_t cch_cmd_next[];
+extern const uint8_t cch_fast_reverse[];
+extern const uint8_t cch_stop_anchor[];
+extern const uint8_t cch_spinup_done[];
+extern const uint8_t cch_idle_timeout[];
+extern const uint8_t cch_idle_avoided[];
+extern const uint8_t cch_idle_spinups[];
+extern const uint8_t cch_prespin[];
+extern const uint8_t cch_cal_start[];
+extern const uint8_t cch_cal_leave[];
+extern const uint8_t cch_cal_home[];
+extern const uint8_t cch_cal_spread[];
+extern const uint8_t cch_cal_tacho[];
+extern const uint8_t cch_cal_ms[];
+extern const uint8_t cch_cal_fail[];
 
 #endif /* UART_TERM */
 
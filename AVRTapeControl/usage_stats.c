@@ -0,0 +1,217 @@
+﻿#include "usage_stats.h"
+
+#ifdef EN_STAT_EEPROM
+
+static uint32_t u32a_stat_cnt[STAT_CNT_MAX];			// Usage counters
+static uint8_t u8a_stat_rec[STAT_REC_SIZE];				// Journal record buffer
+static uint8_t u8_stat_slot=0;							// Journal slot for the next record
+static uint8_t u8_stat_seq=0;							// Sequence number for the next record
+static uint8_t u8_stat_dirty=0;							// Counters changed since last flush
+static uint8_t u8_stat_half_sec=0;						// Divider from 2 Hz to 1 Hz
+static uint16_t u16_stat_since_flush=0;					// Active time since last flush (seconds)
+static uint8_t u8_stat_sol_old=0;						// Solenoid state on previous call
+static uint8_t u8_stat_retries_old=0;					// Retries count on previous call
+static uint8_t u8_stat_error_old=TTR_ERR_NONE;			// Transport error on previous call
+
+//-------------------------------------- Read journal record from the slot and check it.
+// Returns 1 if record is valid (and is loaded into [u8a_stat_rec]), returns 0 otherwise.
+static uint8_t STAT_read_slot(uint8_t in_slot)
+{
+	uint16_t u16_addr;
+	uint8_t u8_idx, u8_crc;
+	u16_addr = STAT_AREA_START+(uint16_t)in_slot*STAT_REC_SIZE;
+	EEPROM_read_byte(&u16_addr, STAT_IDX_MARKER, u8a_stat_rec);
+	if(u8a_stat_rec[STAT_IDX_MARKER]!=STAT_REC_MARKER)
+	{
+		return 0;
+	}
+	u8_crc = CRC8_init();
+	for(u8_idx=0;u8_idx<STAT_REC_SIZE;u8_idx++)
+	{
+		EEPROM_read_byte(&u16_addr, u8_idx, u8a_stat_rec+u8_idx);
+		if(u8_idx<STAT_IDX_CRC)
+		{
+			u8_crc = CRC8_calc(u8_crc, u8a_stat_rec[u8_idx]);
+		}
+	}
+	return (u8a_stat_rec[STAT_IDX_CRC]==u8_crc)?1:0;
+}
+
+//-------------------------------------- Load the newest valid record from the journal.
+// Sequence numbers are compared with serial number arithmetic (8-bit wrap-around).
+// Corrupted (interrupted) records are skipped, counters start from zero if no valid record is found.
+void STAT_load(void)
+{
+	uint8_t u8_slot, u8_best_slot, u8_best_seq, u8_idx, u8_cnt;
+	u8_best_slot = STAT_SLOT_COUNT;
+	u8_best_seq = 0;
+	for(u8_slot=0;u8_slot<STAT_SLOT_COUNT;u8_slot++)
+	{
+		if(STAT_read_slot(u8_slot)!=0)
+		{
+			if((u8_best_slot==STAT_SLOT_COUNT)||((int8_t)(u8a_stat_rec[STAT_IDX_SEQ]-u8_best_seq)>0))
+			{
+				u8_best_slot = u8_slot;
+				u8_best_seq = u8a_stat_rec[STAT_IDX_SEQ];
+			}
+		}
+	}
+	for(u8_cnt=0;u8_cnt<STAT_CNT_MAX;u8_cnt++)
+	{
+		u32a_stat_cnt[u8_cnt] = 0;
+	}
+	if(u8_best_slot==STAT_SLOT_COUNT)
+	{
+		// Empty journal, start from the first slot.
+		u8_stat_slot = 0;
+		u8_stat_seq = 0;
+		return;
+	}
+	STAT_read_slot(u8_best_slot);
+	for(u8_cnt=0;u8_cnt<STAT_CNT_MAX;u8_cnt++)
+	{
+		for(u8_idx=4;u8_idx>0;u8_idx--)
+		{
+			u32a_stat_cnt[u8_cnt] = (u32a_stat_cnt[u8_cnt]<<8)|u8a_stat_rec[STAT_IDX_CNT+u8_cnt*4+u8_idx-1];
+		}
+	}
+	// Next record goes into the next slot, newest valid one is not touched.
+	u8_stat_slot = u8_best_slot+1;
+	if(u8_stat_slot>=STAT_SLOT_COUNT)
+	{
+		u8_stat_slot = 0;
+	}
+	u8_stat_seq = u8_best_seq+1;
+}
+
+//-------------------------------------- Increase the counter (saturating).
+static void STAT_add(uint8_t in_idx, uint8_t in_value)
+{
+	if(u32a_stat_cnt[in_idx]<=(0xFFFFFFFF-in_value))
+	{
+		u32a_stat_cnt[in_idx] += in_value;
+		u8_stat_dirty = 1;
+	}
+}
+
+//-------------------------------------- Account run time.
+// Must be called at 2 Hz rate while MCU is active,
+// periodic flush is also performed here (no more than once per [STAT_FLUSH_PERIOD] seconds).
+// [in_mode] - current user-level transport mode ([USR_MODE_xxx]);
+// [in_capstan] - capstan state (non-zero if capstan is running);
+void STAT_count_time(uint8_t in_mode, uint8_t in_capstan)
+{
+	u8_stat_half_sec++;
+	if(u8_stat_half_sec<2)
+	{
+		return;
+	}
+	u8_stat_half_sec = 0;
+	if(u16_stat_since_flush<0xFFFF)
+	{
+		u16_stat_since_flush++;
+	}
+	if((in_mode==USR_MODE_PLAY_FWD)||(in_mode==USR_MODE_PLAY_REV))
+	{
+		STAT_add(STAT_CNT_PLAY, 1);
+	}
+	else if((in_mode==USR_MODE_REC_FWD)||(in_mode==USR_MODE_REC_REV))
+	{
+		STAT_add(STAT_CNT_RECORD, 1);
+	}
+	else if((in_mode==USR_MODE_FWIND_FWD)||(in_mode==USR_MODE_FWIND_REV))
+	{
+		STAT_add(STAT_CNT_FWIND, 1);
+	}
+	if(in_capstan!=0)
+	{
+		STAT_add(STAT_CNT_CAPSTAN, 1);
+	}
+	STAT_flush(STAT_FLUSH_PERIOD);
+}
+
+//-------------------------------------- Account transport events.
+// Must be called after each run of the transport state machine.
+// [in_solenoid] - solenoid state (non-zero if solenoid is energized), rising edges are counted;
+// [in_retries] - current mode transition retries count of the transport, increments are counted;
+// [in_error] - current transport error ([TTR_ERR_xxx]), transitions into error state are counted as HALT events;
+void STAT_count_events(uint8_t in_solenoid, uint8_t in_retries, uint8_t in_error)
+{
+	if((in_solenoid!=0)&&(u8_stat_sol_old==0))
+	{
+		STAT_add(STAT_CNT_SOLENOID, 1);
+	}
+	if(in_retries>u8_stat_retries_old)
+	{
+		STAT_add(STAT_CNT_RETRIES, (in_retries-u8_stat_retries_old));
+	}
+	if((in_error!=TTR_ERR_NONE)&&(u8_stat_error_old==TTR_ERR_NONE))
+	{
+		STAT_add(STAT_CNT_HALTS, 1);
+	}
+	u8_stat_sol_old = in_solenoid;
+	u8_stat_retries_old = in_retries;
+	u8_stat_error_old = in_error;
+}
+
+//-------------------------------------- Queue journal record into EEPROM.
+// Record is written in background by EEPROM ready interrupt (CRC last).
+// [in_min_gap] - minimum active time since last flush (seconds);
+// Returns 1 if record is queued, returns 0 if counters did not change, wear budget is exceeded or EEPROM is busy.
+uint8_t STAT_flush(uint16_t in_min_gap)
+{
+	uint8_t u8_idx, u8_cnt, u8_crc;
+	uint32_t u32_value;
+	if((u8_stat_dirty==0)||(u16_stat_since_flush<in_min_gap)||(EEPROM_is_busy()!=0))
+	{
+		return 0;
+	}
+	u8a_stat_rec[STAT_IDX_MARKER] = STAT_REC_MARKER;
+	u8a_stat_rec[STAT_IDX_SEQ] = u8_stat_seq;
+	u8_idx = STAT_IDX_CNT;
+	for(u8_cnt=0;u8_cnt<STAT_CNT_MAX;u8_cnt++)
+	{
+		u32_value = u32a_stat_cnt[u8_cnt];
+		u8a_stat_rec[u8_idx++] = (uint8_t)u32_value;
+		u8a_stat_rec[u8_idx++] = (uint8_t)(u32_value>>8);
+		u8a_stat_rec[u8_idx++] = (uint8_t)(u32_value>>16);
+		u8a_stat_rec[u8_idx++] = (uint8_t)(u32_value>>24);
+	}
+	while(u8_idx<STAT_IDX_CRC)
+	{
+		// Reserved bytes are left erased.
+		u8a_stat_rec[u8_idx++] = EEPROM_ERASED_DATA;
+	}
+	u8_crc = CRC8_init();
+	for(u8_idx=0;u8_idx<STAT_IDX_CRC;u8_idx++)
+	{
+		u8_crc = CRC8_calc(u8_crc, u8a_stat_rec[u8_idx]);
+	}
+	u8a_stat_rec[STAT_IDX_CRC] = u8_crc;
+	if(EEPROM_queue_raw((STAT_AREA_START+(uint16_t)u8_stat_slot*STAT_REC_SIZE), u8a_stat_rec, STAT_REC_SIZE)!=EEPROM_OK)
+	{
+		return 0;
+	}
+	u8_stat_slot++;
+	if(u8_stat_slot>=STAT_SLOT_COUNT)
+	{
+		u8_stat_slot = 0;
+	}
+	u8_stat_seq++;
+	u8_stat_dirty = 0;
+	u16_stat_since_flush = 0;
+	return 1;
+}
+
+//-------------------------------------- Get value of the counter.
+// [in_idx] - counter index ([STAT_CNT_xxx]);
+uint32_t STAT_get_counter(uint8_t in_idx)
+{
+	if(in_idx>=STAT_CNT_MAX)
+	{
+		return 0;
+	}
+	return u32a_stat_cnt[in_idx];
+}
+
+#endif /* EN_STAT_EEPROM */
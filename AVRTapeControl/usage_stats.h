@@ -0,0 +1,87 @@
+﻿/**************************************************************************************************************************************************************
+usage_stats.h
+
+Copyright © 2024 Maksim Kryukov <fagear@mail.ru>
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Created: 2024-07-20
+
+Part of the [AVRTapeControl] project.
+Usage statistics journal for AVR MCUs and AtmelStudio/AVRStudio/WinAVR/avr-gcc compilers.
+Counters (run time per mode, capstan on-time, solenoid actuations, mode transition retries, HALT events)
+are accumulated in RAM and flushed into EEPROM space after [EEPROM_AREA_SIZE] (not used by settings).
+Each flush appends a [STAT_REC_SIZE]-byte record into the next slot of the journal (round-robin),
+record holds a sequence number and CRC-8, so torn writes are skipped and the newest valid record is loaded on start-up.
+Number of flushes is limited by wear budget: no more than one flush per [STAT_FLUSH_GAP] seconds of active time.
+
+**************************************************************************************************************************************************************/
+
+#ifndef USAGE_STATS_H_
+#define USAGE_STATS_H_
+
+#include "config.h"
+#include "common_log.h"
+#include "drv_eeprom.h"
+
+#ifdef EN_STAT_EEPROM
+
+#ifndef USE_EEPROM
+	#error Usage stats require EEPROM! (USE_EEPROM)
+#endif
+
+#define STAT_REC_SIZE		32			// Size of one journal record (bytes)
+#define STAT_REC_MARKER		0x5A		// Marker byte of journal record
+#define STAT_AREA_START		EEPROM_AREA_SIZE	// Start address of the journal in EEPROM
+#define STAT_SLOT_COUNT		((EEPROM_ROM_SIZE-STAT_AREA_START)/STAT_REC_SIZE)	// Number of records that fit in the journal
+#if STAT_SLOT_COUNT<2
+	#error Not enough EEPROM for usage stats journal! (EEPROM_AREA_SIZE)
+#endif
+#if EEPROM_JOB_BUF_SIZE<STAT_REC_SIZE
+	#error EEPROM job buffer does not fit usage stats record! (EEPROM_JOB_BUF_SIZE)
+#endif
+
+// Usage counters (32-bit each).
+enum
+{
+	STAT_CNT_PLAY,					// Time in playback (seconds)
+	STAT_CNT_RECORD,				// Time in record (seconds)
+	STAT_CNT_FWIND,					// Time in fast wind (seconds)
+	STAT_CNT_CAPSTAN,				// Capstan on-time (seconds)
+	STAT_CNT_SOLENOID,				// Solenoid actuations
+	STAT_CNT_RETRIES,				// Mode transition retries
+	STAT_CNT_HALTS,					// HALT events
+	STAT_CNT_MAX
+};
+
+// Journal record layout.
+enum
+{
+	STAT_IDX_MARKER,				// Record marker ([STAT_REC_MARKER])
+	STAT_IDX_SEQ,					// Sequence number (8-bit, wraps around)
+	STAT_IDX_CNT,					// First counter ([STAT_CNT_MAX] counters, 4 bytes each, LSB first)
+	STAT_IDX_CRC=(STAT_REC_SIZE-1)	// CRC-8 of all previous bytes
+};
+#if (STAT_IDX_CNT+STAT_CNT_MAX*4)>STAT_IDX_CRC
+	#error Usage counters do not fit into journal record! (STAT_REC_SIZE)
+#endif
+
+void STAT_load(void);										// Load the newest valid record from the journal
+void STAT_count_time(uint8_t in_mode, uint8_t in_capstan);	// Account run time (must be called at 2 Hz)
+void STAT_count_events(uint8_t in_solenoid, uint8_t in_retries, uint8_t in_error);	// Account transport events (called after each state machine run)
+uint8_t STAT_flush(uint16_t in_min_gap);					// Queue journal record if counters changed and wear budget allows
+uint32_t STAT_get_counter(uint8_t in_idx);					// Get value of the counter
+
+#endif /* EN_STAT_EEPROM */
+
+#endif /* USAGE_STATS_H_ */
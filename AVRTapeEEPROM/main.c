@@ -1,22 +1,56 @@
+#ifdef _WIN32
 #include <conio.h>
+#endif
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
-// EEPROM settings offsets (NOTE: keep in sync with enum in [avrtape.h]).
+// Settings offsets in RAM image (NOTE: keep in sync with enum in [settings.h]).
 enum
 {
     EPS_MARKER,						// Start marker position
     EPS_TTR_TYPE,					// Transport type (if several types are enabled on compile time)
     EPS_TTR_FTRS,					// Transport features (tacho in stop, reverse enable, etc.)
     EPS_SRV_FTRS,					// Service features (auto-reverse, auto-rewind, etc.)
+    EPS_LOG_CFG,					// UART log configuration (muted subsystems and minimum level)
+    EPS_TIM_TYPE,					// Transport type the timing profile is made for
+    EPS_TIM_DATA,					// Start of timing profile
 };
 
 // EEPROM settings (NOTE: keep in sync with defines in [config.h] and [drv_eeprom.h]).
 #define EEPROM_START_MARKER		0xA5
-#define SETTINGS_SIZE		5		// Number of bytes for full [settings_data] union
-#define EEPROM_STORE_SIZE	16		// EEPROM settings length
+#define TIM_PROFILE_SIZE	13		// Number of bytes reserved for mechanism timing profile
+#define SETTINGS_SIZE		(6+TIM_PROFILE_SIZE)	// Number of bytes for RAM image of settings
+#define SET_RECORD_SIZE		29		// Number of bytes for settings container
+#define EEPROM_STORE_SIZE	32		// EEPROM settings length
+#define EEPROM_SEQ_POSITION	(EEPROM_STORE_SIZE-2)
 #define EEPROM_CRC_POSITION	(EEPROM_STORE_SIZE-1)
+#define EEPROM_ROM_SIZE		1024	// EEPROM size of ATmega328P (whole image is written to clear old records)
+#define EEPROM_ROM_MAX		2048	// Largest EEPROM of supported MCUs
+#define EEPROM_STAT_AREA	512		// Space for settings records with usage stats journal enabled ([EEPROM_AREA_SIZE] in [config.h])
+#define EEPROM_ERASED_BYTE	0xFF	// EEPROM cell state after erasing (not inverted)
+
+// Settings container (NOTE: keep in sync with [settings.h]).
+enum
+{
+    SET_TAG_END,					// End of container
+    SET_TAG_BASE,					// Transport type, features and log configuration
+    SET_TAG_TIMING,					// Timing profile
+    SET_TAG_MAX
+};
+
+#define SET_IDX_VERSION		1		// Container version
+#define SET_IDX_DATA		2		// Start of the first block
+#define SET_VERSION			0x81	// Container format, version 1
+
+// Place of each block in RAM image (NOTE: keep in sync with [settings.c]).
+static const uint8_t lut_set_blocks[SET_TAG_MAX][2] =
+{
+    {0, 0},
+    {EPS_TTR_TYPE, 4},
+    {EPS_TIM_TYPE, (1+TIM_PROFILE_SIZE)}
+};
 
 // Supported tape transports (NOTE: keep in sync with enum in [avrtape.h]).
 enum
@@ -34,6 +68,28 @@ static const uint8_t lut_ttr_names[TTR_TYPE_COUNT][64] =
     "Kenwood mechanism (not supported)",
 };
 
+// Mechanism timing profiles (NOTE: keep in sync with [PRF_xxx] enums and defaults in [mech_tanashin.h], [mech_crp42602y.h] and [mech_knwd.h]).
+#define TIM_PROFILE_NONE	0xFF	// No timing profile, firmware defaults are used
+
+static const uint8_t lut_prf_sizes[TTR_TYPE_COUNT] = {12, 13, 9};
+
+static const char *lut_prf_names[TTR_TYPE_COUNT][TIM_PROFILE_SIZE] =
+{
+    {"DLY_SW_ACT", "DLY_WAIT_REW_ACT", "DLY_FWIND_ACT", "DLY_FWIND_SKIP", "DLY_SKIP_END", "DLY_PB_WAIT",
+     "DLY_FWIND_WAIT", "DLY_STOP", "DLY_PB2STOP", "DLY_ACTIVE", "TACHO_PLAY", "TACHO_FWIND"},
+    {"DLY_STOP", "DLY_WAIT_HEAD", "DLY_HEAD_DIR", "DLY_WAIT_PINCH", "DLY_PINCH_EN", "DLY_WAIT_TAKEUP", "DLY_TAKEUP_DIR",
+     "DLY_WAIT_MODE", "DLY_ACTIVE", "DLY_WAIT_STOP", "TACHO_STOP", "TACHO_PLAY", "TACHO_FWIND"},
+    {"DLY_SW_ACT", "DLY_STOP", "DLY_PB_WAIT", "DLY_FWIND_WAIT", "DLY_ACTIVE", "DLY_WAIT_STOP",
+     "TACHO_STOP", "TACHO_PLAY", "TACHO_FWIND"},
+};
+
+static const uint8_t lut_prf_defaults[TTR_TYPE_COUNT][TIM_PROFILE_SIZE] =
+{
+    {8, 35, 85, 110, 135, 210, 155, 80, 215, 240, 65, 10},
+    {23, 12, 24, 52, 73, 128, 144, 184, 210, 160, 12, 50, 10},
+    {14, 23, 240, 240, 240, 240, 240, 240, 240},
+};
+
 // Flags for transport features for (NOTE: keep in sync with enum in [common_log.h]).
 enum
 {
@@ -50,6 +106,21 @@ enum
     SRV_FEA_PB_LOOP		= (1<<3),	// Enable full auto-reverse (PB FWD -> PB REV -> PB FWD -> ...)
     SRV_FEA_PBF2REW		= (1<<4),	// Enable auto-rewind for forward PLAY (PB FWD -> FW REV -> STOP) (lower priority than [SRV_FEA_PB_LOOP])
     SRV_FEA_FF2REW		= (1<<5),	// Enable auto-rewind for fast forward (FW FWD -> FW REV -> STOP)
+    SRV_FEA_PRESPIN		= (1<<6),	// Enable capstan spin-up on cassette insertion (before the first command)
+};
+
+// UART log configuration (NOTE: keep in sync with defines in [drv_uart.h] and [config.h]).
+#define LOG_CFG_MUTE_MASK	0x1F					// Bit per subsystem: 1 = muted
+#define LOG_CFG_LVL_SHIFT	5
+#define LOG_CFG_LVL_MASK	(0x03<<LOG_CFG_LVL_SHIFT)	// Minimum level to output
+#define UART_LOG_DEFAULT	0x20					// All subsystems, INFO and above
+
+static const uint8_t lut_log_levels[4][8] =
+{
+    "DEBUG",
+    "INFO",
+    "WARN",
+    "ERROR",
 };
 
 #define TTR_FEA_DEFAULT				(TTR_FEA_REV_ENABLE)	// Default transport feature settings
@@ -96,7 +167,73 @@ volatile const uint8_t ucaf_compile_date[] = __DATE__;		// Date of compilation
 volatile const uint8_t ucaf_info[] = "ATmega tape controller EEPROM image creator";		// Software description
 volatile const uint8_t ucaf_author[] = "Maksim Kryukov aka Fagear";					// Author
 volatile const uint8_t ucaf_url[] = "https://github.com/Fagear/AVRTapeControl";		// URL
-volatile const uint8_t ucaf_eep[] = "avrtape_eep.bin";     // EEPROM file name
+volatile const uint8_t ucaf_eep[] = "avrtape_eep";         // EEPROM file name (without extension)
+
+// Output formats for EEPROM image.
+enum
+{
+    OUT_BIN = (1<<0),               // Raw binary image
+    OUT_HEX = (1<<1),               // Intel HEX image
+};
+
+#define HEX_LINE_SIZE   16          // Number of data bytes in one Intel HEX record
+#define CFG_LINE_SIZE   256         // Maximum length of a line in config file
+#define NAME_SIZE       192         // Maximum length of output file name
+
+// Everything needed to produce EEPROM image for one unit.
+typedef struct
+{
+    uint8_t settings[SETTINGS_SIZE];        // RAM image of settings
+    uint8_t prf_data[TIM_PROFILE_SIZE];     // Timing profile values from input
+    uint8_t prf_count;                      // Number of values in [prf_data], 0 = firmware defaults
+    uint16_t rom_size;                      // EEPROM size of the MCU
+    uint16_t area_size;                     // EEPROM space for settings records
+    uint16_t slot;                          // Segment index to put the record into
+    uint8_t out_fmt;                        // Output formats ([OUT_BIN], [OUT_HEX])
+    char name[NAME_SIZE];                   // Output file name (without extension)
+} unit_t;
+
+// Settings bits that can be set in command line/config file.
+typedef struct
+{
+    const char *key;
+    uint8_t offset;
+    uint8_t mask;
+} flag_key_t;
+
+static const flag_key_t lut_flag_keys[] =
+{
+    {"stop_tacho",  EPS_TTR_FTRS,   TTR_FEA_STOP_TACHO},
+    {"reverse",     EPS_TTR_FTRS,   TTR_FEA_REV_ENABLE},
+    {"two_plays",   EPS_SRV_FTRS,   SRV_FEA_TWO_PLAYS},
+    {"one2rec",     EPS_SRV_FTRS,   SRV_FEA_ONE2REC},
+    {"autorev",     EPS_SRV_FTRS,   SRV_FEA_PB_AUTOREV},
+    {"loop",        EPS_SRV_FTRS,   SRV_FEA_PB_LOOP},
+    {"pbf2rew",     EPS_SRV_FTRS,   SRV_FEA_PBF2REW},
+    {"ff2rew",      EPS_SRV_FTRS,   SRV_FEA_FF2REW},
+    {"prespin",     EPS_SRV_FTRS,   SRV_FEA_PRESPIN},
+};
+
+static const char *lut_ttr_keys[TTR_TYPE_COUNT] = {"tanashin", "crp42602y", "kenwood"};
+
+#ifndef _WIN32
+// Replacement for [getch()] from [conio.h]: returns the first char of entered line.
+int getch(void)
+{
+    int in_char, line_char;
+    do
+    {
+        in_char = getchar();
+    }
+    while((in_char == '\n')||(in_char == '\r'));
+    line_char = in_char;
+    while((line_char != '\n')&&(line_char != EOF))
+    {
+        line_char = getchar();
+    }
+    return in_char;
+}
+#endif
 
 uint8_t CRC8_init(void)
 {
@@ -153,51 +290,128 @@ void print_settings(uint8_t *set_arr)
 
     selector = (set_arr[EPS_SRV_FTRS] & SRV_FEA_FF2REW);
     printf("Auto-rewind after fast forward: %s\n\r", selector ? "yes" : "no");
+
+    selector = (set_arr[EPS_SRV_FTRS] & SRV_FEA_PRESPIN);
+    printf("Capstan spin-up on cassette insertion: %s\n\r", selector ? "yes" : "no");
+
+    selector = ((set_arr[EPS_LOG_CFG] & LOG_CFG_LVL_MASK) >> LOG_CFG_LVL_SHIFT);
+    printf("UART log level (debug builds only): %s and above\n\r", lut_log_levels[selector]);
+
+    if(set_arr[EPS_TIM_TYPE] == set_arr[EPS_TTR_TYPE])
+    {
+        printf("Timing profile (DLY in 2 ms ticks, TACHO in 20 ms ticks):\n\r");
+        for(selector = 0; selector < lut_prf_sizes[set_arr[EPS_TTR_TYPE]]; selector++)
+        {
+            printf("    %-16s %3u\n\r", lut_prf_names[set_arr[EPS_TTR_TYPE]][selector], set_arr[EPS_TIM_DATA+selector]);
+        }
+    }
+    else
+    {
+        printf("Timing profile: firmware defaults\n\r");
+    }
+}
+
+void input_profile(uint8_t *set_arr)
+{
+    char in_line[16];
+    uint8_t ttr_type, idx;
+    unsigned long in_value;
+    ttr_type = set_arr[EPS_TTR_TYPE];
+    printf("Enter values (DLY in 2 ms ticks, TACHO in 20 ms ticks, 1...255), empty input keeps the default.\n\r");
+    printf("NOTE: firmware rejects the whole profile if the order of cyclogram marks is broken.\n\r");
+    for(idx = 0; idx < lut_prf_sizes[ttr_type]; idx++)
+    {
+        set_arr[EPS_TIM_DATA+idx] = lut_prf_defaults[ttr_type][idx];
+        printf("%-16s [%3u]: ", lut_prf_names[ttr_type][idx], lut_prf_defaults[ttr_type][idx]);
+        if(fgets(in_line, sizeof(in_line), stdin) == NULL)
+        {
+            continue;
+        }
+        if((in_line[0] == '\n')||(in_line[0] == '\r'))
+        {
+            continue;
+        }
+        in_value = strtoul(in_line, NULL, 10);
+        if((in_value == 0)||(in_value > 255))
+        {
+            printf("Wrong input: %lu. Default is kept.\n\r", in_value);
+        }
+        else
+        {
+            set_arr[EPS_TIM_DATA+idx] = (uint8_t)in_value;
+        }
+    }
+    set_arr[EPS_TIM_TYPE] = ttr_type;
 }
 
-void eep_conditioning(uint8_t *set_arr)
+void eep_conditioning(uint8_t *set_arr, uint8_t *eep_arr)
 {
-    uint8_t crc_data, idx;
+    uint8_t crc_data, idx, tag, pos;
+
+    // Pack settings blocks into container (same as [SET_encode()] in firmware).
+    for(idx = 0; idx < EEPROM_STORE_SIZE; idx++)
+    {
+        eep_arr[idx] = 0;
+    }
+    eep_arr[EPS_MARKER] = EEPROM_START_MARKER;
+    eep_arr[SET_IDX_VERSION] = SET_VERSION;
+    pos = SET_IDX_DATA;
+    for(tag = (SET_TAG_END+1); tag < SET_TAG_MAX; tag++)
+    {
+        eep_arr[pos++] = tag;
+        eep_arr[pos++] = lut_set_blocks[tag][1];
+        for(idx = 0; idx < lut_set_blocks[tag][1]; idx++)
+        {
+            eep_arr[pos++] = set_arr[lut_set_blocks[tag][0]+idx];
+        }
+    }
+    eep_arr[EEPROM_SEQ_POSITION] = 0;
 
     // Calculate CRC for settings data.
     crc_data = CRC8_init();
     idx = 0;
     while(idx<EEPROM_CRC_POSITION)
     {
-        crc_data = CRC8_calc(crc_data, set_arr[idx]);
+        crc_data = CRC8_calc(crc_data, eep_arr[idx]);
         idx++;
     }
-    set_arr[EEPROM_CRC_POSITION] = crc_data;
+    eep_arr[EEPROM_CRC_POSITION] = crc_data;
 
     // Invert data to reduce EEPROM wear.
     idx = 0;
     while(idx<EEPROM_STORE_SIZE)
     {
-        set_arr[idx] = ~set_arr[idx];
+        eep_arr[idx] = ~eep_arr[idx];
         idx++;
     }
 }
 
-int main()
+void set_defaults(unit_t *unit)
 {
-    uint8_t u8a_settings[EEPROM_STORE_SIZE];
-    uint8_t in_select;
-
-    printf("%s\n\r", ucaf_info);
-    printf("%s\n\r", ucaf_author);
-    printf("%s, %s\n\r", ucaf_compile_date, ucaf_compile_time);
-    printf("%s\n\r", ucaf_url);
-
-    // Zero out EEPROM image.
-    for(uint16_t idx = 0; idx < EEPROM_STORE_SIZE; idx++)
+    // Zero out settings.
+    for(uint16_t idx = 0; idx < SETTINGS_SIZE; idx++)
     {
-        u8a_settings[idx] = 0;
+        unit->settings[idx] = 0;
     }
 
     // Put in starting marker and default settings.
-    u8a_settings[EPS_MARKER] = EEPROM_START_MARKER;
-    u8a_settings[EPS_TTR_FTRS] = TTR_FEA_DEFAULT;
-    u8a_settings[EPS_SRV_FTRS] = SRV_FEA_DEFAULT;
+    unit->settings[EPS_MARKER] = EEPROM_START_MARKER;
+    unit->settings[EPS_TTR_TYPE] = TTR_TYPE_CRP42602Y;
+    unit->settings[EPS_TTR_FTRS] = TTR_FEA_DEFAULT;
+    unit->settings[EPS_SRV_FTRS] = SRV_FEA_DEFAULT;
+    unit->settings[EPS_LOG_CFG] = UART_LOG_DEFAULT;
+    unit->settings[EPS_TIM_TYPE] = TIM_PROFILE_NONE;
+    unit->prf_count = 0;
+    unit->rom_size = EEPROM_ROM_SIZE;
+    unit->area_size = 0;
+    unit->slot = 0;
+    unit->out_fmt = (OUT_BIN|OUT_HEX);
+    snprintf(unit->name, NAME_SIZE, "%s", (const char *)ucaf_eep);
+}
+
+int input_interactive(uint8_t *u8a_settings)
+{
+    uint8_t in_select;
 
     printf("\n\rSelect tape transport mech:\n\r");
     printf("1 - %s\n\r", lut_ttr_names[TTR_TYPE_TANASHIN]);
@@ -293,30 +507,587 @@ int main()
     in_select = get_bin_selector();
     if(in_select == 0)
     {
-        u8a_settings[EPS_SRV_FTRS] &= ~(SRV_FEA_PBF2REW);
+        u8a_settings[EPS_SRV_FTRS] &= ~(SRV_FEA_FF2REW);
     }
     else
     {
         u8a_settings[EPS_SRV_FTRS] |= (SRV_FEA_FF2REW);
     }
 
-    // Printout settings.
-    print_settings(u8a_settings);
+    printf("\n\rCapstan spin-up on cassette insertion (faster first command):\n\r");
+    printf("0 - disable\n\r");
+    printf("1 - enable\n\r");
+    in_select = get_bin_selector();
+    if(in_select == 0)
+    {
+        u8a_settings[EPS_SRV_FTRS] &= ~(SRV_FEA_PRESPIN);
+    }
+    else
+    {
+        u8a_settings[EPS_SRV_FTRS] |= (SRV_FEA_PRESPIN);
+    }
 
+    printf("\n\rMinimum UART log level (debug builds only):\n\r");
+    printf("0 - %s\n\r", lut_log_levels[0]);
+    printf("1 - %s\n\r", lut_log_levels[1]);
+    printf("2 - %s\n\r", lut_log_levels[2]);
+    printf("3 - %s\n\r", lut_log_levels[3]);
+    in_select = (uint8_t)getch();
+    in_select -= '0';
+    if(in_select > 3)
+    {
+        printf("Wrong input: %u. Corrected to 1.\n\r", in_select);
+        in_select = 1;
+    }
+    else
+    {
+        printf("Selected: %u.\n\r", in_select);
+    }
+    u8a_settings[EPS_LOG_CFG] &= ~(LOG_CFG_LVL_MASK);
+    u8a_settings[EPS_LOG_CFG] |= (in_select << LOG_CFG_LVL_SHIFT);
+
+    printf("\n\rMechanism timing profile:\n\r");
+    printf("0 - firmware defaults\n\r");
+    printf("1 - custom (tuned for this mechanism)\n\r");
+    in_select = get_bin_selector();
+    if(in_select != 0)
+    {
+        input_profile(u8a_settings);
+    }
+    return 0;
+}
+
+// Parse unsigned number from string, return 0 on success.
+int parse_number(const char *in_str, unsigned long max_value, unsigned long *out_value)
+{
+    char *str_end;
+    if(in_str[0] == '\0')
+    {
+        return -1;
+    }
+    *out_value = strtoul(in_str, &str_end, 0);
+    if((*str_end != '\0')||(*out_value > max_value))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Apply one [key=value] pair to the unit, return 0 on success.
+int parse_key(unit_t *unit, const char *key, const char *value)
+{
+    unsigned long in_value;
+    uint8_t idx;
+
+    // Binary settings, key without value enables the feature.
+    for(idx = 0; idx < (sizeof(lut_flag_keys)/sizeof(lut_flag_keys[0])); idx++)
+    {
+        if(strcmp(key, lut_flag_keys[idx].key) == 0)
+        {
+            if(value == NULL)
+            {
+                in_value = 1;
+            }
+            else if(parse_number(value, 1, &in_value) != 0)
+            {
+                return -1;
+            }
+            if(in_value == 0)
+            {
+                unit->settings[lut_flag_keys[idx].offset] &= ~(lut_flag_keys[idx].mask);
+            }
+            else
+            {
+                unit->settings[lut_flag_keys[idx].offset] |= (lut_flag_keys[idx].mask);
+            }
+            return 0;
+        }
+    }
+    if(value == NULL)
+    {
+        return -1;
+    }
+    if(strcmp(key, "mech") == 0)
+    {
+        // Transport by name or by number from interactive menu.
+        for(idx = 0; idx < TTR_TYPE_COUNT; idx++)
+        {
+            if(strcmp(value, lut_ttr_keys[idx]) == 0)
+            {
+                unit->settings[EPS_TTR_TYPE] = idx;
+                return 0;
+            }
+        }
+        if((parse_number(value, TTR_TYPE_COUNT, &in_value) != 0)||(in_value == 0))
+        {
+            return -1;
+        }
+        unit->settings[EPS_TTR_TYPE] = (uint8_t)(in_value - 1);
+    }
+    else if(strcmp(key, "log_level") == 0)
+    {
+        if(parse_number(value, 3, &in_value) != 0)
+        {
+            return -1;
+        }
+        unit->settings[EPS_LOG_CFG] &= ~(LOG_CFG_LVL_MASK);
+        unit->settings[EPS_LOG_CFG] |= ((uint8_t)in_value << LOG_CFG_LVL_SHIFT);
+    }
+    else if(strcmp(key, "log_mute") == 0)
+    {
+        if(parse_number(value, LOG_CFG_MUTE_MASK, &in_value) != 0)
+        {
+            return -1;
+        }
+        unit->settings[EPS_LOG_CFG] &= ~(LOG_CFG_MUTE_MASK);
+        unit->settings[EPS_LOG_CFG] |= (uint8_t)in_value;
+    }
+    else if(strcmp(key, "profile") == 0)
+    {
+        // Comma-separated values in order of [PRF_xxx] enum, missing tail keeps defaults.
+        char in_list[CFG_LINE_SIZE];
+        char *token;
+        unit->prf_count = 0;
+        if(strcmp(value, "default") == 0)
+        {
+            return 0;
+        }
+        snprintf(in_list, sizeof(in_list), "%s", value);
+        token = strtok(in_list, ",");
+        while(token != NULL)
+        {
+            while(*token == ' ')
+            {
+                token++;
+            }
+            if((unit->prf_count >= TIM_PROFILE_SIZE)||(parse_number(token, 255, &in_value) != 0)||(in_value == 0))
+            {
+                unit->prf_count = 0;
+                return -1;
+            }
+            unit->prf_data[unit->prf_count++] = (uint8_t)in_value;
+            token = strtok(NULL, ",");
+        }
+    }
+    else if(strcmp(key, "eeprom") == 0)
+    {
+        if((parse_number(value, EEPROM_ROM_MAX, &in_value) != 0)||
+            ((in_value != 256)&&(in_value != 512)&&(in_value != 1024)&&(in_value != 2048)))
+        {
+            return -1;
+        }
+        unit->rom_size = (uint16_t)in_value;
+    }
+    else if(strcmp(key, "stats") == 0)
+    {
+        if(parse_number(value, 1, &in_value) != 0)
+        {
+            return -1;
+        }
+        unit->area_size = (in_value == 0) ? 0 : EEPROM_STAT_AREA;
+    }
+    else if(strcmp(key, "slot") == 0)
+    {
+        if(parse_number(value, (EEPROM_ROM_MAX/EEPROM_STORE_SIZE - 1), &in_value) != 0)
+        {
+            return -1;
+        }
+        unit->slot = (uint16_t)in_value;
+    }
+    else if(strcmp(key, "format") == 0)
+    {
+        if(strcmp(value, "bin") == 0)
+        {
+            unit->out_fmt = OUT_BIN;
+        }
+        else if(strcmp(value, "hex") == 0)
+        {
+            unit->out_fmt = OUT_HEX;
+        }
+        else if(strcmp(value, "both") == 0)
+        {
+            unit->out_fmt = (OUT_BIN|OUT_HEX);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    else if(strcmp(key, "name") == 0)
+    {
+        snprintf(unit->name, NAME_SIZE, "%s", value);
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Split [key=value] string and apply it to the unit.
+int parse_pair(unit_t *unit, char *in_str)
+{
+    char *value;
+    // Allow options in "--key=value" form.
+    while(*in_str == '-')
+    {
+        in_str++;
+    }
+    value = strchr(in_str, '=');
+    if(value != NULL)
+    {
+        *value = '\0';
+        value++;
+    }
+    return parse_key(unit, in_str, value);
+}
+
+// Cut comments and surrounding whitespace from config line.
+char *trim_line(char *in_line)
+{
+    char *line_end;
+    line_end = strpbrk(in_line, "#;\r\n");
+    if(line_end != NULL)
+    {
+        *line_end = '\0';
+    }
+    while((*in_line == ' ')||(*in_line == '\t'))
+    {
+        in_line++;
+    }
+    line_end = in_line + strlen(in_line);
+    while((line_end > in_line)&&((*(line_end-1) == ' ')||(*(line_end-1) == '\t')))
+    {
+        line_end--;
+    }
+    *line_end = '\0';
+    // Allow spaces around "=".
+    line_end = strchr(in_line, '=');
+    if(line_end != NULL)
+    {
+        char *value = line_end + 1;
+        while((line_end > in_line)&&((*(line_end-1) == ' ')||(*(line_end-1) == '\t')))
+        {
+            line_end--;
+        }
+        while((*value == ' ')||(*value == '\t'))
+        {
+            value++;
+        }
+        *line_end = '=';
+        memmove(line_end+1, value, strlen(value)+1);
+    }
+    return in_line;
+}
+
+// Bring settings in line with selected transport (same as interactive mode), return 0 if unit is valid.
+int finalize_unit(unit_t *unit)
+{
+    uint8_t ttr_type, idx;
+    ttr_type = unit->settings[EPS_TTR_TYPE];
+    if(ttr_type == TTR_TYPE_TANASHIN)
+    {
+        // Disable functions for non-reverse mech.
+        unit->settings[EPS_TTR_FTRS] &= ~(TTR_FEA_STOP_TACHO|TTR_FEA_REV_ENABLE);
+        unit->settings[EPS_SRV_FTRS] &= ~(SRV_FEA_TWO_PLAYS|SRV_FEA_PB_AUTOREV|SRV_FEA_PB_LOOP);
+    }
+    if((unit->settings[EPS_SRV_FTRS] & SRV_FEA_PB_AUTOREV) == 0)
+    {
+        // Loop is a variant of auto-reverse.
+        unit->settings[EPS_SRV_FTRS] &= ~(SRV_FEA_PB_LOOP);
+    }
+    if(unit->prf_count == 0)
+    {
+        unit->settings[EPS_TIM_TYPE] = TIM_PROFILE_NONE;
+    }
+    else
+    {
+        if(unit->prf_count > lut_prf_sizes[ttr_type])
+        {
+            fprintf(stderr, "%s: timing profile for %s has only %u values!\n\r",
+                    unit->name, lut_ttr_keys[ttr_type], lut_prf_sizes[ttr_type]);
+            return -1;
+        }
+        for(idx = 0; idx < TIM_PROFILE_SIZE; idx++)
+        {
+            unit->settings[EPS_TIM_DATA+idx] = 0;
+            if(idx < unit->prf_count)
+            {
+                unit->settings[EPS_TIM_DATA+idx] = unit->prf_data[idx];
+            }
+            else if(idx < lut_prf_sizes[ttr_type])
+            {
+                unit->settings[EPS_TIM_DATA+idx] = lut_prf_defaults[ttr_type][idx];
+            }
+        }
+        unit->settings[EPS_TIM_TYPE] = ttr_type;
+    }
+    if((unit->area_size == 0)||(unit->area_size > unit->rom_size))
+    {
+        unit->area_size = unit->rom_size;
+    }
+    if(unit->slot >= (unit->area_size/EEPROM_STORE_SIZE))
+    {
+        fprintf(stderr, "%s: slot %u is out of settings area (%u slots)!\n\r",
+                unit->name, unit->slot, (unit->area_size/EEPROM_STORE_SIZE));
+        return -1;
+    }
+    return 0;
+}
+
+void write_hex_record(FILE *hex_file, uint8_t rec_len, uint16_t addr, uint8_t rec_type, const uint8_t *rec_data)
+{
+    uint8_t checksum, idx;
+    checksum = rec_len + (uint8_t)(addr>>8) + (uint8_t)(addr&0xFF) + rec_type;
+    fprintf(hex_file, ":%02X%04X%02X", rec_len, addr, rec_type);
+    for(idx = 0; idx < rec_len; idx++)
+    {
+        fprintf(hex_file, "%02X", rec_data[idx]);
+        checksum += rec_data[idx];
+    }
+    fprintf(hex_file, "%02X\n", (uint8_t)(0-checksum));
+}
+
+// Put conditioned record into full EEPROM image and save it in selected formats.
+int save_image(unit_t *unit)
+{
+    uint8_t u8a_image[EEPROM_ROM_MAX];
+    char file_name[NAME_SIZE+8];
+    uint16_t idx;
+
+    // Fill EEPROM with erased cells, so no record from previous settings is newer than this one.
+    for(idx = 0; idx < unit->rom_size; idx++)
+    {
+        u8a_image[idx] = EEPROM_ERASED_BYTE;
+    }
     // Condition data to be written to EEPROM.
-    eep_conditioning(u8a_settings);
+    eep_conditioning(unit->settings, &u8a_image[unit->slot*EEPROM_STORE_SIZE]);
 
-    FILE *eep_dump = fopen((const char *)ucaf_eep, "wb");
-    if(eep_dump)
+    if((unit->out_fmt & OUT_BIN) != 0)
+    {
+        snprintf(file_name, sizeof(file_name), "%s.bin", unit->name);
+        FILE *eep_dump = fopen(file_name, "wb");
+        if(eep_dump == NULL)
+        {
+            fprintf(stderr, "Failed to write EEPROM image %s!\n\r", file_name);
+            return -2;
+        }
+        fwrite(u8a_image, 1, unit->rom_size, eep_dump);
+        fclose(eep_dump);
+        printf("Saved EEPROM image to a file %s\n\r", file_name);
+    }
+    if((unit->out_fmt & OUT_HEX) != 0)
     {
-        fwrite(u8a_settings, 1, EEPROM_STORE_SIZE, eep_dump);
+        snprintf(file_name, sizeof(file_name), "%s.hex", unit->name);
+        FILE *eep_dump = fopen(file_name, "w");
+        if(eep_dump == NULL)
+        {
+            fprintf(stderr, "Failed to write EEPROM image %s!\n\r", file_name);
+            return -2;
+        }
+        for(idx = 0; idx < unit->rom_size; idx += HEX_LINE_SIZE)
+        {
+            write_hex_record(eep_dump, HEX_LINE_SIZE, idx, 0x00, &u8a_image[idx]);
+        }
+        write_hex_record(eep_dump, 0, 0, 0x01, NULL);
         fclose(eep_dump);
-        printf("\n\rSaved EEPROM image to a file %s\n\r", ucaf_eep);
+        printf("Saved EEPROM image to a file %s\n\r", file_name);
+    }
+    return 0;
+}
+
+// Finalize unit, print short summary and save its image.
+int make_unit(unit_t *unit)
+{
+    int res;
+    res = finalize_unit(unit);
+    if(res != 0)
+    {
+        return res;
+    }
+    printf("%s: %s, TTR 0x%02X, SRV 0x%02X, LOG 0x%02X, timing %s, slot %u of %u\n\r",
+           unit->name, lut_ttr_keys[unit->settings[EPS_TTR_TYPE]],
+           unit->settings[EPS_TTR_FTRS], unit->settings[EPS_SRV_FTRS], unit->settings[EPS_LOG_CFG],
+           (unit->prf_count == 0) ? "default" : "custom",
+           unit->slot, (unit->area_size/EEPROM_STORE_SIZE));
+    return save_image(unit);
+}
+
+// Create images for all [name] sections of config file (or single image if there are none).
+int run_config(const char *cfg_name, unit_t *base, int argc, char *argv[], int arg_start)
+{
+    char in_line[CFG_LINE_SIZE];
+    char *line;
+    unit_t unit;
+    uint16_t line_num, unit_cnt;
+    uint8_t in_units;
+    int res, arg_idx;
+
+    FILE *cfg_file = fopen(cfg_name, "r");
+    if(cfg_file == NULL)
+    {
+        fprintf(stderr, "Unable to open config file %s!\n\r", cfg_name);
+        return -1;
+    }
+
+    // First pass: common settings before the first section.
+    line_num = 0;
+    while(fgets(in_line, sizeof(in_line), cfg_file) != NULL)
+    {
+        line_num++;
+        line = trim_line(in_line);
+        if(line[0] == '[')
+        {
+            break;
+        }
+        if((line[0] != '\0')&&(parse_pair(base, line) != 0))
+        {
+            fprintf(stderr, "%s:%u: wrong setting [%s]!\n\r", cfg_name, line_num, line);
+            fclose(cfg_file);
+            return -1;
+        }
+    }
+    // Command line overrides common settings.
+    for(arg_idx = arg_start; arg_idx < argc; arg_idx++)
+    {
+        if(parse_pair(base, argv[arg_idx]) != 0)
+        {
+            fprintf(stderr, "Wrong option [%s]!\n\r", argv[arg_idx]);
+            fclose(cfg_file);
+            return -1;
+        }
+    }
+
+    // Second pass: one image per section, each section starts from common settings.
+    rewind(cfg_file);
+    line_num = 0;
+    unit_cnt = 0;
+    in_units = 0;
+    res = 0;
+    while(fgets(in_line, sizeof(in_line), cfg_file) != NULL)
+    {
+        line_num++;
+        line = trim_line(in_line);
+        if(line[0] == '[')
+        {
+            char *name_end = strchr(line, ']');
+            if((name_end == NULL)||(name_end == (line+1)))
+            {
+                fprintf(stderr, "%s:%u: wrong section name [%s]!\n\r", cfg_name, line_num, line);
+                res = -1;
+                break;
+            }
+            if(in_units != 0)
+            {
+                res = make_unit(&unit);
+                if(res != 0)
+                {
+                    break;
+                }
+                unit_cnt++;
+            }
+            *name_end = '\0';
+            unit = *base;
+            snprintf(unit.name, NAME_SIZE, "%s", line+1);
+            in_units = 1;
+        }
+        else if((in_units != 0)&&(line[0] != '\0')&&(parse_pair(&unit, line) != 0))
+        {
+            fprintf(stderr, "%s:%u: wrong setting [%s]!\n\r", cfg_name, line_num, line);
+            res = -1;
+            break;
+        }
+    }
+    fclose(cfg_file);
+    if(res != 0)
+    {
+        return res;
+    }
+    if(in_units == 0)
+    {
+        // No sections: single image from common settings.
+        unit = *base;
+    }
+    res = make_unit(&unit);
+    if(res == 0)
+    {
+        unit_cnt++;
+        printf("Created %u EEPROM image(s).\n\r", unit_cnt);
+    }
+    return res;
+}
+
+void print_usage(const char *app_name)
+{
+    printf("\n\rUsage:\n\r");
+    printf("  %s                          interactive mode\n\r", app_name);
+    printf("  %s [key=value ...]          single image from options\n\r", app_name);
+    printf("  %s -c file [key=value ...]  image for each [name] section of config file\n\r", app_name);
+    printf("\n\rKeys (\"--key=value\" form is also accepted, flag without value is set to 1):\n\r");
+    printf("  mech=tanashin|crp42602y|kenwood   tape transport (or 1...3)\n\r");
+    printf("  reverse, stop_tacho               transport features (0/1)\n\r");
+    printf("  two_plays, one2rec, autorev,\n\r");
+    printf("  loop, pbf2rew, ff2rew, prespin    service features (0/1)\n\r");
+    printf("  log_level=0...3                   minimum UART log level (debug, info, warn, error)\n\r");
+    printf("  log_mute=0x00...0x1F              muted UART log subsystems\n\r");
+    printf("  profile=v1,v2,...|default         timing profile in order of [PRF_xxx] enum, missing values are defaults\n\r");
+    printf("  eeprom=256|512|1024|2048          EEPROM size of the MCU (default: 1024)\n\r");
+    printf("  stats=0/1                         firmware with [EN_STAT_EEPROM] (settings in first 512 bytes)\n\r");
+    printf("  slot=N                            segment to put the record into (default: 0)\n\r");
+    printf("  format=bin|hex|both               output format (default: both)\n\r");
+    printf("  name=file                         output file name without extension (default: %s)\n\r", ucaf_eep);
+    printf("\n\rConfig file: [key = value] lines, keys before the first [name] section are common for all units,\n\r");
+    printf("each section creates image [name.bin]/[name.hex], '#' and ';' start comments.\n\r");
+}
+
+int main(int argc, char *argv[])
+{
+    unit_t unit;
+    int arg_idx, res;
+
+    printf("%s\n\r", ucaf_info);
+    printf("%s\n\r", ucaf_author);
+    printf("%s, %s\n\r", ucaf_compile_date, ucaf_compile_time);
+    printf("%s\n\r", ucaf_url);
+
+    set_defaults(&unit);
+
+    if(argc < 2)
+    {
+        // Step by step input.
+        res = input_interactive(unit.settings);
+        if(res != 0)
+        {
+            return res;
+        }
+        // Printout settings.
+        print_settings(unit.settings);
+        printf("\n\r");
+        return save_image(&unit);
+    }
+
+    if((strcmp(argv[1], "-h") == 0)||(strcmp(argv[1], "--help") == 0))
+    {
+        print_usage(argv[0]);
         return 0;
     }
-    else
+    if(strcmp(argv[1], "-c") == 0)
+    {
+        if(argc < 3)
+        {
+            print_usage(argv[0]);
+            return -1;
+        }
+        return run_config(argv[2], &unit, argc, argv, 3);
+    }
+    for(arg_idx = 1; arg_idx < argc; arg_idx++)
     {
-        printf("\n\rFailed to write EEPROM image!\n\r");
-        return -2;
+        if(parse_pair(&unit, argv[arg_idx]) != 0)
+        {
+            fprintf(stderr, "Wrong option [%s]!\n\r", argv[arg_idx]);
+            print_usage(argv[0]);
+            return -1;
+        }
     }
+    return make_unit(&unit);
 }
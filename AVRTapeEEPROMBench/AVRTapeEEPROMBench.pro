@@ -0,0 +1,18 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CFLAGS_RELEASE += -O3
+
+# Settings size for the EEPROM driver under test (run qmake "TARGET_SIZE=29" to check other sizes, run_sizes.sh checks all segment sizes).
+isEmpty(TARGET_SIZE): TARGET_SIZE = 29
+DEFINES += __AVR_ATmega328P__ EEPROM_TARGET_SIZE=$$TARGET_SIZE
+INCLUDEPATH += ../AVRTapeHost ../AVRTapeControl
+
+SOURCES += \
+        main.c \
+        ../AVRTapeHost/host_io.c \
+        ../AVRTapeControl/drv_eeprom.c \
+        ../AVRTapeControl/settings.c \
+        ../AVRTapeControl/calc_crc.c
@@ -0,0 +1,384 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_io.h"
+#include "drv_eeprom.h"
+#include "settings.h"
+
+#define HISTORY_LEN     4           // Number of records saved before each test
+#define DEF_WEAR_SAVES  20000       // Default number of saves for wear test
+
+// Recovery results after power cut.
+enum
+{
+    RES_NEW,                        // New data is loaded
+    RES_OLD,                        // Previous data is loaded (save is lost, settings are not)
+    RES_ROLLBACK,                   // Older than previous data is loaded
+    RES_LOST,                       // No valid data or wrong data
+    RES_MAX
+};
+
+static const char *res_names[RES_MAX] = {"new", "old", "rollback", "lost"};
+
+// Fill settings record for generation [gen].
+static void make_data(uint8_t *data, uint16_t gen)
+{
+    uint16_t idx;
+    data[0]=EEPROM_START_MARKER;
+    for(idx=1;idx<EEPROM_TARGET_SIZE;idx++)
+    {
+        data[idx]=(uint8_t)(gen*31+idx*7);
+    }
+}
+
+// Run asynchronous job to the end (EEPROM ready interrupt is always pending on host).
+static void run_job(void)
+{
+    uint32_t steps=0;
+    while((EECR&(1<<EERIE))!=0)
+    {
+        EEPROM_job_step();
+        steps++;
+        if(steps>(uint32_t)EEPROM_ROM_SIZE*16)
+        {
+            printf("ERROR: EEPROM job hangs!\n");
+            exit(2);
+        }
+    }
+}
+
+// Format EEPROM and save [HISTORY_LEN] records (generations 0...HISTORY_LEN-1),
+// first record is moved to slot [start_slot] before saving others.
+static void prepare(uint16_t start_slot)
+{
+    uint8_t data[EEPROM_TARGET_SIZE];
+    uint16_t gen;
+    host_eep_reset(0xFF);
+    // Reset driver base address (nothing is found in empty EEPROM).
+    EEPROM_search_data(data, 0, (EEPROM_TARGET_SIZE-1));
+    make_data(data, 0);
+    EEPROM_write_segment(data, 0, EEPROM_TARGET_SIZE);
+    EEPROM_search_data(data, 0, (EEPROM_TARGET_SIZE-1));
+    for(gen=0;gen<start_slot;gen++)
+    {
+        EEPROM_goto_next_segment();
+    }
+    for(gen=1;gen<HISTORY_LEN;gen++)
+    {
+        make_data(data, gen);
+        EEPROM_queue_append(data, 0, EEPROM_TARGET_SIZE);
+        run_job();
+        EEPROM_get_job_result();
+    }
+}
+
+// Restore power, "reboot" and check what data is found.
+static uint8_t check_recovery(uint16_t new_gen, uint16_t old_gen)
+{
+    uint8_t data[EEPROM_TARGET_SIZE], ref[EEPROM_TARGET_SIZE];
+    uint16_t gen;
+    host_eep_set_cut(HOST_EEP_NO_CUT);
+    if(EEPROM_search_data(data, 0, (EEPROM_TARGET_SIZE-1))!=EEPROM_OK)
+    {
+        return RES_LOST;
+    }
+    make_data(ref, new_gen);
+    if(memcmp(data, ref, EEPROM_TARGET_SIZE)==0) return RES_NEW;
+    make_data(ref, old_gen);
+    if(memcmp(data, ref, EEPROM_TARGET_SIZE)==0) return RES_OLD;
+    for(gen=0;gen<old_gen;gen++)
+    {
+        make_data(ref, gen);
+        if(memcmp(data, ref, EEPROM_TARGET_SIZE)==0) return RES_ROLLBACK;
+    }
+    return RES_LOST;
+}
+
+// Procedures under test.
+enum
+{
+    PROC_WRITE_SEGMENT,             // [EEPROM_write_segment()] (in-place rewrite)
+    PROC_GOTO_NEXT,                 // [EEPROM_goto_next_segment()]
+    PROC_WRITE_AND_MOVE,            // [EEPROM_write_segment()] + [EEPROM_goto_next_segment()] (save before record journal)
+    PROC_QUEUE_APPEND,              // [EEPROM_queue_append()]
+    PROC_QUEUE_NEXT,                // [EEPROM_queue_next_segment()]
+    PROC_MAX
+};
+
+static const char *proc_names[PROC_MAX] =
+{
+    "EEPROM_write_segment()",
+    "EEPROM_goto_next_segment()",
+    "write_segment()+goto_next()",
+    "EEPROM_queue_append()",
+    "EEPROM_queue_next_segment()"
+};
+
+// Procedures that are declared fail-safe (any loss is an error).
+static const uint8_t proc_fail_safe[PROC_MAX] = {0, 1, 0, 1, 1};
+
+// Run procedure [proc] that saves generation [gen] (or moves current data).
+static void run_proc(uint8_t proc, uint16_t gen)
+{
+    uint8_t data[EEPROM_TARGET_SIZE];
+    make_data(data, gen);
+    if(proc==PROC_WRITE_SEGMENT)
+    {
+        EEPROM_write_segment(data, 0, EEPROM_TARGET_SIZE);
+    }
+    else if(proc==PROC_GOTO_NEXT)
+    {
+        EEPROM_goto_next_segment();
+    }
+    else if(proc==PROC_WRITE_AND_MOVE)
+    {
+        EEPROM_write_segment(data, 0, EEPROM_TARGET_SIZE);
+        EEPROM_goto_next_segment();
+    }
+    else if(proc==PROC_QUEUE_APPEND)
+    {
+        EEPROM_queue_append(data, 0, EEPROM_TARGET_SIZE);
+        run_job();
+    }
+    else if(proc==PROC_QUEUE_NEXT)
+    {
+        EEPROM_queue_next_segment();
+        run_job();
+    }
+    EEPROM_get_job_result();
+}
+
+// Cut power at every erase/write of the procedure and check recovery.
+// [start_slot] - slot of the first record from history;
+// Returns number of unacceptable results.
+static uint32_t test_power_cut(uint8_t proc, uint16_t start_slot)
+{
+    uint32_t total_ops, cut, results[RES_MAX];
+    uint16_t old_gen, new_gen;
+    uint8_t res;
+    old_gen=HISTORY_LEN-1;
+    // Moves keep the same data.
+    new_gen=((proc==PROC_GOTO_NEXT)||(proc==PROC_QUEUE_NEXT))?old_gen:HISTORY_LEN;
+    // Count operations without power cut.
+    prepare(start_slot);
+    host_eep_set_cut(HOST_EEP_NO_CUT);
+    run_proc(proc, new_gen);
+    total_ops=host_eep_get_ops();
+    if(check_recovery(new_gen, old_gen)!=RES_NEW)
+    {
+        printf("%-28s ERROR: data is not saved without power cut!\n", proc_names[proc]);
+        return 1;
+    }
+    memset(results, 0, sizeof(results));
+    for(cut=0;cut<total_ops;cut++)
+    {
+        prepare(start_slot);
+        host_eep_set_cut((long)cut);
+        run_proc(proc, new_gen);
+        res=check_recovery(new_gen, old_gen);
+        results[res]++;
+    }
+    printf("%-28s %4u ops, cuts:", proc_names[proc], total_ops);
+    for(res=0;res<RES_MAX;res++)
+    {
+        printf(" %s %u", res_names[res], results[res]);
+    }
+    if(proc_fail_safe[proc]==0)
+    {
+        printf(" (not fail-safe by design)\n");
+        return 0;
+    }
+    if((results[RES_ROLLBACK]+results[RES_LOST])!=0)
+    {
+        printf(" FAIL\n");
+        return (results[RES_ROLLBACK]+results[RES_LOST]);
+    }
+    printf(" OK\n");
+    return 0;
+}
+
+// Perform [saves] saves and project EEPROM lifetime from the most worn cell.
+static void test_wear(uint8_t proc, uint32_t saves)
+{
+    uint32_t idx, max_wear;
+    prepare(0);
+    memset(host_eep_erases, 0, sizeof(host_eep_erases));
+    memset(host_eep_writes, 0, sizeof(host_eep_writes));
+    for(idx=0;idx<saves;idx++)
+    {
+        run_proc(proc, (uint16_t)(HISTORY_LEN+idx));
+    }
+    max_wear=host_eep_max_wear(0, EEPROM_AREA_SIZE);
+    printf("%-28s %u saves, max %u cycles per cell, lifetime ~%.0f saves\n", proc_names[proc], saves, max_wear,
+           (max_wear==0)?0.0:((double)HOST_EEP_ENDURANCE*saves/max_wear));
+}
+
+#if EEPROM_TARGET_SIZE>=SET_RECORD_SIZE
+#define SET_DEF_FILL    0xEE        // Fill of RAM image for default settings
+
+// EEPROM images written by AVRTapeEEPROM v0.14 (16-byte segment: fixed layout, CRC-8 in the last byte, inverted).
+static const uint8_t old_images[][SET_OLD_SEGMENT] =
+{
+    // Tanashin, [RECORD] (one button).
+    {0x5A, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4C},
+    // CRP42602Y, reverse, one button record, auto-reverse, loop, auto-rewind after playback.
+    {0x5A, 0xFE, 0xFD, 0xF0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4E}
+};
+
+#define OLD_IMAGES      (sizeof(old_images)/sizeof(old_images[0]))
+#define OLD_SLOTS       (EEPROM_ROM_SIZE/SET_OLD_SEGMENT)
+#define OLD_NOT_FOUND   0xFF        // No settings are found on start
+
+static uint32_t old_conv_ops=0;     // Erase/write operations done to save converted record on the last start
+
+// Format EEPROM and put old image [img] at 16-byte slot [slot].
+static void prepare_old(uint16_t img, uint16_t slot)
+{
+    host_eep_reset(0xFF);
+    memcpy(&host_eep_mem[slot*SET_OLD_SEGMENT], old_images[img], SET_OLD_SEGMENT);
+}
+
+// Load settings the same way as [read_settings()] in firmware does, old record is converted and saved.
+// [cut] - power cut for saving of converted record;
+// Returns result of [SET_decode()] for the loaded record or [OLD_NOT_FOUND] if no settings are found.
+static uint8_t boot_settings(uint8_t *settings, long cut)
+{
+    uint8_t record[SET_RECORD_SIZE];
+    memset(settings, SET_DEF_FILL, SETTINGS_SIZE);
+    host_eep_set_cut(HOST_EEP_NO_CUT);
+    if(EEPROM_search_data(record, 0, (SET_RECORD_SIZE-1))!=EEPROM_OK)
+    {
+        if(EEPROM_search_legacy(record, SET_OLD_SEGMENT, SET_OLD_LEN)!=EEPROM_OK)
+        {
+            return OLD_NOT_FOUND;
+        }
+        SET_decode(record, settings);
+        SET_encode(settings, record);
+        host_eep_set_cut(cut);
+        EEPROM_write_segment(&record[SET_IDX_MARKER+1], (SET_IDX_MARKER+1), (SET_RECORD_SIZE-1));
+        EEPROM_write_segment(&record[SET_IDX_MARKER], SET_IDX_MARKER, 1);
+        old_conv_ops=host_eep_get_ops();
+        host_eep_set_cut(HOST_EEP_NO_CUT);
+        if(EEPROM_search_data(record, 0, (SET_RECORD_SIZE-1))!=EEPROM_OK)
+        {
+            return OLD_NOT_FOUND;
+        }
+    }
+    return SET_decode(record, settings);
+}
+
+// Check that settings are converted from old image [img]: transport type and features are taken, the rest keeps defaults.
+// Returns 0 if settings are correct.
+static uint8_t check_old_settings(const uint8_t *settings, uint16_t img)
+{
+    uint8_t idx;
+    for(idx=EPS_TTR_TYPE;idx<SETTINGS_SIZE;idx++)
+    {
+        if(idx<SET_OLD_LEN)
+        {
+            // Image is inverted.
+            if((settings[idx]^old_images[img][idx])!=0xFF) return 1;
+        }
+        else if(settings[idx]!=SET_DEF_FILL)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Put images from older firmware at every 16-byte slot and check conversion,
+// then cut power at every erase/write of converted record.
+// Returns number of failures.
+static uint32_t test_old_images(void)
+{
+    uint8_t settings[SETTINGS_SIZE];
+    uint32_t errors, total_ops, cut, cuts;
+    uint16_t img, slot;
+    uint8_t res;
+    errors=0;
+    for(img=0;img<OLD_IMAGES;img++)
+    {
+        cuts=0;
+        for(slot=0;slot<OLD_SLOTS;slot++)
+        {
+            prepare_old(img, slot);
+            // First start converts the record, the next one must load converted record.
+            res=boot_settings(settings, HOST_EEP_NO_CUT);
+            if((res==OLD_NOT_FOUND)||(check_old_settings(settings, img)!=0))
+            {
+                printf("Old image %u at 0x%03x: not converted! FAIL\n", img, (unsigned)(slot*SET_OLD_SEGMENT));
+                errors++;
+                continue;
+            }
+            total_ops=old_conv_ops;
+            res=boot_settings(settings, HOST_EEP_NO_CUT);
+            if((res==OLD_NOT_FOUND)||(check_old_settings(settings, img)!=0))
+            {
+                printf("Old image %u at 0x%03x: converted record is not loaded! FAIL\n", img, (unsigned)(slot*SET_OLD_SEGMENT));
+                errors++;
+                continue;
+            }
+            for(cut=0;cut<total_ops;cut++)
+            {
+                prepare_old(img, slot);
+                boot_settings(settings, (long)cut);
+                cuts++;
+                res=boot_settings(settings, HOST_EEP_NO_CUT);
+                if((res==OLD_NOT_FOUND)||(check_old_settings(settings, img)!=0))
+                {
+                    printf("Old image %u at 0x%03x: settings are lost after power cut %u! FAIL\n", img, (unsigned)(slot*SET_OLD_SEGMENT), cut);
+                    errors++;
+                }
+            }
+        }
+        printf("Old image %u at %u slots, %u power cuts during conversion:%s\n", img, (unsigned)OLD_SLOTS, cuts, (errors==0)?" OK":" FAIL");
+    }
+    return errors;
+}
+#endif /* EEPROM_TARGET_SIZE>=SET_RECORD_SIZE */
+
+int main(int argc, char *argv[])
+{
+    uint32_t errors, saves;
+    uint8_t proc;
+    saves=DEF_WEAR_SAVES;
+    if(argc>1)
+    {
+        saves=(uint32_t)strtoul(argv[1], NULL, 10);
+        if(saves==0)
+        {
+            printf("Usage: %s [number of saves for wear test]\n", argv[0]);
+            return 1;
+        }
+    }
+    printf("EEPROM driver bench: EEPROM %u bytes, segment area %u bytes, EEPROM_TARGET_SIZE %u, segment %u bytes, %u slots\n\n",
+           (unsigned)EEPROM_ROM_SIZE, (unsigned)EEPROM_AREA_SIZE, (unsigned)EEPROM_TARGET_SIZE, (unsigned)EEPROM_STORE_SIZE, (unsigned)EEPROM_SEGMENT_COUNT);
+    errors=0;
+    printf("Power cut at every erase/write (%u records saved from the first slot before each test):\n", HISTORY_LEN);
+    for(proc=0;proc<PROC_MAX;proc++)
+    {
+        errors+=test_power_cut(proc, 0);
+    }
+    printf("\nSame with the newest record in the last slot (wrap-around):\n");
+    for(proc=0;proc<PROC_MAX;proc++)
+    {
+        errors+=test_power_cut(proc, (EEPROM_SEGMENT_COUNT-HISTORY_LEN));
+    }
+#if EEPROM_TARGET_SIZE>=SET_RECORD_SIZE
+    printf("\nSettings from older firmware (converted at every 16-byte slot):\n");
+    errors+=test_old_images();
+#endif /* EEPROM_TARGET_SIZE>=SET_RECORD_SIZE */
+    printf("\nWear (%lu cycles per cell):\n", HOST_EEP_ENDURANCE);
+    test_wear(PROC_WRITE_SEGMENT, saves);
+    test_wear(PROC_WRITE_AND_MOVE, saves);
+    test_wear(PROC_QUEUE_APPEND, saves);
+    if(errors!=0)
+    {
+        printf("\n%u unrecoverable power cuts!\n", errors);
+        return 2;
+    }
+    printf("\nAll fail-safe procedures recovered.\n");
+    return 0;
+}
@@ -0,0 +1,15 @@
+#!/bin/sh
+# Build and run the EEPROM bench for every segment size class.
+# EEPROM_TARGET_SIZE is a compile-time setting of the driver, so each size gets its own qmake build directory.
+# Usage: run_sizes.sh [number of saves for wear test]
+set -e
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+for SIZE in 13 29 61 125
+do
+	mkdir -p "$BENCH_DIR/build-size$SIZE"
+	cd "$BENCH_DIR/build-size$SIZE"
+	qmake "TARGET_SIZE=$SIZE" ../AVRTapeEEPROMBench.pro
+	make -s
+	./AVRTapeEEPROMBench $1
+	echo
+done
@@ -0,0 +1,991 @@
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Settings offsets in RAM image (NOTE: keep in sync with enum in [settings.h]).
+enum
+{
+    EPS_MARKER,						// Start marker position
+    EPS_TTR_TYPE,					// Transport type (if several types are enabled on compile time)
+    EPS_TTR_FTRS,					// Transport features (tacho in stop, reverse enable, etc.)
+    EPS_SRV_FTRS,					// Service features (auto-reverse, auto-rewind, etc.)
+    EPS_LOG_CFG,					// UART log configuration (muted subsystems and minimum level)
+    EPS_TIM_TYPE,					// Transport type the timing profile is made for
+    EPS_TIM_DATA,					// Start of timing profile
+};
+
+// EEPROM layout (NOTE: keep in sync with defines in [config.h], [drv_eeprom.h] and [usage_stats.h]).
+#define EEPROM_START_MARKER		0xA5
+#define TIM_PROFILE_SIZE	13		// Number of bytes reserved for mechanism timing profile
+#define SETTINGS_SIZE		(6+TIM_PROFILE_SIZE)	// Number of bytes for RAM image of settings
+#define EEPROM_STORE_SIZE	32		// Settings segment length (default)
+#define EEPROM_ROM_MAX		2048	// Largest EEPROM of supported MCUs
+#define EEPROM_STAT_AREA	512		// Space for settings records with usage stats journal enabled ([EEPROM_AREA_SIZE] in [config.h])
+#define EEPROM_ERASED_DATA	0x00	// EEPROM cell state after erasing (inverted)
+#define STAT_REC_SIZE		32		// Size of one usage stats journal record
+#define STAT_REC_MARKER		0x5A	// Marker byte of journal record
+#define STAT_IDX_SEQ		1		// Sequence number position in journal record
+#define STAT_IDX_CNT		2		// First counter position in journal record
+
+// Usage counters (NOTE: keep in sync with enum in [usage_stats.h]).
+enum
+{
+    STAT_CNT_PLAY,					// Time in playback (seconds)
+    STAT_CNT_RECORD,				// Time in record (seconds)
+    STAT_CNT_FWIND,					// Time in fast wind (seconds)
+    STAT_CNT_CAPSTAN,				// Capstan on-time (seconds)
+    STAT_CNT_SOLENOID,				// Solenoid actuations
+    STAT_CNT_RETRIES,				// Mode transition retries
+    STAT_CNT_HALTS,					// HALT events
+    STAT_CNT_MAX
+};
+
+static const char *lut_stat_names[STAT_CNT_MAX] =
+{
+    "Playback time", "Record time", "Fast wind time", "Capstan on-time",
+    "Solenoid actuations", "Mode retries", "HALT events"
+};
+
+// Settings container (NOTE: keep in sync with [settings.h]).
+enum
+{
+    SET_TAG_END,					// End of container
+    SET_TAG_BASE,					// Transport type, features and log configuration
+    SET_TAG_TIMING,					// Timing profile
+    SET_TAG_MAX
+};
+
+#define SET_IDX_VERSION		1		// Container version
+#define SET_IDX_DATA		2		// Start of the first block
+#define SET_VER_TLV			0x80	// Flag of tagged container in version byte (records without it have fixed layout)
+
+// Place of each block in RAM image (NOTE: keep in sync with [settings.c]).
+static const uint8_t lut_set_blocks[SET_TAG_MAX][2] =
+{
+    {0, 0},
+    {EPS_TTR_TYPE, 4},
+    {EPS_TIM_TYPE, (1+TIM_PROFILE_SIZE)}
+};
+
+// Supported tape transports (NOTE: keep in sync with enum in [avrtape.h]).
+enum
+{
+    TTR_TYPE_TANASHIN,				// Tanashin TN-21ZLG clone mechanism from AliExpress
+    TTR_TYPE_CRP42602Y,				// CRP42602Y mechanism from AliExpress
+    TTR_TYPE_KENWOOD,				// Kenwood mechanism
+    TTR_TYPE_COUNT
+};
+
+static const uint8_t lut_ttr_names[TTR_TYPE_COUNT][64] =
+{
+    "Tanashin TN-21ZLG/CSG/clone mechanism (M60207052)",
+    "CRP42602Y mechanism (M02753900D)",
+    "Kenwood mechanism (not supported)",
+};
+
+// Mechanism timing profiles (NOTE: keep in sync with [PRF_xxx] enums and defaults in [mech_tanashin.h], [mech_crp42602y.h] and [mech_knwd.h]).
+#define TIM_PROFILE_NONE	0xFF	// No timing profile, firmware defaults are used
+
+static const uint8_t lut_prf_sizes[TTR_TYPE_COUNT] = {12, 13, 9};
+
+static const char *lut_prf_names[TTR_TYPE_COUNT][TIM_PROFILE_SIZE] =
+{
+    {"DLY_SW_ACT", "DLY_WAIT_REW_ACT", "DLY_FWIND_ACT", "DLY_FWIND_SKIP", "DLY_SKIP_END", "DLY_PB_WAIT",
+     "DLY_FWIND_WAIT", "DLY_STOP", "DLY_PB2STOP", "DLY_ACTIVE", "TACHO_PLAY", "TACHO_FWIND"},
+    {"DLY_STOP", "DLY_WAIT_HEAD", "DLY_HEAD_DIR", "DLY_WAIT_PINCH", "DLY_PINCH_EN", "DLY_WAIT_TAKEUP", "DLY_TAKEUP_DIR",
+     "DLY_WAIT_MODE", "DLY_ACTIVE", "DLY_WAIT_STOP", "TACHO_STOP", "TACHO_PLAY", "TACHO_FWIND"},
+    {"DLY_SW_ACT", "DLY_STOP", "DLY_PB_WAIT", "DLY_FWIND_WAIT", "DLY_ACTIVE", "DLY_WAIT_STOP",
+     "TACHO_STOP", "TACHO_PLAY", "TACHO_FWIND"},
+};
+
+// Names of transport and service feature bits (NOTE: keep in sync with enums in [common_log.h]).
+static const char *lut_ttr_fea_names[8] = {"stop_tacho", "reverse", "", "", "", "", "", ""};
+static const char *lut_srv_fea_names[8] = {"two_plays", "one2rec", "autorev", "loop", "pbf2rew", "ff2rew", "prespin", ""};
+
+// UART log configuration (NOTE: keep in sync with defines in [drv_uart.h] and [config.h]).
+#define LOG_CFG_MUTE_MASK	0x1F					// Bit per subsystem: 1 = muted
+#define LOG_CFG_LVL_SHIFT	5
+#define LOG_CFG_LVL_MASK	(0x03<<LOG_CFG_LVL_SHIFT)	// Minimum level to output
+
+static const uint8_t lut_log_levels[4][8] =
+{
+    "DEBUG",
+    "INFO",
+    "WARN",
+    "ERROR",
+};
+
+// NOTE: keep in sync with array in [calc_crc.c].
+static const uint8_t lut_crc8[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+    0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+    0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11,
+    0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52,
+    0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+    0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9,
+    0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C,
+    0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED,
+    0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE,
+    0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28,
+    0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0,
+    0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+    0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56,
+    0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15,
+    0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
+};
+
+// States of EEPROM segment.
+enum
+{
+    SEG_EMPTY,                      // All cells are erased
+    SEG_VALID,                      // Marker and CRC are fine
+    SEG_BIT_ERR,                    // CRC is fine after flipping one bit (worn cell)
+    SEG_BAD_CRC,                    // Marker is fine, CRC is not (torn write or several worn cells)
+    SEG_JUNK,                       // Not erased, no marker
+    SEG_STATE_MAX
+};
+
+static const char lut_seg_chars[SEG_STATE_MAX] = {'.', 'v', 'b', '!', '?'};
+static const char *lut_seg_names[SEG_STATE_MAX] = {"empty", "valid", "1-bit error (worn cell?)", "CRC mismatch (torn write or worn segment)", "junk (no marker)"};
+
+// Diagnosis of the dump.
+enum
+{
+    DIAG_OK,                        // Active settings are found, no damaged segments
+    DIAG_WARN,                      // Active settings are found, some segments are damaged
+    DIAG_FAIL,                      // No valid settings, firmware will use defaults
+};
+
+static const char *lut_diag_names[3] = {"OK", "WARN", "FAIL"};
+
+#define SEG_MAX         (EEPROM_ROM_MAX/16)     // Maximum number of segments in the dump
+#define SEG_NONE        0xFFFF                  // No segment
+#define FILE_LIST_MAX   4096                    // Maximum number of files processed from one directory
+#define NAME_SIZE       512                     // Maximum length of file path
+
+typedef struct
+{
+    uint8_t state;                  // [SEG_xxx]
+    uint8_t seq;                    // Sequence number
+    uint8_t err_byte;               // Position of flipped bit for [SEG_BIT_ERR]
+    uint8_t err_bit;
+} seg_info_t;
+
+typedef struct
+{
+    uint8_t data[EEPROM_ROM_MAX];   // EEPROM contents (not inverted)
+    uint16_t rom_size;              // Size of the dump
+    uint16_t area_size;             // Settings segment area
+    uint16_t seg_size;              // Settings segment size
+    uint16_t seg_count;             // Number of settings segments
+    uint16_t stat_count;            // Number of usage stats journal slots
+    uint16_t active;                // Segment loaded by firmware
+    uint16_t stat_active;           // Journal slot loaded by firmware
+    seg_info_t segs[SEG_MAX];       // Settings segments
+    seg_info_t stats[SEG_MAX];      // Usage stats journal slots
+} dump_t;
+
+// Analyzer options.
+typedef struct
+{
+    uint16_t area_size;             // Settings area from command line, 0 = auto
+    uint16_t seg_size;              // Settings segment size
+    uint8_t verbose;                // Print full report for each file
+} opt_t;
+
+uint8_t CRC8_init(void)
+{
+    return 0xFF;
+}
+
+uint8_t CRC8_calc(uint8_t CRC_data, uint8_t in_data)
+{
+    uint8_t offset;
+    offset=CRC_data^in_data;
+    return lut_crc8[offset];
+}
+
+uint8_t calc_crc_block(const uint8_t *data, uint16_t len)
+{
+    uint8_t crc_data;
+    uint16_t idx;
+    crc_data = CRC8_init();
+    for(idx = 0; idx < len; idx++)
+    {
+        crc_data = CRC8_calc(crc_data, data[idx]);
+    }
+    return crc_data;
+}
+
+// Read one hex digit pair from Intel HEX line.
+int hex_byte(const char *in_str, uint8_t *out_byte)
+{
+    unsigned int value;
+    if(sscanf(in_str, "%2x", &value) != 1)
+    {
+        return -1;
+    }
+    *out_byte = (uint8_t)value;
+    return 0;
+}
+
+// Load Intel HEX file, return dump size or -1 on error.
+int load_hex(FILE *in_file, uint8_t *out_data)
+{
+    char in_line[600];
+    uint8_t rec_len, rec_type, addr_h, addr_l, value, checksum;
+    uint16_t addr, idx, max_addr;
+    max_addr = 0;
+    while(fgets(in_line, sizeof(in_line), in_file) != NULL)
+    {
+        if(in_line[0] != ':')
+        {
+            continue;
+        }
+        if((hex_byte(&in_line[1], &rec_len) != 0)||(hex_byte(&in_line[3], &addr_h) != 0)||
+           (hex_byte(&in_line[5], &addr_l) != 0)||(hex_byte(&in_line[7], &rec_type) != 0))
+        {
+            return -1;
+        }
+        if(strlen(in_line) < (size_t)(11+rec_len*2))
+        {
+            return -1;
+        }
+        checksum = rec_len + addr_h + addr_l + rec_type;
+        addr = ((uint16_t)addr_h<<8)|addr_l;
+        for(idx = 0; idx <= rec_len; idx++)
+        {
+            if(hex_byte(&in_line[9+idx*2], &value) != 0)
+            {
+                return -1;
+            }
+            checksum += value;
+            if((idx < rec_len)&&(rec_type == 0x00))
+            {
+                if((addr+idx) >= EEPROM_ROM_MAX)
+                {
+                    return -1;
+                }
+                out_data[addr+idx] = value;
+                if((addr+idx+1) > max_addr)
+                {
+                    max_addr = addr+idx+1;
+                }
+            }
+        }
+        if(checksum != 0)
+        {
+            return -1;
+        }
+        if(rec_type == 0x01)
+        {
+            break;
+        }
+    }
+    return max_addr;
+}
+
+// Load binary or Intel HEX dump and bring it to EEPROM size, return 0 on success.
+int load_dump(const char *file_name, dump_t *dump)
+{
+    int in_char, dump_size;
+    uint16_t idx;
+    FILE *in_file = fopen(file_name, "rb");
+    if(in_file == NULL)
+    {
+        return -1;
+    }
+    for(idx = 0; idx < EEPROM_ROM_MAX; idx++)
+    {
+        dump->data[idx] = 0xFF;
+    }
+    in_char = fgetc(in_file);
+    rewind(in_file);
+    if(in_char == ':')
+    {
+        dump_size = load_hex(in_file, dump->data);
+    }
+    else
+    {
+        dump_size = (int)fread(dump->data, 1, EEPROM_ROM_MAX, in_file);
+    }
+    fclose(in_file);
+    if(dump_size <= 0)
+    {
+        return -1;
+    }
+    // Round up to EEPROM size of AVR MCUs.
+    dump->rom_size = 256;
+    while(dump->rom_size < dump_size)
+    {
+        dump->rom_size *= 2;
+    }
+    // Data is stored inverted to reduce EEPROM wear.
+    for(idx = 0; idx < dump->rom_size; idx++)
+    {
+        dump->data[idx] = ~dump->data[idx];
+    }
+    return 0;
+}
+
+// Classify segment by marker, CRC and erased state.
+void check_segment(const uint8_t *seg_data, uint16_t seg_size, uint8_t marker, uint16_t seq_pos, seg_info_t *info)
+{
+    uint8_t seg_copy[EEPROM_ROM_MAX];
+    uint16_t idx;
+    uint8_t bit;
+
+    info->seq = seg_data[seq_pos];
+    info->state = SEG_EMPTY;
+    for(idx = 0; idx < seg_size; idx++)
+    {
+        if(seg_data[idx] != EEPROM_ERASED_DATA)
+        {
+            info->state = SEG_JUNK;
+            break;
+        }
+    }
+    if(info->state == SEG_EMPTY)
+    {
+        return;
+    }
+    if((seg_data[0] == marker)&&(calc_crc_block(seg_data, seg_size-1) == seg_data[seg_size-1]))
+    {
+        info->state = SEG_VALID;
+        return;
+    }
+    // Try to find single flipped bit (marker included).
+    memcpy(seg_copy, seg_data, seg_size);
+    for(idx = 0; idx < seg_size; idx++)
+    {
+        for(bit = 0; bit < 8; bit++)
+        {
+            seg_copy[idx] ^= (1<<bit);
+            if((seg_copy[0] == marker)&&(calc_crc_block(seg_copy, seg_size-1) == seg_copy[seg_size-1]))
+            {
+                info->state = SEG_BIT_ERR;
+                info->err_byte = (uint8_t)idx;
+                info->err_bit = bit;
+                info->seq = seg_copy[seq_pos];
+                return;
+            }
+            seg_copy[idx] ^= (1<<bit);
+        }
+    }
+    if(seg_data[0] == marker)
+    {
+        info->state = SEG_BAD_CRC;
+    }
+}
+
+// Find segment that firmware loads (same search as [EEPROM_search_data()] in [drv_eeprom.c]).
+uint16_t find_active(dump_t *dump)
+{
+    uint16_t seg, best, limit, attempt;
+    uint8_t best_seq, limit_seq, seq, limited;
+    limit_seq = 0;
+    limit = 0;
+    limited = 0;
+    for(attempt = 0; attempt < dump->seg_count; attempt++)
+    {
+        // Find the newest marked segment (older than the last rejected one).
+        best = SEG_NONE;
+        best_seq = 0;
+        for(seg = 0; seg < dump->seg_count; seg++)
+        {
+            if(dump->data[seg*dump->seg_size] != EEPROM_START_MARKER)
+            {
+                continue;
+            }
+            seq = dump->data[seg*dump->seg_size+dump->seg_size-2];
+            if((limited == 0)||((int8_t)(limit_seq-seq) > 0)||((seq == limit_seq)&&(seg < limit)))
+            {
+                if((best == SEG_NONE)||((int8_t)(seq-best_seq) > 0)||((seq == best_seq)&&(seg > best)))
+                {
+                    best = seg;
+                    best_seq = seq;
+                }
+            }
+        }
+        if(best == SEG_NONE)
+        {
+            break;
+        }
+        if(dump->segs[best].state == SEG_VALID)
+        {
+            return best;
+        }
+        // CRC mismatch, try previous record.
+        limit_seq = best_seq;
+        limit = best;
+        limited = 1;
+    }
+    return SEG_NONE;
+}
+
+// Find journal record that firmware loads (same search as [STAT_load()] in [usage_stats.c]).
+uint16_t find_stat_active(dump_t *dump)
+{
+    uint16_t slot, best;
+    uint8_t best_seq;
+    best = SEG_NONE;
+    best_seq = 0;
+    for(slot = 0; slot < dump->stat_count; slot++)
+    {
+        if(dump->stats[slot].state != SEG_VALID)
+        {
+            continue;
+        }
+        if((best == SEG_NONE)||((int8_t)(dump->stats[slot].seq-best_seq) > 0))
+        {
+            best = slot;
+            best_seq = dump->stats[slot].seq;
+        }
+    }
+    return best;
+}
+
+// Check all settings segments and usage stats journal slots.
+void analyze_dump(dump_t *dump, const opt_t *opts)
+{
+    uint16_t seg, stat_valid;
+    const uint8_t *stat_base;
+
+    dump->seg_size = opts->seg_size;
+    dump->area_size = opts->area_size;
+    if(dump->area_size == 0)
+    {
+        // Detect usage stats journal in the upper part of EEPROM.
+        dump->area_size = dump->rom_size;
+        if(dump->rom_size > EEPROM_STAT_AREA)
+        {
+            stat_valid = 0;
+            for(seg = 0; seg < ((dump->rom_size-EEPROM_STAT_AREA)/STAT_REC_SIZE); seg++)
+            {
+                check_segment(&dump->data[EEPROM_STAT_AREA+seg*STAT_REC_SIZE], STAT_REC_SIZE, STAT_REC_MARKER, STAT_IDX_SEQ, &dump->stats[seg]);
+                if(dump->stats[seg].state == SEG_VALID)
+                {
+                    stat_valid++;
+                }
+            }
+            if(stat_valid != 0)
+            {
+                dump->area_size = EEPROM_STAT_AREA;
+            }
+        }
+    }
+    if(dump->area_size > dump->rom_size)
+    {
+        dump->area_size = dump->rom_size;
+    }
+    dump->seg_count = dump->area_size/dump->seg_size;
+    for(seg = 0; seg < dump->seg_count; seg++)
+    {
+        check_segment(&dump->data[seg*dump->seg_size], dump->seg_size, EEPROM_START_MARKER, (dump->seg_size-2), &dump->segs[seg]);
+    }
+    dump->active = find_active(dump);
+
+    dump->stat_count = (dump->rom_size-dump->area_size)/STAT_REC_SIZE;
+    stat_base = &dump->data[dump->area_size];
+    for(seg = 0; seg < dump->stat_count; seg++)
+    {
+        check_segment(&stat_base[seg*STAT_REC_SIZE], STAT_REC_SIZE, STAT_REC_MARKER, STAT_IDX_SEQ, &dump->stats[seg]);
+    }
+    dump->stat_active = find_stat_active(dump);
+}
+
+// Unpack settings record (same as [SET_decode()] in [settings.c]), mark unpacked bytes in [out_present].
+void decode_settings(const uint8_t *in_record, uint16_t rec_size, uint8_t *out_settings, uint8_t *out_present)
+{
+    uint16_t pos;
+    uint8_t idx, tag, len, copy;
+    for(idx = 0; idx < SETTINGS_SIZE; idx++)
+    {
+        out_settings[idx] = 0;
+        out_present[idx] = 0;
+    }
+    if((in_record[SET_IDX_VERSION] & SET_VER_TLV) == 0)
+    {
+        // Fixed layout record from older firmware.
+        for(idx = 1; (idx < SETTINGS_SIZE)&&(idx < (rec_size-2)); idx++)
+        {
+            out_settings[idx] = in_record[idx];
+            out_present[idx] = 1;
+        }
+        return;
+    }
+    pos = SET_IDX_DATA;
+    while((pos+1) < (rec_size-2))
+    {
+        tag = in_record[pos];
+        if(tag == SET_TAG_END)
+        {
+            break;
+        }
+        len = in_record[pos+1];
+        pos += 2;
+        if((pos+len) > (rec_size-2))
+        {
+            break;
+        }
+        if(tag < SET_TAG_MAX)
+        {
+            copy = (len < lut_set_blocks[tag][1]) ? len : lut_set_blocks[tag][1];
+            for(idx = 0; idx < copy; idx++)
+            {
+                out_settings[lut_set_blocks[tag][0]+idx] = in_record[pos+idx];
+                out_present[lut_set_blocks[tag][0]+idx] = 1;
+            }
+        }
+        pos += len;
+    }
+}
+
+void print_flags(uint8_t flags, const char **names)
+{
+    uint8_t bit;
+    printf("0x%02X (", flags);
+    for(bit = 0; bit < 8; bit++)
+    {
+        if((flags & (1<<bit)) != 0)
+        {
+            printf(" %s", (names[bit][0] != '\0') ? names[bit] : "?");
+        }
+    }
+    printf(" )\n");
+}
+
+void print_settings(const dump_t *dump)
+{
+    const uint8_t *record;
+    uint8_t settings[SETTINGS_SIZE], present[SETTINGS_SIZE];
+    uint8_t ttr_type, idx;
+
+    record = &dump->data[dump->active*dump->seg_size];
+    printf("Active record: slot %u (0x%04X), sequence %u, ", dump->active, dump->active*dump->seg_size, dump->segs[dump->active].seq);
+    if((record[SET_IDX_VERSION] & SET_VER_TLV) == 0)
+    {
+        printf("fixed layout (older firmware)\n");
+    }
+    else
+    {
+        printf("container version %u\n", (record[SET_IDX_VERSION] & ~SET_VER_TLV));
+    }
+    decode_settings(record, dump->seg_size, settings, present);
+
+    ttr_type = settings[EPS_TTR_TYPE];
+    if(present[EPS_TTR_TYPE] == 0)
+    {
+        printf("    Tape transport:     not stored (firmware default)\n");
+    }
+    else if(ttr_type < TTR_TYPE_COUNT)
+    {
+        printf("    Tape transport:     %s\n", lut_ttr_names[ttr_type]);
+    }
+    else
+    {
+        printf("    Tape transport:     unknown (%u)\n", ttr_type);
+    }
+    if(present[EPS_TTR_FTRS] != 0)
+    {
+        printf("    Transport features: ");
+        print_flags(settings[EPS_TTR_FTRS], lut_ttr_fea_names);
+    }
+    if(present[EPS_SRV_FTRS] != 0)
+    {
+        printf("    Service features:   ");
+        print_flags(settings[EPS_SRV_FTRS], lut_srv_fea_names);
+    }
+    if(present[EPS_LOG_CFG] != 0)
+    {
+        printf("    UART log:           %s and above, muted 0x%02X\n",
+               lut_log_levels[(settings[EPS_LOG_CFG] & LOG_CFG_LVL_MASK) >> LOG_CFG_LVL_SHIFT],
+               (settings[EPS_LOG_CFG] & LOG_CFG_MUTE_MASK));
+    }
+    if((present[EPS_TIM_TYPE] == 0)||(settings[EPS_TIM_TYPE] == TIM_PROFILE_NONE))
+    {
+        printf("    Timing profile:     firmware defaults\n");
+    }
+    else if(settings[EPS_TIM_TYPE] != ttr_type)
+    {
+        printf("    Timing profile:     made for other transport (%u), firmware defaults are used\n", settings[EPS_TIM_TYPE]);
+    }
+    else if(ttr_type < TTR_TYPE_COUNT)
+    {
+        printf("    Timing profile:     custom (DLY in 2 ms ticks, TACHO in 20 ms ticks)\n");
+        for(idx = 0; idx < lut_prf_sizes[ttr_type]; idx++)
+        {
+            printf("        %-16s %3u\n", lut_prf_names[ttr_type][idx], settings[EPS_TIM_DATA+idx]);
+        }
+    }
+}
+
+void print_stats(const dump_t *dump)
+{
+    const uint8_t *record;
+    uint32_t value;
+    uint8_t cnt, idx;
+
+    record = &dump->data[dump->area_size+dump->stat_active*STAT_REC_SIZE];
+    printf("Usage stats: slot %u (0x%04X), sequence %u\n", dump->stat_active,
+           (dump->area_size+dump->stat_active*STAT_REC_SIZE), dump->stats[dump->stat_active].seq);
+    for(cnt = 0; cnt < STAT_CNT_MAX; cnt++)
+    {
+        value = 0;
+        for(idx = 4; idx > 0; idx--)
+        {
+            value = (value<<8)|record[STAT_IDX_CNT+cnt*4+idx-1];
+        }
+        if(cnt <= STAT_CNT_CAPSTAN)
+        {
+            printf("    %-20s %lu:%02lu:%02lu\n", lut_stat_names[cnt],
+                   (unsigned long)(value/3600), (unsigned long)((value/60)%60), (unsigned long)(value%60));
+        }
+        else
+        {
+            printf("    %-20s %lu\n", lut_stat_names[cnt], (unsigned long)value);
+        }
+    }
+}
+
+// Print map of slots, one char per slot.
+void print_map(const seg_info_t *slots, uint16_t count, uint16_t active)
+{
+    uint16_t slot;
+    for(slot = 0; slot < count; slot++)
+    {
+        if((slot%32) == 0)
+        {
+            printf("\n    %04u: ", slot);
+        }
+        putchar((slot == active) ? 'A' : lut_seg_chars[slots[slot].state]);
+    }
+    printf("\n");
+}
+
+// Print damaged slots, return number of them.
+uint16_t print_damaged(const seg_info_t *slots, uint16_t count, uint16_t base, uint16_t size, uint8_t quiet)
+{
+    uint16_t slot, damaged;
+    damaged = 0;
+    for(slot = 0; slot < count; slot++)
+    {
+        if((slots[slot].state == SEG_VALID)||(slots[slot].state == SEG_EMPTY))
+        {
+            continue;
+        }
+        damaged++;
+        if(quiet != 0)
+        {
+            continue;
+        }
+        printf("    slot %u (0x%04X): %s", slot, (base+slot*size), lut_seg_names[slots[slot].state]);
+        if(slots[slot].state == SEG_BIT_ERR)
+        {
+            printf(", byte %u bit %u, sequence %u", slots[slot].err_byte, slots[slot].err_bit, slots[slot].seq);
+        }
+        else if(slots[slot].state == SEG_BAD_CRC)
+        {
+            printf(", sequence %u", slots[slot].seq);
+        }
+        printf("\n");
+    }
+    return damaged;
+}
+
+// Count slots in given state.
+uint16_t count_state(const seg_info_t *slots, uint16_t count, uint8_t state)
+{
+    uint16_t slot, found;
+    found = 0;
+    for(slot = 0; slot < count; slot++)
+    {
+        if(slots[slot].state == state)
+        {
+            found++;
+        }
+    }
+    return found;
+}
+
+// Analyze one dump file and print report, return [DIAG_xxx] or -1 if file can not be read.
+int process_file(const char *file_name, const opt_t *opts)
+{
+    static dump_t dump;
+    uint16_t damaged;
+    uint8_t diag;
+
+    if(load_dump(file_name, &dump) != 0)
+    {
+        fprintf(stderr, "%s: unable to read EEPROM dump!\n", file_name);
+        return -1;
+    }
+    analyze_dump(&dump, opts);
+    damaged = print_damaged(dump.segs, dump.seg_count, 0, dump.seg_size, 1)+
+              print_damaged(dump.stats, dump.stat_count, dump.area_size, STAT_REC_SIZE, 1);
+    if(dump.active == SEG_NONE)
+    {
+        diag = DIAG_FAIL;
+    }
+    else if(damaged != 0)
+    {
+        diag = DIAG_WARN;
+    }
+    else
+    {
+        diag = DIAG_OK;
+    }
+
+    if(opts->verbose == 0)
+    {
+        // One line per dump.
+        printf("%s: %s", file_name, lut_diag_names[diag]);
+        if(dump.active != SEG_NONE)
+        {
+            printf(", active slot %u seq %u", dump.active, dump.segs[dump.active].seq);
+        }
+        printf(", valid %u/%u, damaged %u", count_state(dump.segs, dump.seg_count, SEG_VALID), dump.seg_count, damaged);
+        if(dump.stat_active != SEG_NONE)
+        {
+            const uint8_t *record = &dump.data[dump.area_size+dump.stat_active*STAT_REC_SIZE];
+            uint32_t play = (uint32_t)record[STAT_IDX_CNT]|((uint32_t)record[STAT_IDX_CNT+1]<<8)|
+                            ((uint32_t)record[STAT_IDX_CNT+2]<<16)|((uint32_t)record[STAT_IDX_CNT+3]<<24);
+            printf(", playback %lu h", (unsigned long)(play/3600));
+        }
+        printf("\n");
+        return diag;
+    }
+
+    printf("\n%s: %u bytes\n", file_name, dump.rom_size);
+    printf("Settings area: 0x0000...0x%04X, %u segments of %u bytes\n", (dump.area_size-1), dump.seg_count, dump.seg_size);
+    printf("Segment map (A = active, v = valid, . = empty, b = 1-bit error, ! = CRC mismatch, ? = junk):");
+    print_map(dump.segs, dump.seg_count, dump.active);
+    if(count_state(dump.segs, dump.seg_count, SEG_EMPTY) == 0)
+    {
+        printf("All segments were used at least once (records wrapped around).\n");
+    }
+    if(dump.active == SEG_NONE)
+    {
+        printf("No valid settings record, firmware will use defaults!\n");
+    }
+    else
+    {
+        print_settings(&dump);
+    }
+    if(dump.stat_count != 0)
+    {
+        printf("Usage stats journal: 0x%04X...0x%04X, %u slots", dump.area_size, (dump.rom_size-1), dump.stat_count);
+        print_map(dump.stats, dump.stat_count, dump.stat_active);
+        if(dump.stat_active == SEG_NONE)
+        {
+            printf("No valid usage stats record.\n");
+        }
+        else
+        {
+            print_stats(&dump);
+        }
+    }
+    if(damaged != 0)
+    {
+        printf("Damaged segments:\n");
+        print_damaged(dump.segs, dump.seg_count, 0, dump.seg_size, 0);
+        print_damaged(dump.stats, dump.stat_count, dump.area_size, STAT_REC_SIZE, 0);
+    }
+    printf("Diagnosis: %s\n", lut_diag_names[diag]);
+    return diag;
+}
+
+// Check file name extension for dump files.
+uint8_t is_dump_name(const char *file_name)
+{
+    const char *ext;
+    char ext_low[8];
+    uint8_t idx;
+    ext = strrchr(file_name, '.');
+    if((ext == NULL)||(strlen(ext) >= sizeof(ext_low)))
+    {
+        return 0;
+    }
+    for(idx = 0; ext[idx] != '\0'; idx++)
+    {
+        ext_low[idx] = ((ext[idx] >= 'A')&&(ext[idx] <= 'Z')) ? (ext[idx]-'A'+'a') : ext[idx];
+    }
+    ext_low[idx] = '\0';
+    return ((strcmp(ext_low, ".bin") == 0)||(strcmp(ext_low, ".hex") == 0)||(strcmp(ext_low, ".eep") == 0)) ? 1 : 0;
+}
+
+int compare_names(const void *name1, const void *name2)
+{
+    return strcmp(*(char * const *)name1, *(char * const *)name2);
+}
+
+// Process all dump files in directory (sorted by name), return the worst result.
+int process_dir(const char *dir_name, const opt_t *opts)
+{
+    static char *file_list[FILE_LIST_MAX];
+    char file_name[NAME_SIZE];
+    struct dirent *entry;
+    struct stat file_stat;
+    uint16_t file_cnt, idx;
+    uint16_t diag_cnt[3] = {0, 0, 0};
+    int res, worst;
+
+    DIR *in_dir = opendir(dir_name);
+    if(in_dir == NULL)
+    {
+        return -1;
+    }
+    file_cnt = 0;
+    while(((entry = readdir(in_dir)) != NULL)&&(file_cnt < FILE_LIST_MAX))
+    {
+        if(is_dump_name(entry->d_name) == 0)
+        {
+            continue;
+        }
+        snprintf(file_name, sizeof(file_name), "%s/%s", dir_name, entry->d_name);
+        if((stat(file_name, &file_stat) != 0)||(S_ISREG(file_stat.st_mode) == 0))
+        {
+            continue;
+        }
+        file_list[file_cnt++] = strdup(file_name);
+    }
+    closedir(in_dir);
+    qsort(file_list, file_cnt, sizeof(file_list[0]), compare_names);
+
+    worst = DIAG_OK;
+    for(idx = 0; idx < file_cnt; idx++)
+    {
+        res = process_file(file_list[idx], opts);
+        if(res >= 0)
+        {
+            diag_cnt[res]++;
+        }
+        if((res < 0)||(res > worst))
+        {
+            worst = (res < 0) ? DIAG_FAIL : res;
+        }
+        free(file_list[idx]);
+    }
+    printf("%s: %u dumps, %u OK, %u WARN, %u FAIL\n", dir_name, file_cnt, diag_cnt[DIAG_OK], diag_cnt[DIAG_WARN], diag_cnt[DIAG_FAIL]);
+    return worst;
+}
+
+void print_usage(const char *app_name)
+{
+    printf("Usage: %s [-v] [-a area] [-s segment] dump|directory ...\n", app_name);
+    printf("  -v          full report for each dump (default for single file)\n");
+    printf("  -q          one line per dump (default for directories and several files)\n");
+    printf("  -a area     settings segment area in bytes (default: auto, 512 if usage stats journal is found)\n");
+    printf("  -s segment  settings segment size in bytes (default: %u)\n", EEPROM_STORE_SIZE);
+    printf("Dumps: raw binary or Intel HEX (.bin, .hex, .eep in directories).\n");
+    printf("Exit code: 0 - all OK, 1 - damaged segments found, 2 - no valid settings or unreadable dump.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    opt_t opts;
+    struct stat path_stat;
+    int arg_idx, res, worst, paths, verbose;
+
+    opts.area_size = 0;
+    opts.seg_size = EEPROM_STORE_SIZE;
+    verbose = -1;
+    paths = 0;
+    for(arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        if(strcmp(argv[arg_idx], "-v") == 0)
+        {
+            verbose = 1;
+        }
+        else if(strcmp(argv[arg_idx], "-q") == 0)
+        {
+            verbose = 0;
+        }
+        else if(((strcmp(argv[arg_idx], "-a") == 0)||(strcmp(argv[arg_idx], "-s") == 0))&&((arg_idx+1) < argc))
+        {
+            unsigned long value = strtoul(argv[arg_idx+1], NULL, 0);
+            if((value < 16)||(value > EEPROM_ROM_MAX)||((value & (value-1)) != 0))
+            {
+                fprintf(stderr, "Wrong size: %s\n", argv[arg_idx+1]);
+                return 2;
+            }
+            if(argv[arg_idx][1] == 'a')
+            {
+                opts.area_size = (uint16_t)value;
+            }
+            else
+            {
+                opts.seg_size = (uint16_t)value;
+            }
+            arg_idx++;
+        }
+        else if(argv[arg_idx][0] == '-')
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            paths++;
+        }
+    }
+    if(paths == 0)
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    worst = DIAG_OK;
+    for(arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        if(argv[arg_idx][0] == '-')
+        {
+            if((argv[arg_idx][1] == 'a')||(argv[arg_idx][1] == 's'))
+            {
+                arg_idx++;
+            }
+            continue;
+        }
+        if(stat(argv[arg_idx], &path_stat) != 0)
+        {
+            fprintf(stderr, "%s: not found!\n", argv[arg_idx]);
+            worst = DIAG_FAIL;
+            continue;
+        }
+        if(S_ISDIR(path_stat.st_mode))
+        {
+            opts.verbose = (verbose < 0) ? 0 : (uint8_t)verbose;
+            res = process_dir(argv[arg_idx], &opts);
+        }
+        else
+        {
+            opts.verbose = (verbose < 0) ? ((paths == 1) ? 1 : 0) : (uint8_t)verbose;
+            res = process_file(argv[arg_idx], &opts);
+        }
+        if((res < 0)||(res > worst))
+        {
+            worst = (res < 0) ? DIAG_FAIL : res;
+        }
+    }
+    return worst;
+}
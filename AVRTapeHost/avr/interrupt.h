@@ -0,0 +1,29 @@
+// Host build stub of <avr/interrupt.h>.
+// Interrupt vectors become plain functions, host code calls them directly.
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define ISR_NAKED
+#define ISR_NOBLOCK
+#define ISR(vector, ...)	void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector)	void vector(void){}
+#define sei()		do{}while(0)
+#define cli()		do{}while(0)
+#define reti()		do{}while(0)
+
+#define WDT_vect			host_WDT_vect
+#define TIMER2_COMPA_vect	host_TIMER2_COMPA_vect
+#define PCINT0_vect			host_PCINT0_vect
+#define PCINT1_vect			host_PCINT1_vect
+#define PCINT2_vect			host_PCINT2_vect
+#define SPI_STC_vect		host_SPI_STC_vect
+#define USART_RX_vect		host_USART_RX_vect
+#define USART_TX_vect		host_USART_TX_vect
+#define USART_UDRE_vect		host_USART_UDRE_vect
+#define EE_READY_vect		host_EE_READY_vect
+#define ADC_vect			host_ADC_vect
+#define TIMER1_CAPT_vect	host_TIMER1_CAPT_vect
+
+#endif /* HOST_AVR_INTERRUPT_H */
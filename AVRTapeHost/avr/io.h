@@ -0,0 +1,204 @@
+// Host build stub of <avr/io.h> (ATmega328P subset used by the firmware).
+// I/O registers are plain bytes in [host_sfr] array, EEPROM registers are handled by EEPROM model in [host_io.c].
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t host_sfr[256];
+extern volatile uint16_t host_eear;
+volatile uint8_t *host_eecr(void);
+volatile uint8_t *host_eedr(void);
+
+#define _SFR(x)		(host_sfr[(x)])
+#define _SFR16(x)	(*(volatile uint16_t *)(host_sfr+(x)))
+#define _SFR_IO16(x)	_SFR16((x)+0x20)
+
+// EEPROM registers (access completes pending EEPROM operation).
+#define EECR		(*host_eecr())
+#define EEDR		(*host_eedr())
+#define EEAR		host_eear
+#define SPMCSR		_SFR(0x57)
+
+#define SIGNATURE_2 0x0F
+#define E2END 0x3FF
+#define FLASHEND 0x7FFF
+#define RAMEND 0x8FF
+#define PINB _SFR(0x23)
+#define DDRB _SFR(0x24)
+#define PORTB _SFR(0x25)
+#define PINC _SFR(0x26)
+#define DDRC _SFR(0x27)
+#define PORTC _SFR(0x28)
+#define PIND _SFR(0x29)
+#define DDRD _SFR(0x2A)
+#define PORTD _SFR(0x2B)
+#define PCIFR _SFR(0x3B)
+#define EIFR _SFR(0x3C)
+#define EIMSK _SFR(0x3D)
+#define SPCR _SFR(0x4C)
+#define SPSR _SFR(0x4D)
+#define SPDR _SFR(0x4E)
+#define ACSR _SFR(0x50)
+#define SMCR _SFR(0x53)
+#define MCUSR _SFR(0x54)
+#define MCUCR _SFR(0x55)
+#define WDTCSR _SFR(0x60)
+#define CLKPR _SFR(0x61)
+#define PRR _SFR(0x64)
+#define PCICR _SFR(0x68)
+#define EICRA _SFR(0x69)
+#define PCMSK0 _SFR(0x6B)
+#define PCMSK1 _SFR(0x6C)
+#define PCMSK2 _SFR(0x6D)
+#define TIMSK0 _SFR(0x6E)
+#define TIMSK1 _SFR(0x6F)
+#define TIMSK2 _SFR(0x70)
+#define ADCSRA _SFR(0x7A)
+#define TCCR1A _SFR(0x80)
+#define TCCR1B _SFR(0x81)
+#define TCNT1 _SFR16(0x84)
+#define ICR1 _SFR16(0x86)
+#define TCCR2A _SFR(0xB0)
+#define TCCR2B _SFR(0xB1)
+#define TCNT2 _SFR(0xB2)
+#define OCR2A _SFR(0xB3)
+#define OCR2B _SFR(0xB4)
+#define ASSR _SFR(0xB6)
+#define UCSR0A _SFR(0xC0)
+#define UCSR0B _SFR(0xC1)
+#define UCSR0C _SFR(0xC2)
+#define UBRR0L _SFR(0xC4)
+#define UBRR0H _SFR(0xC5)
+#define UDR0 _SFR(0xC6)
+#define SREG _SFR(0x5F)
+enum {PB0,PB1,PB2,PB3,PB4,PB5,PB6,PB7};
+enum {PC0,PC1,PC2,PC3,PC4,PC5,PC6};
+enum {PD0,PD1,PD2,PD3,PD4,PD5,PD6,PD7};
+#define PINB0 0
+#define PINB1 1
+#define PINB2 2
+#define PINB3 3
+#define PINB4 4
+#define PINB5 5
+#define PINC0 0
+#define PINC1 1
+#define PINC2 2
+#define PINC3 3
+#define PINC4 4
+#define PINC5 5
+#define PIND0 0
+#define PIND1 1
+#define PIND2 2
+#define PIND3 3
+#define PIND4 4
+#define PIND5 5
+#define PIND6 6
+#define PIND7 7
+#define PCINT8 0
+#define PCINT9 1
+#define PCINT10 2
+#define PCINT11 3
+#define PCINT12 4
+#define PCINT13 5
+#define PCINT16 0
+#define PCINT17 1
+#define PCINT18 2
+#define PCINT19 3
+#define PCINT20 4
+#define PCINT21 5
+#define PCINT22 6
+#define PCINT23 7
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+#define EERE 0
+#define EEPE 1
+#define EEMPE 2
+#define EERIE 3
+#define EEPM0 4
+#define EEPM1 5
+#define SELFPRGEN 0
+#define SPMEN 0
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define SPIF 7
+#define SPI2X 0
+#define ACD 7
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE 3
+#define WDCE 4
+#define WDP3 5
+#define WDIE 6
+#define WDIF 7
+#define CLKPS0 0
+#define CLKPS1 1
+#define CLKPS2 2
+#define CLKPS3 3
+#define CLKPCE 7
+#define PRADC 0
+#define PRUSART0 1
+#define PRSPI 2
+#define PRTIM1 3
+#define PRTIM0 5
+#define PRTIM2 6
+#define PRTWI 7
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOIE2 0
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define COM2A0 6
+#define COM2A1 7
+#define ICIE1 5
+#define ICES1 6
+#define ICNC1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define SE 0
+#define SM0 1
+#define SM1 2
+#define SM2 3
+#define BODSE 5
+#define BODS 6
+#define MPCM0 0
+#define U2X0 1
+#define UPE0 2
+#define DOR0 3
+#define FE0 4
+#define UDRE0 5
+#define TXC0 6
+#define RXC0 7
+#define TXB80 0
+#define RXB80 1
+#define UCSZ02 2
+#define TXEN0 3
+#define RXEN0 4
+#define UDRIE0 5
+#define TXCIE0 6
+#define RXCIE0 7
+#define UCSZ00 1
+#define UCSZ01 2
+#define ADEN 7
+
+#endif /* HOST_AVR_IO_H */
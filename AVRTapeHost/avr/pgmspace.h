@@ -0,0 +1,15 @@
+// Host build stub of <avr/pgmspace.h>.
+// Flash and RAM share the same address space on host.
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s)					(s)
+#define pgm_read_byte_near(a)	(*(const uint8_t *)(a))
+#define pgm_read_byte(a)		(*(const uint8_t *)(a))
+#define pgm_read_word_near(a)	(*(const uint16_t *)(a))
+#define pgm_read_word(a)		(*(const uint16_t *)(a))
+
+#endif /* HOST_AVR_PGMSPACE_H */
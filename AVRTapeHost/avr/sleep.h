@@ -0,0 +1,15 @@
+// Host build stub of <avr/sleep.h>.
+#ifndef HOST_AVR_SLEEP_H
+#define HOST_AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE			0
+#define SLEEP_MODE_PWR_DOWN		2
+#define SLEEP_MODE_PWR_SAVE		3
+#define set_sleep_mode(x)		do{}while(0)
+#define sleep_enable()			do{}while(0)
+#define sleep_disable()			do{}while(0)
+#define sleep_cpu()				do{}while(0)
+#define sleep_mode()			do{}while(0)
+#define sleep_bod_disable()		do{}while(0)
+
+#endif /* HOST_AVR_SLEEP_H */
@@ -0,0 +1,14 @@
+// Host build stub of <avr/wdt.h>.
+#ifndef HOST_AVR_WDT_H
+#define HOST_AVR_WDT_H
+
+#define wdt_reset()		do{}while(0)
+#define wdt_enable(x)	do{}while(0)
+#define wdt_disable()	do{}while(0)
+#define WDTO_15MS		0
+#define WDTO_250MS		4
+#define WDTO_500MS		5
+#define WDTO_1S			6
+#define WDTO_2S			7
+
+#endif /* HOST_AVR_WDT_H */
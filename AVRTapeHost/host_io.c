@@ -0,0 +1,111 @@
+#include <string.h>
+#include "host_io.h"
+
+volatile uint8_t host_sfr[256];
+volatile uint16_t host_eear;
+static volatile uint8_t u8_eecr, u8_eedr;
+
+uint8_t host_eep_mem[HOST_EEP_SIZE];
+uint32_t host_eep_erases[HOST_EEP_SIZE];
+uint32_t host_eep_writes[HOST_EEP_SIZE];
+
+static long cut_at=HOST_EEP_NO_CUT;
+static uint32_t op_count=0;
+static uint32_t rnd_state=0x12345678;
+
+// Simple LCG for torn cell contents.
+static uint8_t host_random(void)
+{
+    rnd_state=rnd_state*1103515245+12345;
+    return (uint8_t)(rnd_state>>16);
+}
+
+void host_eep_reset(uint8_t fill)
+{
+    memset(host_eep_mem, fill, sizeof(host_eep_mem));
+    memset(host_eep_erases, 0, sizeof(host_eep_erases));
+    memset(host_eep_writes, 0, sizeof(host_eep_writes));
+    u8_eecr=0;
+    cut_at=HOST_EEP_NO_CUT;
+    op_count=0;
+}
+
+void host_eep_set_cut(long op_idx)
+{
+    host_eep_complete();
+    cut_at=op_idx;
+    op_count=0;
+}
+
+uint32_t host_eep_get_ops(void)
+{
+    return op_count;
+}
+
+uint8_t host_eep_is_cut(void)
+{
+    return ((cut_at!=HOST_EEP_NO_CUT)&&(op_count>(uint32_t)cut_at))?1:0;
+}
+
+// Erase/write started by setting EEPE is finished on the next register access.
+// Programming mode is taken from EEPM1:EEPM0 bits: 0 - erase and write, 1 - erase only, 2 - write only.
+void host_eep_complete(void)
+{
+    uint8_t mode;
+    uint16_t addr;
+    if((u8_eecr&(1<<EEPE))==0) return;
+    u8_eecr&=~((1<<EEPE)|(1<<EEMPE));
+    addr=host_eear%HOST_EEP_SIZE;
+    mode=(u8_eecr>>EEPM0)&0x03;
+    if((cut_at!=HOST_EEP_NO_CUT)&&(op_count>=(uint32_t)cut_at))
+    {
+        if(op_count==(uint32_t)cut_at)
+        {
+            // Power is lost during programming, cell state is undefined.
+            host_eep_mem[addr]=host_random();
+        }
+        op_count++;
+        return;
+    }
+    op_count++;
+    if((mode==0)||(mode==1))
+    {
+        host_eep_mem[addr]=0xFF;
+        host_eep_erases[addr]++;
+    }
+    if((mode==0)||(mode==2))
+    {
+        host_eep_mem[addr]&=u8_eedr;
+        host_eep_writes[addr]++;
+    }
+}
+
+volatile uint8_t *host_eecr(void)
+{
+    host_eep_complete();
+    if((u8_eecr&(1<<EERE))!=0)
+    {
+        u8_eecr&=~(1<<EERE);
+        u8_eedr=host_eep_mem[host_eear%HOST_EEP_SIZE];
+    }
+    return &u8_eecr;
+}
+
+volatile uint8_t *host_eedr(void)
+{
+    // Finish pending operations (data is loaded if read was started).
+    host_eecr();
+    return &u8_eedr;
+}
+
+uint32_t host_eep_max_wear(uint16_t start, uint16_t end)
+{
+    uint32_t max_wear=0;
+    uint16_t addr;
+    for(addr=start;(addr<end)&&(addr<HOST_EEP_SIZE);addr++)
+    {
+        if(host_eep_erases[addr]>max_wear) max_wear=host_eep_erases[addr];
+        if(host_eep_writes[addr]>max_wear) max_wear=host_eep_writes[addr];
+    }
+    return max_wear;
+}
@@ -0,0 +1,24 @@
+// Host build support for AVRTapeControl firmware modules.
+// Provides I/O register space and EEPROM model with per-cell wear accounting and power cut injection.
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define HOST_EEP_SIZE		(E2END+1)	// EEPROM size (bytes)
+#define HOST_EEP_ENDURANCE	100000UL	// Erase/write cycles per cell (datasheet minimum)
+#define HOST_EEP_NO_CUT		(-1L)		// Power cut is disabled
+
+extern uint8_t host_eep_mem[HOST_EEP_SIZE];			// Raw (not inverted) cell contents
+extern uint32_t host_eep_erases[HOST_EEP_SIZE];		// Erase operations per cell
+extern uint32_t host_eep_writes[HOST_EEP_SIZE];		// Write operations per cell
+
+void host_eep_reset(uint8_t fill);		// Fill EEPROM, clear wear counters and power cut
+void host_eep_set_cut(long op_idx);		// Cut power at operation [op_idx] (counted from this call), torn cell gets random data
+uint32_t host_eep_get_ops(void);		// Get number of erase/write operations since last [host_eep_set_cut()]
+uint8_t host_eep_is_cut(void);			// Check if power was cut
+void host_eep_complete(void);			// Finish pending erase/write (as if programming time passed)
+uint32_t host_eep_max_wear(uint16_t start, uint16_t end);	// Get maximum of erases and writes per cell in address range
+
+#endif /* HOST_IO_H */
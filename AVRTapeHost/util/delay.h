@@ -0,0 +1,8 @@
+// Host build stub of <util/delay.h>.
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+
+#define _delay_us(x)	do{}while(0)
+#define _delay_ms(x)	do{}while(0)
+
+#endif /* HOST_UTIL_DELAY_H */
@@ -0,0 +1,21 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CFLAGS_RELEASE += -O3
+
+DEFINES += __AVR_ATmega328P__
+# Feature switches of [config.h] under test are turned off in [bench_config.h].
+# Fast auto-reverse off (run qmake "FAST_AREV=0" to measure regular STOP -> PLAY path).
+equals(FAST_AREV, 0): DEFINES += BENCH_NO_FAST_AREV
+# STOP sensor re-anchoring of the cyclogram off (run qmake "STOP_ANCHOR=0" to measure selection misses without it).
+equals(STOP_ANCHOR, 0): DEFINES += BENCH_NO_STOP_ANCHOR
+INCLUDEPATH += ../AVRTapeHost ../AVRTapeControl
+
+SOURCES += \
+        main.c \
+        ../AVRTapeHost/host_io.c \
+        ../AVRTapeControl/idle_policy.c \
+        ../AVRTapeControl/mech_calib.c \
+        mech_crp42602y_bench.c
@@ -0,0 +1,15 @@
+// Feature switches of [config.h] under test in the mechanism bench.
+// Firmware config is taken as is, switches are turned off here by qmake options (see [AVRTapeMechBench.pro]).
+#ifndef BENCH_CONFIG_H
+#define BENCH_CONFIG_H
+
+#include "config.h"
+
+#ifdef BENCH_NO_FAST_AREV
+#undef EN_FAST_AREV             // Measure regular STOP -> PLAY path in auto-reverse
+#endif
+#ifdef BENCH_NO_STOP_ANCHOR
+#undef EN_STOP_ANCHOR           // Measure selection misses without re-anchoring by STOP sensor
+#endif
+
+#endif /* BENCH_CONFIG_H */
@@ -0,0 +1,492 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_io.h"
+#include "bench_config.h"
+#include "mech_crp42602y.h"
+
+#define SIM_TICK_MS         2           // State machine call period (500 Hz task)
+#define SIM_SCAN_DIV        10          // Switches scan and tacho timer divider (50 Hz task)
+#define SIM_SIDE_MS         6000        // Tape side length in playback (ms)
+#define SIM_TACHO_MS        400         // Takeup tacho period in playback (ms)
+#define SIM_SPIN_MS         150         // Capstan motor reaches nominal speed after power on (ms)
+#define SIM_START_CLR_MS    60          // Mechanism leaves STOP sensor after start pulse (ms)
+#define SIM_CYCLE_MS        400         // Command gear full turn from STOP to active mode (ms)
+#define SIM_SEL_HEAD_MS     76          // Cam samples solenoid for head/pinch direction (ms of gear turn)
+#define SIM_SEL_PINCH_MS    200         // Cam samples solenoid for pinch engage (ms of gear turn)
+#define SIM_SEL_TAKEUP_MS   328         // Cam samples solenoid for takeup direction (ms of gear turn)
+#define SIM_WINDOW_RUNS     40          // Number of STOP -> active mode transitions per gear timing case
+#define SIM_LIMIT_MS        600000      // Simulation time limit per measurement (ms)
+#define DEF_REVERSALS       10          // Default number of side changes per scenario
+
+#ifdef EN_FAST_AREV
+#define FAST_AREV_STATE     "on"
+#else
+#define FAST_AREV_STATE     "off"
+#endif /* EN_FAST_AREV */
+#ifdef EN_STOP_ANCHOR
+#define STOP_ANCHOR_STATE   "on"
+#else
+#define STOP_ANCHOR_STATE   "off"
+#endif /* EN_STOP_ANCHOR */
+
+// Mechanical state of simulated transport.
+enum
+{
+    MS_STOP,                        // Command gear in home position, STOP sensor active
+    MS_STARTING,                    // Command gear turning from STOP to active mode
+    MS_ACTIVE,                      // Active mode is engaged
+    MS_STOPPING                     // Command gear returning to STOP
+};
+
+typedef struct
+{
+    const char *name;
+    uint16_t stop_ms;               // Time from stop pulse to STOP sensor
+} scenario_t;
+
+static const scenario_t scenarios[] =
+{
+    {"nominal motor", 180},
+    {"slow motor", 280}
+};
+
+// Takeup tacho periods in STOP for start-up measurement (0 - mechanism without tacho in STOP).
+static const uint16_t stop_tacho_periods[] = {0, 30, 50, 80};
+
+// Time from cassette insertion to PLAY command for pre-spin measurement.
+static const uint16_t insert_to_play_ms[] = {200, 500, 1000};
+
+typedef struct
+{
+    uint16_t lag_ms;                // Command gear engagement lag after start pulse
+    uint16_t speed_pct;             // Duration of gear turn relative to nominal (slow motor - more than 100%)
+} gear_case_t;
+
+// Command gear timing for selection window measurement.
+static const gear_case_t gear_cases[] =
+{
+    {0, 100}, {20, 100}, {40, 100}, {0, 115}, {20, 115}
+};
+
+// User modes cycled through in selection window measurement.
+static const uint8_t window_modes[] = {USR_MODE_PLAY_FWD, USR_MODE_PLAY_REV, USR_MODE_FWIND_FWD, USR_MODE_FWIND_REV};
+
+typedef struct
+{
+    uint32_t n;
+    uint32_t detect;                // Tape end -> auto-stop (tacho timeout)
+    uint32_t to_stop;               // Auto-stop -> STOP sensor
+    uint32_t mech;                  // Auto-stop -> playback in other direction
+    uint32_t silent;                // Tape end -> playback in other direction (mute off)
+} gap_stats_t;
+
+static const scenario_t *mech_sc;
+static uint8_t ttr_features, mech_state, sw_state, tacho_timer, usr_mode, play_dir;
+static uint16_t mech_time, stop_tacho_ms;
+static uint8_t last_sol, tick_div, at_end;
+static uint32_t now, tape_pos, tacho_acc, spin_time;
+static const gear_case_t *gear;
+static uint8_t sel_target, sel_miss;
+
+// Power-up: transport in STOP, user wants playback (firmware state machine starts from its defaults).
+static void sim_init(void)
+{
+    memset((void *)host_sfr, 0, 256);
+    mech_sc=&scenarios[0];
+    gear=&gear_cases[0];
+    sel_target=TTR_42602_MODE_STOP; sel_miss=0;
+    ttr_features=TTR_FEA_REV_ENABLE;
+    mech_state=MS_STOP; mech_time=0; last_sol=0; tick_div=0; at_end=0;
+    now=0; tape_pos=0; tacho_acc=0; spin_time=0; stop_tacho_ms=0;
+    sw_state=TTR_SW_TAPE_IN|TTR_SW_STOP;
+    tacho_timer=0;
+    usr_mode=USR_MODE_PLAY_FWD;
+    play_dir=PB_DIR_FWD;
+}
+
+// Check solenoid state at the cam sampling point, register mismatch with firmware target.
+static void sim_select(uint32_t phase, uint16_t point, uint8_t sol, uint8_t want)
+{
+    if((phase>=point)&&(phase<(uint32_t)(point+SIM_TICK_MS))&&(sol!=want))
+    {
+        sel_miss=1;
+    }
+}
+
+// Simulate command gear for one tick, returns STOP sensor state.
+static uint8_t sim_mech(void)
+{
+    uint8_t sol=((PORTB&(1<<0))!=0);
+    uint32_t phase=0;
+    mech_time+=SIM_TICK_MS;
+    if((sol!=0)&&(last_sol==0))
+    {
+        // Solenoid pulse trips the command gear.
+        if(mech_state==MS_ACTIVE)
+        {
+            mech_state=MS_STOPPING;
+            mech_time=0;
+        }
+        else if(mech_state==MS_STOP)
+        {
+            mech_state=MS_STARTING;
+            mech_time=0;
+            sel_target=mech_crp42602y_get_target();
+            sel_miss=0;
+        }
+    }
+    last_sol=sol;
+    if(mech_state==MS_STARTING)
+    {
+        // Gear turns with engagement lag and speed of the current case.
+        if(mech_time>gear->lag_ms) phase=(uint32_t)(mech_time-gear->lag_ms)*100/gear->speed_pct;
+        sim_select(phase, SIM_SEL_HEAD_MS, sol, (sel_target==TTR_42602_MODE_PB_REV)||(sel_target==TTR_42602_MODE_RC_REV)||
+                   (sel_target==TTR_42602_MODE_FW_FWD_HD_REV)||(sel_target==TTR_42602_MODE_FW_REV_HD_REV));
+        sim_select(phase, SIM_SEL_PINCH_MS, sol, (sel_target==TTR_42602_MODE_PB_FWD)||(sel_target==TTR_42602_MODE_PB_REV)||
+                   (sel_target==TTR_42602_MODE_RC_FWD)||(sel_target==TTR_42602_MODE_RC_REV));
+        sim_select(phase, SIM_SEL_TAKEUP_MS, sol, (sel_target==TTR_42602_MODE_PB_FWD)||(sel_target==TTR_42602_MODE_RC_FWD)||
+                   (sel_target==TTR_42602_MODE_FW_FWD)||(sel_target==TTR_42602_MODE_FW_FWD_HD_REV));
+    }
+    if((mech_state==MS_STOPPING)&&(mech_time>=mech_sc->stop_ms))
+    {
+        mech_state=MS_STOP;
+    }
+    else if((mech_state==MS_STARTING)&&(phase>=SIM_CYCLE_MS))
+    {
+        mech_state=MS_ACTIVE;
+    }
+    if(mech_state==MS_STOP) return 1;
+    if((mech_state==MS_STARTING)&&(phase<SIM_START_CLR_MS)) return 1;
+    return 0;
+}
+
+// Simulate tape and takeup tacho for one tick.
+static void sim_tape(uint8_t state)
+{
+    uint32_t period=0;
+    if((PORTB&(1<<1))!=0)
+    {
+        spin_time+=SIM_TICK_MS;
+    }
+    else
+    {
+        spin_time=0;
+    }
+    if((mech_state==MS_ACTIVE)&&((state==TTR_42602_MODE_PB_FWD)||(state==TTR_42602_MODE_PB_REV)))
+    {
+        // Tape moves only in engaged playback, reels stop at the end of the tape.
+        if(state==TTR_42602_MODE_PB_FWD)
+        {
+            if(tape_pos<SIM_SIDE_MS) tape_pos+=SIM_TICK_MS;
+            at_end=(tape_pos>=SIM_SIDE_MS);
+        }
+        else
+        {
+            if(tape_pos>0) tape_pos-=SIM_TICK_MS;
+            at_end=(tape_pos==0);
+        }
+        if(at_end==0) period=SIM_TACHO_MS;
+    }
+    else if((mech_state!=MS_ACTIVE)&&(stop_tacho_ms!=0)&&(spin_time>=(SIM_SPIN_MS/4)))
+    {
+        // Takeup pulley turns in STOP, its speed follows capstan spin-up.
+        period=stop_tacho_ms;
+        if(spin_time<SIM_SPIN_MS) period=period*SIM_SPIN_MS/spin_time;
+    }
+    if(period==0)
+    {
+        tacho_acc=0;
+        return;
+    }
+    tacho_acc+=SIM_TICK_MS;
+    if(tacho_acc>=period)
+    {
+        tacho_acc=0;
+        tacho_timer=0;
+    }
+}
+
+// Run one tick of firmware tasks with simulated transport, returns STOP sensor state.
+static uint8_t sim_step(void)
+{
+    uint8_t stop_sw;
+    stop_sw=sim_mech();
+    sim_tape(mech_crp42602y_get_state());
+    // 50 Hz task: scan switches, count up tacho timer.
+    tick_div++;
+    if(tick_div>=SIM_SCAN_DIV)
+    {
+        tick_div=0;
+        sw_state=TTR_SW_TAPE_IN|((stop_sw!=0)?TTR_SW_STOP:0);
+        if(tacho_timer<240) tacho_timer++;
+    }
+#ifdef EN_STOP_ANCHOR
+    // STOP sensor is also scanned in 500 Hz task.
+    sw_state=TTR_SW_TAPE_IN|((stop_sw!=0)?TTR_SW_STOP:0);
+#endif /* EN_STOP_ANCHOR */
+    // 500 Hz task: transport state machine (output pins read back through PIN registers).
+    PINB=PORTB; PIND=PORTD;
+    mech_crp42602y_state_machine(ttr_features, (SRV_FEA_PB_AUTOREV|SRV_FEA_PB_LOOP), sw_state, &tacho_timer, &usr_mode, &play_dir);
+    PINB=PORTB; PIND=PORTD;
+    if(mech_crp42602y_get_error()!=TTR_ERR_NONE)
+    {
+        printf("ERROR: transport error 0x%02X at %u ms!\n", mech_crp42602y_get_error(), (unsigned)now);
+        exit(2);
+    }
+    now+=SIM_TICK_MS;
+    return stop_sw;
+}
+
+// Continue simulation until [reversals] side changes are measured.
+static void run_reversals(uint16_t reversals, gap_stats_t *st)
+{
+    uint32_t t_end=0, t_stopcmd=0, t_stopsw=0, t_limit;
+    uint8_t stop_sw, state, last_dir=PB_DIR_FWD, phase=0;
+    memset(st, 0, sizeof(*st));
+    t_limit=now+SIM_LIMIT_MS;
+    while(now<t_limit)
+    {
+        stop_sw=sim_step();
+        state=mech_crp42602y_get_state();
+        if(phase==0)
+        {
+            if((at_end!=0)&&((state==TTR_42602_MODE_PB_FWD)||(state==TTR_42602_MODE_PB_REV)))
+            {
+                t_end=now;
+                last_dir=(state==TTR_42602_MODE_PB_FWD)?PB_DIR_FWD:PB_DIR_REV;
+                phase=1;
+            }
+        }
+        else if(phase==1)
+        {
+            if((state!=TTR_42602_MODE_PB_FWD)&&(state!=TTR_42602_MODE_PB_REV))
+            {
+                t_stopcmd=now;
+                phase=2;
+            }
+        }
+        else if(phase==2)
+        {
+            if(stop_sw!=0)
+            {
+                t_stopsw=now;
+                phase=3;
+            }
+        }
+        else if((MUTE_EN_STATE==0)&&(((last_dir==PB_DIR_FWD)&&(state==TTR_42602_MODE_PB_REV))||((last_dir==PB_DIR_REV)&&(state==TTR_42602_MODE_PB_FWD))))
+        {
+            st->n++;
+            st->detect+=t_stopcmd-t_end;
+            st->to_stop+=t_stopsw-t_stopcmd;
+            st->mech+=now-t_stopcmd;
+            st->silent+=now-t_end;
+            at_end=0;
+            phase=0;
+            if(st->n>=reversals) break;
+        }
+    }
+}
+
+// Stop transport, wait for idle capstan shutdown, then measure PLAY command latency.
+// [prespin_ms] - time between capstan pre-spin on cassette insertion and PLAY command (0 - no pre-spin).
+static uint32_t run_startup(uint16_t prespin_ms)
+{
+    uint32_t t_limit, t_cmd;
+    usr_mode=USR_MODE_STOP;
+    t_limit=now+SIM_LIMIT_MS;
+    while(now<t_limit)
+    {
+        sim_step();
+        if((mech_crp42602y_get_state()==TTR_42602_MODE_STOP)&&((PORTB&(1<<1))==0)) break;
+    }
+    if(now>=t_limit) return 0;
+    if(prespin_ms!=0)
+    {
+        // Cassette is inserted, user presses PLAY a bit later.
+        mech_crp42602y_prespin();
+        t_limit=now+prespin_ms;
+        while(now<t_limit)
+        {
+            sim_step();
+        }
+    }
+    // Start playback from the beginning of the tape.
+    tape_pos=0; at_end=0;
+    usr_mode=USR_MODE_PLAY_FWD;
+    t_cmd=now;
+    t_limit=now+SIM_LIMIT_MS;
+    while(now<t_limit)
+    {
+        sim_step();
+        if((mech_crp42602y_get_state()==TTR_42602_MODE_PB_FWD)&&(MUTE_EN_STATE==0)) return (now-t_cmd);
+    }
+    return 0;
+}
+
+// Run firmware timing calibration on simulated transport in STOP and apply derived profile.
+// Returns 0 if profile is applied, 1 if it was rejected, 2 if calibration failed.
+static uint8_t run_calib(uint16_t *leave, uint16_t *home)
+{
+    uint16_t plan[CAL_STEP_MAX*CAL_PLAN_SIZE];
+    uint8_t profile[PRF_42602_MAX];
+    uint8_t stop_sw;
+    CAL_start(plan, mech_crp42602y_calib_plan(plan));
+    while(CAL_is_running()!=0)
+    {
+        // Calibration runs in 1 kHz system tick instead of transport state machine.
+        stop_sw=sim_mech();
+        CAL_tick(stop_sw, 0);
+        CAL_tick(stop_sw, 0);
+        now+=SIM_TICK_MS;
+    }
+    *leave=CAL_get_leave();
+    *home=CAL_get_home();
+    if(CAL_get_state()!=CAL_ST_DONE) return 2;
+    if(mech_crp42602y_calib_profile(*leave, *home, profile)!=0) return 1;
+    return (mech_crp42602y_set_profile(profile)!=0);
+}
+
+// Cycle STOP -> active mode -> STOP [runs] times, returns number of transitions where the cam picked wrong selection.
+static uint16_t run_windows(uint16_t runs)
+{
+    uint32_t t_limit;
+    uint16_t idx, misses=0;
+    uint8_t state;
+    for(idx=0;idx<runs;idx++)
+    {
+        // Keep tape away from its ends.
+        tape_pos=SIM_SIDE_MS/2; at_end=0;
+        usr_mode=window_modes[idx%(sizeof(window_modes)/sizeof(window_modes[0]))];
+        t_limit=now+SIM_LIMIT_MS;
+        while(now<t_limit)
+        {
+            sim_step();
+            state=mech_crp42602y_get_state();
+            if((mech_state==MS_ACTIVE)&&(state>=TTR_42602_MODE_PB_FWD)&&(state<=TTR_42602_MODE_FW_REV_HD_REV)) break;
+        }
+        if(sel_miss!=0) misses++;
+        usr_mode=USR_MODE_STOP;
+        while(now<t_limit)
+        {
+            sim_step();
+            if((mech_crp42602y_get_state()==TTR_42602_MODE_STOP)&&(mech_state==MS_STOP)) break;
+        }
+        if(now>=t_limit) return 0xFFFF;
+    }
+    return misses;
+}
+
+int main(int argc, char *argv[])
+{
+    uint16_t reversals=DEF_REVERSALS;
+    uint16_t leave, home;
+    uint32_t latency;
+    uint8_t idx, sc_idx, res;
+    uint8_t defaults[PRF_42602_MAX];
+    gap_stats_t st;
+    if(argc>1)
+    {
+        reversals=(uint16_t)atoi(argv[1]);
+        if(reversals==0) reversals=DEF_REVERSALS;
+    }
+    sim_init();
+    printf("CRP42602Y auto-reverse gap, fast auto-reverse: %s, %u side changes per scenario\n", FAST_AREV_STATE, (unsigned)reversals);
+    printf("%-14s %9s %9s %9s %9s %9s\n", "scenario", "stop_ms", "detect", "to_STOP", "mech_gap", "silent");
+    for(idx=0;idx<(sizeof(scenarios)/sizeof(scenarios[0]));idx++)
+    {
+        mech_sc=&scenarios[idx];
+        run_reversals(reversals, &st);
+        if(st.n==0)
+        {
+            printf("ERROR: no side changes in \"%s\"!\n", scenarios[idx].name);
+            return 2;
+        }
+        printf("%-14s %9u %9u %9u %9u %9u\n", scenarios[idx].name, (unsigned)scenarios[idx].stop_ms,
+               (unsigned)(st.detect/st.n), (unsigned)(st.to_stop/st.n), (unsigned)(st.mech/st.n), (unsigned)(st.silent/st.n));
+    }
+    printf("(all times in ms, averaged; mech_gap: auto-stop -> playback in other direction, silent: tape end -> mute off)\n\n");
+    mech_sc=&scenarios[0];
+    printf("CRP42602Y PLAY latency after idle capstan shutdown\n");
+    printf("%-14s %9s\n", "STOP tacho", "latency");
+    for(idx=0;idx<(sizeof(stop_tacho_periods)/sizeof(stop_tacho_periods[0]));idx++)
+    {
+        stop_tacho_ms=stop_tacho_periods[idx];
+        ttr_features=TTR_FEA_REV_ENABLE|((stop_tacho_ms!=0)?TTR_FEA_STOP_TACHO:0);
+        latency=run_startup(0);
+        if(latency==0)
+        {
+            printf("ERROR: playback was not reached!\n");
+            return 2;
+        }
+        if(stop_tacho_ms==0)
+        {
+            printf("%-14s %9u\n", "none", (unsigned)latency);
+        }
+        else
+        {
+            printf("%11u ms %9u\n", (unsigned)stop_tacho_ms, (unsigned)latency);
+        }
+    }
+    printf("(all times in ms, capstan reaches nominal speed after %u ms)\n\n", (unsigned)SIM_SPIN_MS);
+    printf("CRP42602Y PLAY latency with capstan pre-spin on cassette insertion\n");
+    printf("%-14s %9s\n", "insert->PLAY", "latency");
+    stop_tacho_ms=0;
+    ttr_features=TTR_FEA_REV_ENABLE;
+    for(idx=0;idx<(sizeof(insert_to_play_ms)/sizeof(insert_to_play_ms[0]));idx++)
+    {
+        latency=run_startup(insert_to_play_ms[idx]);
+        if(latency==0)
+        {
+            printf("ERROR: playback was not reached!\n");
+            return 2;
+        }
+        printf("%11u ms %9u\n", (unsigned)insert_to_play_ms[idx], (unsigned)latency);
+    }
+    printf("(all times in ms)\n\n");
+    printf("CRP42602Y selection windows, STOP sensor re-anchoring: %s, %u transitions per case\n", STOP_ANCHOR_STATE, (unsigned)SIM_WINDOW_RUNS);
+    printf("%-9s %9s %9s\n", "lag, ms", "turn, %", "missed");
+    for(idx=0;idx<(sizeof(gear_cases)/sizeof(gear_cases[0]));idx++)
+    {
+        gear=&gear_cases[idx];
+        latency=run_windows(SIM_WINDOW_RUNS);
+        if(latency==0xFFFF)
+        {
+            printf("ERROR: transport got stuck!\n");
+            return 2;
+        }
+        printf("%9u %9u %9u\n", (unsigned)gear->lag_ms, (unsigned)gear->speed_pct, (unsigned)latency);
+    }
+    printf("(missed: transitions where the cam sampled solenoid in wrong state for the target mode)\n\n");
+    memcpy(defaults, mech_crp42602y_get_profile(), sizeof(defaults));
+    printf("CRP42602Y selection windows with calibrated profile, %u transitions per case\n", (unsigned)SIM_WINDOW_RUNS);
+    printf("%-14s %9s %9s %9s %9s %9s\n", "scenario", "leave", "home", "lag, ms", "turn, %", "missed");
+    for(sc_idx=0;sc_idx<(sizeof(scenarios)/sizeof(scenarios[0]));sc_idx++)
+    {
+        // Calibrate on mechanism with nominal gear, as user would do it.
+        mech_sc=&scenarios[sc_idx];
+        gear=&gear_cases[0];
+        res=run_calib(&leave, &home);
+        if(res!=0)
+        {
+            printf("ERROR: calibration on \"%s\" %s!\n", scenarios[sc_idx].name, (res==1)?"profile was rejected":"failed");
+            return 2;
+        }
+        for(idx=0;idx<(sizeof(gear_cases)/sizeof(gear_cases[0]));idx++)
+        {
+            gear=&gear_cases[idx];
+            latency=run_windows(SIM_WINDOW_RUNS);
+            if(latency==0xFFFF)
+            {
+                printf("ERROR: transport got stuck!\n");
+                return 2;
+            }
+            printf("%-14s %9u %9u %9u %9u %9u\n", scenarios[sc_idx].name, (unsigned)leave, (unsigned)home,
+                   (unsigned)gear->lag_ms, (unsigned)gear->speed_pct, (unsigned)latency);
+        }
+        mech_crp42602y_set_profile(defaults);
+    }
+    printf("(leave/home: calibrated times to STOP sensor release/activation in ms)\n");
+    return 0;
+}
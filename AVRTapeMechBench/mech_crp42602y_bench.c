@@ -0,0 +1,3 @@
+// CRP42602Y driver built with bench feature switches (see [bench_config.h]).
+#include "bench_config.h"
+#include "mech_crp42602y.c"
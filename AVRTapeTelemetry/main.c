@@ -0,0 +1,297 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Binary telemetry frame (NOTE: keep in sync with defines in [common_log.h]).
+#define TLM_SYNC_1		0xA5		// First sync byte (never appears in text log)
+#define TLM_SYNC_2		0x5A		// Second sync byte
+enum
+{
+    TLM_IDX_SYNC_1,			// [TLM_SYNC_1]
+    TLM_IDX_SYNC_2,			// [TLM_SYNC_2]
+    TLM_IDX_TICK_L,			// System tick counter (1 ms), low byte
+    TLM_IDX_TICK_H,			// System tick counter (1 ms), high byte
+    TLM_IDX_SWS,			// Transport sensors [sw_state]
+    TLM_IDX_KBD,			// User buttons [kbd_state]
+    TLM_IDX_USR_MODE,		// User mode [u8_user_mode]
+    TLM_IDX_MECH_MODE,		// Current internal transport mode
+    TLM_IDX_MECH_TARGET,	// Target internal transport mode
+    TLM_IDX_TRANS_TMR,		// Transition timer
+    TLM_IDX_TACHO_TMR,		// Time from last tachometer signal [u8_tacho_timer]
+    TLM_IDX_OUTPUTS,		// Output states ([TLM_OUT_xxx] flags)
+    TLM_IDX_ERROR,			// Transport error [u8_transport_error]
+    TLM_IDX_CRC,			// CRC8 of the frame
+    TLM_FRAME_SIZE			// Frame length
+};
+
+// Flags for [TLM_IDX_OUTPUTS] (NOTE: keep in sync with defines in [common_log.h]).
+#define TLM_OUT_SOLENOID	(1<<0)	// Transport actuator energized
+#define TLM_OUT_CAPSTAN		(1<<1)	// Capstan motor enabled
+#define TLM_OUT_MUTE		(1<<2)	// Playback mute enabled
+#define TLM_OUT_REC			(1<<3)	// Record enabled
+
+// Flags for [sw_state] (NOTE: keep in sync with defines in [common_log.h]).
+#define TTR_SW_TAPE_IN		(1<<0)	// Tape is present
+#define TTR_SW_STOP			(1<<1)	// Tape transport in mechanical "STOP" mode
+#define TTR_SW_TACHO		(1<<2)	// Tape pickup tachometer
+#define TTR_SW_NOREC_FWD	(1<<3)	// Rec inhibit in forward direction
+#define TTR_SW_NOREC_REV	(1<<4)	// Rec inhibit in reverse direction
+
+// NOTE: keep in sync with array in [calc_crc.c].
+static const uint8_t lut_crc8[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+    0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+    0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11,
+    0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52,
+    0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+    0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9,
+    0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C,
+    0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED,
+    0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE,
+    0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28,
+    0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0,
+    0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+    0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56,
+    0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15,
+    0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
+};
+
+volatile const uint8_t ucaf_compile_time[] = __TIME__;		// Time of compilation
+volatile const uint8_t ucaf_compile_date[] = __DATE__;		// Date of compilation
+volatile const uint8_t ucaf_info[] = "ATmega tape controller telemetry to CSV converter";	// Software description
+volatile const uint8_t ucaf_author[] = "Maksim Kryukov aka Fagear";					// Author
+volatile const uint8_t ucaf_url[] = "https://github.com/Fagear/AVRTapeControl";		// URL
+
+static volatile sig_atomic_t stop_req = 0;
+
+uint8_t CRC8_init(void)
+{
+    return 0xFF;
+}
+
+uint8_t CRC8_calc(uint8_t CRC_data, uint8_t in_data)
+{
+    uint8_t offset;
+    offset=CRC_data^in_data;
+    return lut_crc8[offset];
+}
+
+void stop_handler(int sig)
+{
+    (void)sig;
+    stop_req = 1;
+}
+
+int setup_serial(int fd)
+{
+    struct termios tty;
+    if(tcgetattr(fd, &tty) != 0)
+    {
+        return -1;
+    }
+    // Raw 8-N-1 at UART speed of the firmware (NOTE: keep in sync with [UART_SPEED] in [config.h]).
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, B500000);
+    cfsetospeed(&tty, B500000);
+    tty.c_cflag |= (CLOCAL|CREAD);
+    tty.c_cflag &= ~(CSTOPB|CRTSCTS);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tty);
+}
+
+uint8_t check_frame(const uint8_t *frame)
+{
+    uint8_t crc_data, idx;
+    if((frame[TLM_IDX_SYNC_1] != TLM_SYNC_1) || (frame[TLM_IDX_SYNC_2] != TLM_SYNC_2))
+    {
+        return 0;
+    }
+    crc_data = CRC8_init();
+    for(idx = TLM_IDX_TICK_L; idx < TLM_IDX_CRC; idx++)
+    {
+        crc_data = CRC8_calc(crc_data, frame[idx]);
+    }
+    return (crc_data == frame[TLM_IDX_CRC]);
+}
+
+void print_header(FILE *out)
+{
+    fprintf(out, "time_ms,tick,tape_in,stop_sw,tacho_sw,norec_fwd,norec_rev,kbd,user_mode,mech_mode,mech_target,trans_timer,tacho_timer,solenoid,capstan,mute,rec,error\n");
+}
+
+void print_frame(FILE *out, uint64_t time_ms, const uint8_t *frame)
+{
+    uint16_t tick;
+    uint8_t sws, outs;
+    tick = (uint16_t)(frame[TLM_IDX_TICK_L] | (frame[TLM_IDX_TICK_H] << 8));
+    sws = frame[TLM_IDX_SWS];
+    outs = frame[TLM_IDX_OUTPUTS];
+    fprintf(out, "%llu,%u,%u,%u,%u,%u,%u,0x%02x,%u,%u,%u,%u,%u,%u,%u,%u,%u,0x%02x\n",
+            (unsigned long long)time_ms, tick,
+            ((sws & TTR_SW_TAPE_IN) != 0), ((sws & TTR_SW_STOP) != 0), ((sws & TTR_SW_TACHO) != 0),
+            ((sws & TTR_SW_NOREC_FWD) != 0), ((sws & TTR_SW_NOREC_REV) != 0),
+            frame[TLM_IDX_KBD], frame[TLM_IDX_USR_MODE], frame[TLM_IDX_MECH_MODE], frame[TLM_IDX_MECH_TARGET],
+            frame[TLM_IDX_TRANS_TMR], frame[TLM_IDX_TACHO_TMR],
+            ((outs & TLM_OUT_SOLENOID) != 0), ((outs & TLM_OUT_CAPSTAN) != 0),
+            ((outs & TLM_OUT_MUTE) != 0), ((outs & TLM_OUT_REC) != 0),
+            frame[TLM_IDX_ERROR]);
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t frame[TLM_FRAME_SIZE];
+    uint8_t in_buf[256];
+    uint8_t fill, idx;
+    uint16_t tick, last_tick;
+    uint64_t time_ms;
+    uint32_t frames_ok, frames_bad, text_bytes;
+    ssize_t in_len;
+    int in_fd;
+    FILE *csv_out;
+
+    fprintf(stderr, "%s\n\r", ucaf_info);
+    fprintf(stderr, "%s\n\r", ucaf_author);
+    fprintf(stderr, "%s, %s\n\r", ucaf_compile_date, ucaf_compile_time);
+    fprintf(stderr, "%s\n\r", ucaf_url);
+
+    if(argc < 2)
+    {
+        fprintf(stderr, "\n\rUsage: %s <serial device|dump file> [output.csv]\n\r", argv[0]);
+        fprintf(stderr, "Text log bytes between frames are passed through to stderr.\n\r");
+        return -1;
+    }
+
+    in_fd = open(argv[1], O_RDONLY|O_NOCTTY);
+    if(in_fd < 0)
+    {
+        fprintf(stderr, "\n\rFailed to open %s: %s\n\r", argv[1], strerror(errno));
+        return -2;
+    }
+    if(isatty(in_fd) != 0)
+    {
+        if(setup_serial(in_fd) != 0)
+        {
+            fprintf(stderr, "\n\rFailed to configure serial port %s: %s\n\r", argv[1], strerror(errno));
+            close(in_fd);
+            return -2;
+        }
+    }
+
+    csv_out = stdout;
+    if(argc > 2)
+    {
+        csv_out = fopen(argv[2], "w");
+        if(csv_out == NULL)
+        {
+            fprintf(stderr, "\n\rFailed to create %s: %s\n\r", argv[2], strerror(errno));
+            close(in_fd);
+            return -3;
+        }
+    }
+
+    signal(SIGINT, stop_handler);
+    signal(SIGTERM, stop_handler);
+
+    print_header(csv_out);
+    fill = 0;
+    last_tick = 0;
+    time_ms = 0;
+    frames_ok = frames_bad = text_bytes = 0;
+    while(stop_req == 0)
+    {
+        in_len = read(in_fd, in_buf, sizeof(in_buf));
+        if(in_len <= 0)
+        {
+            if((in_len < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+            break;
+        }
+        for(ssize_t in_idx = 0; in_idx < in_len; in_idx++)
+        {
+            // Look for the first sync byte, everything else is text log.
+            if((fill == 0) && (in_buf[in_idx] != TLM_SYNC_1))
+            {
+                fputc(in_buf[in_idx], stderr);
+                text_bytes++;
+                continue;
+            }
+            frame[fill++] = in_buf[in_idx];
+            if((fill == (TLM_IDX_SYNC_2 + 1)) && (frame[TLM_IDX_SYNC_2] != TLM_SYNC_2))
+            {
+                // False sync, restart with current byte.
+                frames_bad++;
+                fill = 0;
+                if(frame[TLM_IDX_SYNC_2] == TLM_SYNC_1)
+                {
+                    frame[fill++] = TLM_SYNC_1;
+                }
+                continue;
+            }
+            if(fill < TLM_FRAME_SIZE)
+            {
+                continue;
+            }
+            if(check_frame(frame) != 0)
+            {
+                // Unwrap 16-bit millisecond tick counter.
+                tick = (uint16_t)(frame[TLM_IDX_TICK_L] | (frame[TLM_IDX_TICK_H] << 8));
+                if(frames_ok != 0)
+                {
+                    time_ms += (uint16_t)(tick - last_tick);
+                }
+                last_tick = tick;
+                frames_ok++;
+                print_frame(csv_out, time_ms, frame);
+                fill = 0;
+            }
+            else
+            {
+                // Broken frame, resync from the next sync byte inside it.
+                frames_bad++;
+                for(idx = 1; idx < TLM_FRAME_SIZE; idx++)
+                {
+                    if(frame[idx] == TLM_SYNC_1)
+                    {
+                        break;
+                    }
+                }
+                fill = TLM_FRAME_SIZE - idx;
+                memmove(frame, frame + idx, fill);
+            }
+        }
+    }
+
+    if(csv_out != stdout)
+    {
+        fclose(csv_out);
+    }
+    close(in_fd);
+    fprintf(stderr, "\n\rFrames: %u good, %u bad, %u text bytes\n\r", frames_ok, frames_bad, text_bytes);
+    return 0;
+}